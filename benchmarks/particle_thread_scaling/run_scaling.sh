@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Run the particle thread scaling benchmark for 1, 2, 4, ... threads up
+# to the given maximum and print the wallclock time of the particle
+# advection and the particle property update for each thread count.
+#
+# usage: ./run_scaling.sh /path/to/aspect [maximum number of threads]
+
+ASPECT=${1:?"usage: $0 /path/to/aspect [maximum number of threads]"}
+MAX_THREADS=${2:-$(nproc)}
+
+echo "# threads  advect[s]  update[s]"
+
+threads=1
+while [ ${threads} -le ${MAX_THREADS} ]; do
+  output=$(DEAL_II_NUM_THREADS=${threads} ${ASPECT} -j particle_thread_scaling.prm)
+
+  # The timing table is printed after every time step; use the last one.
+  advect=$(echo "${output}" | grep "| Particles: Advect " | tail -n 1 | awk -F'|' '{print $4}')
+  update=$(echo "${output}" | grep "| Particles: Update properties " | tail -n 1 | awk -F'|' '{print $4}')
+
+  echo "${threads} ${advect} ${update}"
+  threads=$((threads * 2))
+done
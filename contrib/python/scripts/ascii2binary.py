@@ -0,0 +1,116 @@
+'''
+This function creates binary data files from an input ascii file
+formatted following the ASPECT convention for structured ascii data files.
+Binary data files can be read by ASPECT much faster than ascii files,
+which is useful for large data tables. ASPECT recognizes binary data
+files by the file ending '.bin'.
+
+The binary format is described in the documentation of
+StructuredDataLookup::load_binary().
+
+'''
+
+import numpy as np
+import struct
+import sys
+
+def main():
+
+    msg = "Usage            : ascii2binary.py input_ascii_filename [output_binary_filename]\n \n" + \
+          "Optional arguments: \n" + \
+          "output_binary_filename: the name of the generated file. Defaults to the input " + \
+                                   "file name with the ending replaced by '.bin'.\n"
+
+    if (len(sys.argv) < 2):
+        raise Exception("Not enough arguments. Please provide the name of the input ascii file for conversion.")
+
+    if (sys.argv[1] == '-h'):
+        print(msg)
+        sys.exit(0)
+
+    file_name = sys.argv[1]
+    ofilename = sys.argv[2] if len(sys.argv) > 2 else file_name.rsplit('.', 1)[0] + '.bin'
+
+    convert(file_name, ofilename)
+
+
+def read_ascii(ifile):
+
+    points       = None
+    column_names = None
+
+    with open(ifile) as f:
+        lines = f.readlines()
+
+    # Read the header: comment lines, one of which contains the number
+    # of points, optionally followed by a line with the column names.
+    first_data_line = 0
+    for line in lines:
+        if not line.startswith('#'):
+            break
+        words = line[1:].split()
+        if 'POINTS:' in words:
+            index  = words.index('POINTS:')
+            points = [int(n) for n in words[index+1:] if n.isdigit()]
+        first_data_line += 1
+
+    if points is None:
+        raise Exception("Could not find the '# POINTS: N1 [N2] [N3]' header line in " + ifile + ".")
+
+    try:
+        [float(word) for word in lines[first_data_line].split()]
+    except ValueError:
+        column_names = lines[first_data_line].split()
+        first_data_line += 1
+
+    ascii_data = np.loadtxt(lines[first_data_line:], ndmin=2)
+    dim        = len(points)
+
+    if ascii_data.shape[0] != np.prod(points):
+        raise Exception("The number of data lines in " + ifile + " does not match the POINTS header.")
+
+    n_components = ascii_data.shape[1] - dim
+    if column_names is None:
+        column_names = ['column %02d' % c for c in range(n_components)]
+    else:
+        # Like ASPECT, ignore the names of the coordinate columns and
+        # use lower case names for the data columns.
+        column_names = [name.lower() for name in column_names[dim:]]
+
+    # The first coordinate ascends first, so the coordinate values in
+    # direction d repeat with a stride of the product of the number of
+    # points in all previous directions.
+    coordinates = []
+    stride = 1
+    for d in range(dim):
+        coordinates.append(ascii_data[0:stride*points[d]:stride, d])
+        stride *= points[d]
+
+    return points, column_names, coordinates, ascii_data[:, dim:]
+
+
+def convert(ifile, ofile):
+
+    points, column_names, coordinates, field_data = read_ascii(ifile)
+
+    with open(ofile, 'wb') as f:
+        f.write(b'ASPECTSD')
+        f.write(struct.pack('=III', 1, len(points), field_data.shape[1]))
+        f.write(struct.pack('=' + 'I' * len(points), *points))
+        for name in column_names:
+            encoded_name = name.encode('ascii')
+            f.write(struct.pack('=I', len(encoded_name)))
+            f.write(encoded_name)
+
+        # pad the header so that the following numbers are aligned
+        f.write(b'\0' * (-f.tell() % 8))
+
+        for coordinate in coordinates:
+            f.write(np.ascontiguousarray(coordinate, dtype=np.float64).tobytes())
+
+        # store each component contiguously, in the order of the ascii file
+        f.write(np.asfortranarray(field_data, dtype=np.float64).tobytes(order='F'))
+
+
+if __name__ == "__main__":
+    main()
@@ -168,10 +168,38 @@ namespace aspect
          * Whether to use the surface_conditions_function to determine surface
          * conditions, or the adiabatic_surface_temperature and surface_pressure
          * parameters. If this is set to true the reference profile is updated
-         * every timestep.
+         * every timestep in which the surface conditions change.
          */
         bool use_surface_condition_function;
 
+        /**
+         * The surface pressure and temperature the current profile was
+         * computed for.
+         */
+        double surface_pressure;
+        double surface_temperature;
+
+        /**
+         * An enum describing the methods available to integrate the
+         * profile downward from the surface.
+         */
+        enum IntegrationMethod
+        {
+          explicit_euler,
+          runge_kutta
+        };
+
+        /**
+         * Selected method to integrate the profile.
+         */
+        IntegrationMethod integration_method;
+
+        /**
+         * Whether to compute the profile only on the root process and
+         * broadcast it to all other processes.
+         */
+        bool compute_on_root_process_only;
+
         /**
          * ParsedFunction: If provided in the input file it prescribes
          * (surface pressure(t), surface temperature(t)).
@@ -192,6 +220,28 @@ namespace aspect
          */
         double get_property (const Point<dim> &p,
                              const std::vector<double> &property) const;
+
+        /**
+         * Internal helper function. Returns the reference composition at
+         * each of the given points, computed all at once.
+         */
+        std::vector<std::vector<double>>
+        compute_reference_compositions (const std::vector<Point<dim>> &points) const;
+
+        /**
+         * Integrate the profile with the explicit Euler method and store
+         * the result in the member variables above. @p gravity_direction is
+         * 1 if gravity points downward, and -1 otherwise.
+         */
+        void compute_profile_euler (const int gravity_direction);
+
+        /**
+         * Integrate the profile with the classical fourth order Runge-Kutta
+         * method and store the result in the member variables above.
+         * @p gravity_direction is 1 if gravity points downward, and -1
+         * otherwise.
+         */
+        void compute_profile_runge_kutta (const int gravity_direction);
     };
   }
 }
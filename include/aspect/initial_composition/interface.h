@@ -61,6 +61,21 @@ namespace aspect
          */
         virtual
         double initial_composition (const Point<dim> &position, const unsigned int n_comp) const = 0;
+
+        /**
+         * Return the initial composition of all compositional fields at
+         * all of the given positions. @p values has one entry per position,
+         * each of which has to be sized to the number of compositional
+         * fields before calling this function.
+         *
+         * The default implementation calls the function above for every
+         * position and every compositional field. Plugins for which it is
+         * cheaper to evaluate all fields, or all positions, at once can
+         * overload this function.
+         */
+        virtual
+        void initial_compositions (const std::vector<Point<dim>> &positions,
+                                   std::vector<std::vector<double>> &values) const;
     };
 
 
@@ -100,6 +115,18 @@ namespace aspect
         initial_composition (const Point<dim> &position,
                              const unsigned int n_comp) const;
 
+        /**
+         * A function that calls the initial_compositions functions of all
+         * individual initial composition objects for all compositional
+         * fields at all of the given positions, and combines the values of
+         * the individual calls in the same way as the function above.
+         * @p values has one entry per position, each of which has to be
+         * sized to the number of compositional fields.
+         */
+        void
+        initial_compositions (const std::vector<Point<dim>> &positions,
+                              std::vector<std::vector<double>> &values) const;
+
         /**
          * A function that is used to register initial composition objects in
          * such a way that the Manager can deal with all of them without having
@@ -66,6 +66,16 @@ namespace aspect
          */
         double initial_composition (const Point<dim> &position, const unsigned int n_comp) const override;
 
+        /**
+         * Return the initial composition of all compositional fields at
+         * all of the given positions. This function queries the World
+         * Builder only once per position for all relevant compositional
+         * fields together, and evaluates the positions in parallel
+         * using multiple threads.
+         */
+        void initial_compositions (const std::vector<Point<dim>> &positions,
+                                   std::vector<std::vector<double>> &values) const override;
+
         /**
          * Declare the parameters this class takes through input files. The
          * default implementation of this function does not describe any
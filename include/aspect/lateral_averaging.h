@@ -26,6 +26,9 @@
 
 #include <deal.II/fe/fe_values.h>
 
+#include <map>
+#include <set>
+
 namespace aspect
 {
   using namespace dealii;
@@ -104,12 +107,44 @@ namespace aspect
    * function get_lateral_averaging(), and then query that for the desired
    * averaged quantity.
    *
+   * Averages of named properties are stored after they have been computed
+   * and are returned without another pass over the mesh as long as the
+   * solution, the time, and the time step number have not changed. Plugins
+   * that know in advance which averages they will need can announce them
+   * with register_lateral_averages(), so that all registered properties in
+   * the same depth slices are computed together in the first pass over the
+   * mesh that any plugin triggers.
+   *
    * @ingroup Simulator
    */
   template <int dim>
   class LateralAveraging : public SimulatorAccess<dim>
   {
     public:
+      /**
+       * Announce that a plugin will ask for lateral averages of the
+       * properties @p property_names in @p n_slices equidistant depth
+       * slices. Whenever averages in the same depth slices need to be
+       * computed, the registered properties are computed in the same
+       * pass over the mesh and stored for later requests. Registered
+       * properties that require an evaluation of the material model are
+       * only added to passes that evaluate the material model anyway.
+       *
+       * This function is typically called from the initialize() function
+       * of a plugin. It does not compute anything.
+       */
+      void
+      register_lateral_averages(const unsigned int n_slices,
+                                const std::vector<std::string> &property_names) const;
+
+      /**
+       * Same as the function above, but for depth slices given by
+       * @p depth_bounds as described in compute_lateral_averages().
+       */
+      void
+      register_lateral_averages(const std::vector<double> &depth_bounds,
+                                const std::vector<std::string> &property_names) const;
+
       /**
        * @deprecated: This function is deprecated and only maintained for backward compatibility.
        * Use the function compute_lateral_averages() with the same arguments instead.
@@ -319,6 +354,59 @@ namespace aspect
        */
       void
       get_vertical_mass_flux_averages(std::vector<double> &values) const;
+
+    private:
+      /**
+       * Return the boundaries of @p n_slices equidistant depth slices
+       * between the surface and the maximal depth of the model.
+       */
+      std::vector<double>
+      compute_equidistant_depth_bounds(const unsigned int n_slices) const;
+
+      /**
+       * Create the functor that computes the property with the name
+       * @p property_name. Throw an exception if the name is not known.
+       */
+      std::unique_ptr<internal::FunctorBase<dim>>
+      create_functor(const std::string &property_name) const;
+
+      /**
+       * Return the names of all properties that plugins have registered
+       * for the depth slices given by @p depth_bounds.
+       */
+      std::set<std::string>
+      get_registered_properties(const std::vector<double> &depth_bounds) const;
+
+      /**
+       * Delete all stored averages if the solution, the time, or the
+       * time step number have changed since they were computed. This
+       * function needs to be called on all processes.
+       */
+      void
+      invalidate_outdated_averages() const;
+
+      /**
+       * The properties registered by plugins, both for equidistant depth
+       * slices (sorted by the number of slices) and for given depth
+       * boundaries.
+       */
+      mutable std::map<unsigned int, std::set<std::string>> registered_properties_by_n_slices;
+      mutable std::map<std::vector<double>, std::set<std::string>> registered_properties_by_depth_bounds;
+
+      /**
+       * The averages that have been computed for the current solution,
+       * sorted by depth boundaries and property name.
+       */
+      mutable std::map<std::vector<double>, std::map<std::string, std::vector<double>>> cached_averages;
+
+      /**
+       * A hash of the locally owned part of the solution, as well as the
+       * time and time step number for which the averages in
+       * cached_averages have been computed.
+       */
+      mutable std::size_t cached_solution_hash = 0;
+      mutable double cached_time = std::numeric_limits<double>::quiet_NaN();
+      mutable unsigned int cached_timestep_number = numbers::invalid_unsigned_int;
   };
 }
 
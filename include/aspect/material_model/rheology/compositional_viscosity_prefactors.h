@@ -78,6 +78,17 @@ namespace aspect
                              const unsigned int q,
                              const ModifiedFlowLaws &modified_flow_laws) const;
 
+          /**
+           * Compute the derivative of the logarithm of the prefactor that
+           * compute_viscosity() multiplies the base viscosity with, with respect
+           * to the pressure.
+           */
+          double
+          compute_logarithmic_pressure_derivative (const MaterialModel::MaterialModelInputs<dim> &in,
+                                                   const unsigned int composition_index,
+                                                   const unsigned int q,
+                                                   const ModifiedFlowLaws &modified_flow_laws) const;
+
         private:
           /**
            * The viscosity prefactors or terms used to calculate the viscosity
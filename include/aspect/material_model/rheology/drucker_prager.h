@@ -138,6 +138,30 @@ namespace aspect
           compute_derivative (const double angle_internal_friction,
                               const double effective_strain_rate) const;
 
+          /**
+           * Compute the derivative of the plastic yield stress computed by
+           * compute_yield_stress() with respect to the pressure. The derivative
+           * is zero if the yield stress is limited by @p max_yield_stress.
+           */
+          double
+          compute_yield_stress_derivative (const double cohesion,
+                                           const double angle_internal_friction,
+                                           const double pressure,
+                                           const double max_yield_stress) const;
+
+          /**
+           * Compute the derivatives of the apparent viscosity computed by
+           * compute_viscosity() with respect to the pressure, the effective
+           * strain rate, and the non-yielding viscosity (in this order).
+           */
+          std::array<double, 3>
+          compute_viscosity_derivatives (const double cohesion,
+                                         const double angle_internal_friction,
+                                         const double pressure,
+                                         const double effective_strain_rate,
+                                         const double max_yield_stress,
+                                         const double non_yielding_viscosity = std::numeric_limits<double>::infinity()) const;
+
         private:
 
           /**
@@ -122,6 +122,9 @@ namespace aspect
            * unsigned integers this is considered the number of phase transitions
            * for each compositional field and viscosity will be first computed on
            * each phase and then averaged for each compositional field.
+           * If @p stress_cutoff_applied is not a nullptr, it is set to
+           * whether the strict stress cutoff determined the viscosity, in
+           * which case the viscosity is 0.5 * stress_cutoff / strain_rate.
            */
           double
           compute_exact_viscosity (const double strain_rate,
@@ -129,7 +132,8 @@ namespace aspect
                                    const double temperature,
                                    const unsigned int composition,
                                    const std::vector<double> &phase_function_values = std::vector<double>(),
-                                   const std::vector<unsigned int> &n_phase_transitions_per_composition = std::vector<unsigned int>()) const;
+                                   const std::vector<unsigned int> &n_phase_transitions_per_composition = std::vector<unsigned int>(),
+                                   bool *stress_cutoff_applied = nullptr) const;
 
           /**
            * Compute the viscosity based on the selected Peierls creep flow law.
@@ -139,6 +143,9 @@ namespace aspect
            * unsigned integers this is considered the number of phase transitions
            * for each compositional field and viscosity will be first computed on
            * each phase and then averaged for each compositional field.
+           * If @p stress_cutoff_applied is not a nullptr, it is set to
+           * whether the strict stress cutoff of the exact flow law
+           * determined the viscosity.
            */
           double
           compute_viscosity (const double strain_rate,
@@ -146,7 +153,8 @@ namespace aspect
                              const double temperature,
                              const unsigned int composition,
                              const std::vector<double> &phase_function_values = std::vector<double>(),
-                             const std::vector<unsigned int> &n_phase_transitions_per_composition = std::vector<unsigned int>()) const;
+                             const std::vector<unsigned int> &n_phase_transitions_per_composition = std::vector<unsigned int>(),
+                             bool *stress_cutoff_applied = nullptr) const;
 
           /**
            * Compute the strain rate and first stress derivative
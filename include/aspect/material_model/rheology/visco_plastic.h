@@ -108,6 +108,16 @@ namespace aspect
        * The current cohesion.
        */
       std::vector<double> current_cohesions;
+
+      /**
+       * The derivatives of the composition viscosities with respect to the
+       * square root of the second moment invariant of the deviatoric strain
+       * rate tensor and with respect to the pressure. These are only filled
+       * if they were requested and can be computed analytically, and are
+       * empty otherwise.
+       */
+      std::vector<double> composition_dviscosities_dstrain_rate_invariant;
+      std::vector<double> composition_dviscosities_dpressure;
     };
 
     namespace Rheology
@@ -129,6 +139,10 @@ namespace aspect
            * unsigned integers this is considered the number of phase transitions
            * for each compositional field and viscosity will be first computed on
            * each phase and then averaged for each compositional field.
+           * If @p compute_derivatives is true and analytic_viscosity_derivatives_available()
+           * returns true, the derivatives of the composition viscosities with respect
+           * to the strain rate invariant and the pressure are computed alongside
+           * the viscosities.
            */
           IsostrainViscosities
           calculate_isostrain_viscosities ( const MaterialModel::MaterialModelInputs<dim> &in,
@@ -136,12 +150,16 @@ namespace aspect
                                             const std::vector<double> &volume_fractions,
                                             const std::vector<double> &phase_function_values = std::vector<double>(),
                                             const std::vector<unsigned int> &n_phase_transitions_per_composition =
-                                              std::vector<unsigned int>()) const;
+                                              std::vector<unsigned int>(),
+                                            const bool compute_derivatives = false) const;
 
           /**
            * A function that fills the viscosity derivatives in the
            * MaterialModelOutputs object that is handed over, if they exist.
            * Does nothing otherwise.
+           * If @p isostrain_viscosities contains the derivatives of the
+           * composition viscosities, these are used directly. Otherwise, the
+           * derivatives are approximated by finite differences.
            * If @p n_phase_transitions_per_composition points to a vector of
            * unsigned integers this is considered the number of phase transitions
            * for each compositional field and viscosity will be first computed on
@@ -149,7 +167,7 @@ namespace aspect
            */
           void compute_viscosity_derivatives(const unsigned int point_index,
                                              const std::vector<double> &volume_fractions,
-                                             const std::vector<double> &composition_viscosities,
+                                             const IsostrainViscosities &isostrain_viscosities,
                                              const MaterialModel::MaterialModelInputs<dim> &in,
                                              MaterialModel::MaterialModelOutputs<dim> &out,
                                              const std::vector<double> &phase_function_values = std::vector<double>(),
@@ -164,6 +182,16 @@ namespace aspect
            */
           ComponentMask get_volumetric_composition_mask() const;
 
+          /**
+           * Return whether the derivatives of the viscosity with respect to
+           * the strain rate and pressure can be computed analytically for the
+           * current choice of parameters. This is the case unless elasticity,
+           * the Frank-Kamenetskii flow law, dynamic friction, or temperature
+           * activated strain softening with an adiabatic temperature gradient
+           * for the viscosity are used.
+           */
+          bool analytic_viscosity_derivatives_available() const;
+
           /**
            * Declare the parameters this function takes through input files.
            */
@@ -229,6 +257,21 @@ namespace aspect
 
         private:
 
+          /**
+           * Approximate the derivatives of the composition viscosities with
+           * respect to the strain rate and the pressure by finite differences,
+           * re-evaluating the rheology for a perturbation of each independent
+           * strain rate component and the pressure.
+           */
+          void compute_finite_difference_viscosity_derivatives(const unsigned int point_index,
+                                                               const std::vector<double> &volume_fractions,
+                                                               const std::vector<double> &composition_viscosities,
+                                                               const MaterialModel::MaterialModelInputs<dim> &in,
+                                                               const std::vector<double> &phase_function_values,
+                                                               const std::vector<unsigned int> &n_phase_transitions_per_composition,
+                                                               std::vector<SymmetricTensor<2,dim>> &composition_viscosities_derivatives,
+                                                               std::vector<double> &composition_dviscosities_dpressure) const;
+
           /**
            * Reference strain rate for the first non-linear iteration
            * in the first time step.
@@ -55,6 +55,62 @@ namespace aspect
     {
       namespace Lookup
       {
+        /**
+         * A namespace for the properties that can be requested from a
+         * MaterialLookup object in a single call to MaterialLookup::evaluate().
+         */
+        namespace LookupProperties
+        {
+          /**
+           * An enum of the properties that can be looked up. The values
+           * can be combined with the | operator.
+           */
+          enum Property : unsigned int
+          {
+            none                = 0,
+            density             = 1,
+            thermal_expansivity = 2,
+            specific_heat       = 4,
+            seismic_Vp          = 8,
+            seismic_Vs          = 16,
+            enthalpy            = 32,
+            dRhodp              = 64,
+            dHdT                = 128,
+            dHdp                = 256
+          };
+
+          inline
+          Property
+          operator | (const Property a,
+                      const Property b)
+          {
+            return static_cast<Property>(static_cast<unsigned int>(a) | static_cast<unsigned int>(b));
+          }
+        }
+
+        /**
+         * A structure of arrays that contains the properties computed by
+         * MaterialLookup::evaluate() at a number of temperature-pressure
+         * points. Only the vectors of the requested properties are filled.
+         */
+        struct LookupOutputs
+        {
+          /**
+           * Constructor. Sets the size of all vectors to @p n_points.
+           */
+          LookupOutputs (const unsigned int n_points = 0);
+
+          std::vector<double> densities;
+          std::vector<double> thermal_expansivities;
+          std::vector<double> specific_heats;
+          std::vector<double> seismic_Vp;
+          std::vector<double> seismic_Vs;
+          std::vector<double> enthalpies;
+          std::vector<double> dRhodp;
+          std::vector<double> dHdT;
+          std::vector<double> dHdp;
+        };
+
         /**
          * A base class that can be used to look up material data from an external
          * data source (e.g. a table in a file). The class consists of data members
@@ -176,7 +232,56 @@ namespace aspect
             const std::vector<std::string> &
             get_dominant_phase_names() const;
 
+            /**
+             * Compute all properties given by @p requested_properties at the
+             * temperatures and pressures given in @p temperatures and
+             * @p pressures, and store them in @p outputs. Each point is
+             * located in the data tables only once for all requested
+             * properties (and twice more for the finite difference
+             * derivatives), which is considerably cheaper than calling
+             * the functions above for every property separately. The
+             * results are identical to the ones of the separate functions.
+             */
+            void
+            evaluate (const std::vector<double> &temperatures,
+                      const std::vector<double> &pressures,
+                      const LookupProperties::Property requested_properties,
+                      LookupOutputs &outputs) const;
+
           protected:
+            /**
+             * The position of a temperature-pressure point in the data
+             * tables: The indices of the table entry with the next smaller
+             * temperature and pressure, and the local coordinates of the
+             * point between this entry and the next larger ones.
+             */
+            struct TablePosition
+            {
+              unsigned int inT;
+              unsigned int inp;
+              double xi;
+              double eta;
+            };
+
+            /**
+             * Find the position of the point with temperature @p temperature
+             * and pressure @p pressure in the data tables.
+             */
+            TablePosition
+            locate (const double temperature,
+                    const double pressure) const;
+
+            /**
+             * Access the data value of the property that is stored in table
+             * @p values at the position @p position, either by linear
+             * interpolation between the closest data points or by using the
+             * closest point value, depending on @p interpol.
+             */
+            double
+            value (const TablePosition &position,
+                   const Table<2, double> &values,
+                   const bool interpol) const;
+
             /**
              * Access that data value of the property that is stored in table
              * @p values at pressure @p pressure and temperature @p temperature.
@@ -37,20 +37,28 @@ namespace aspect
      * @ingroup MeshRefinement
      */
     template <int dim>
-    class Composition : public Interface<dim>,
-      public SimulatorAccess<dim>
+    class Composition : public KellyInterface<dim>
     {
       public:
         /**
-         * Execute this mesh refinement criterion.
-         *
-         * @param[out] error_indicators A vector that for every active cell of
-         * the current mesh (which may be a partition of a distributed mesh)
-         * provides an error indicator. This vector will already have the
-         * correct size when the function is called.
+         * Return the component mask of each compositional field, one per field.
+         */
+        std::vector<ComponentMask>
+        get_component_masks () const override;
+
+        /**
+         * Return the face quadrature formula of the compositional fields.
+         */
+        const Quadrature<dim-1> &
+        get_face_quadrature () const override;
+
+        /**
+         * Add up the indicators of the individual compositional fields,
+         * weighted by their scaling factors.
          */
         void
-        execute (Vector<float> &error_indicators) const override;
+        combine_indicators (const std::vector<Vector<float>> &indicators_per_mask,
+                            Vector<float> &error_indicators) const override;
 
         /**
          * Declare the parameters this class takes through input files.
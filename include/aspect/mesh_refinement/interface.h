@@ -25,6 +25,7 @@
 #include <aspect/global.h>
 #include <aspect/plugins.h>
 #include <aspect/simulator_access.h>
+#include <aspect/material_model/interface.h>
 
 #include <memory>
 #include <deal.II/base/table_handler.h>
@@ -104,6 +105,205 @@ namespace aspect
 
 
 
+    /**
+     * A base class for mesh refinement criteria that compute a scalar field
+     * at the support points of the temperature element of every cell,
+     * interpolate it into a finite element field, and use the magnitude of
+     * the approximate gradient of this field, scaled by a power of the cell
+     * diameter, as refinement indicator. Examples are the density, the
+     * (logarithm of the) viscosity, or the nonadiabatic temperature.
+     *
+     * Derived classes only describe the field through
+     * get_needed_material_properties() and compute_field_values(). If more
+     * than one of these criteria is active, the Manager class computes the
+     * fields of all of them in a single parallel loop over all cells, in
+     * which the material model is evaluated only once per cell for the
+     * union of all requested properties. See
+     * compute_field_gradient_indicators().
+     *
+     * @ingroup MeshRefinement
+     */
+    template <int dim>
+    class FieldGradientInterface : public Interface<dim>,
+      public SimulatorAccess<dim>
+    {
+      public:
+        /**
+         * Execute this mesh refinement criterion on its own.
+         *
+         * @param[out] error_indicators A vector that for every active cell of
+         * the current mesh (which may be a partition of a distributed mesh)
+         * provides an error indicator. This vector will already have the
+         * correct size when the function is called.
+         */
+        void
+        execute (Vector<float> &error_indicators) const override;
+
+        /**
+         * Return the material properties that compute_field_values() reads
+         * from the material model outputs. If the field does not depend on
+         * the material model, return
+         * MaterialModel::MaterialProperties::uninitialized, in which case
+         * the material model is not evaluated for this criterion.
+         */
+        virtual
+        MaterialModel::MaterialProperties::Property
+        get_needed_material_properties () const = 0;
+
+        /**
+         * Compute the values of the field at the support points of the
+         * temperature element of one cell. The material model inputs are
+         * always filled, whereas the outputs only contain valid values for
+         * the properties returned by get_needed_material_properties().
+         *
+         * @param[in] in The material model inputs at the support points.
+         * @param[in] out The material model outputs at the support points.
+         * @param[out] values The values of the field at the support points.
+         * This vector already has the correct size.
+         */
+        virtual
+        void
+        compute_field_values (const MaterialModel::MaterialModelInputs<dim> &in,
+                              const MaterialModel::MaterialModelOutputs<dim> &out,
+                              std::vector<double> &values) const = 0;
+
+        /**
+         * Return the power of the cell diameter by which the approximate
+         * gradient of the field is multiplied in each cell. Any power
+         * larger than one ensures that the refinement indicators converge
+         * to zero even if the field is discontinuous. The default
+         * implementation returns $1+d/2$.
+         */
+        virtual
+        double
+        get_cell_diameter_power () const;
+    };
+
+
+
+    /**
+     * Compute the refinement indicators of all of the given @p criteria
+     * in one pass. This function loops over all locally owned cells in
+     * parallel, evaluates the material model once per cell for the union
+     * of the properties the criteria need, and then lets every criterion
+     * compute its field from the same material model inputs and outputs.
+     * Afterwards, the gradient of each field is approximated and scaled as
+     * described in the documentation of the FieldGradientInterface class.
+     *
+     * @param[in] simulator_access An object that provides access to the
+     * solution and the material model.
+     * @param[in] criteria The criteria whose indicators should be computed.
+     * @param[out] error_indicators One vector of error indicators per
+     * criterion. The vectors already need to have the correct size.
+     */
+    template <int dim>
+    void
+    compute_field_gradient_indicators (const SimulatorAccess<dim> &simulator_access,
+                                       const std::vector<const FieldGradientInterface<dim> *> &criteria,
+                                       const std::vector<Vector<float> *> &error_indicators);
+
+
+
+
+    /**
+     * A base class for mesh refinement criteria that are based on the
+     * error estimator by Kelly, Gago, Zienkiewicz and Babuska, i.e., on the
+     * jump of the normal derivative of some solution components across the
+     * faces of each cell. The indicator of a cell $K$ for a set of
+     * components is
+     * $\eta_K^2 = \frac{h_K}{24} \sum_{F\subset\partial K} \int_F
+     * \sum_c |[\partial_n u_c]|^2$, with zero contributions from faces at
+     * the boundary. This is what deal.II's KellyErrorEstimator computes
+     * for a component mask.
+     *
+     * Derived classes describe the sets of components they need an
+     * indicator for through get_component_masks() and combine the
+     * resulting indicators in combine_indicators(). The Manager class
+     * computes the indicators of all active criteria derived from this
+     * class in a single parallel loop over all cells, which evaluates the
+     * jumps of all requested components on each face only once. See
+     * compute_kelly_indicators().
+     *
+     * @ingroup MeshRefinement
+     */
+    template <int dim>
+    class KellyInterface : public Interface<dim>,
+      public SimulatorAccess<dim>
+    {
+      public:
+        /**
+         * Execute this mesh refinement criterion on its own.
+         *
+         * @param[out] error_indicators A vector that for every active cell of
+         * the current mesh (which may be a partition of a distributed mesh)
+         * provides an error indicator. This vector will already have the
+         * correct size when the function is called.
+         */
+        void
+        execute (Vector<float> &error_indicators) const override;
+
+        /**
+         * Return the component masks for which this criterion needs an
+         * indicator. One indicator is computed for each of the returned
+         * masks, in which the jumps of all selected components are added
+         * up.
+         */
+        virtual
+        std::vector<ComponentMask>
+        get_component_masks () const = 0;
+
+        /**
+         * Return the quadrature formula used to integrate the jumps over
+         * the faces of each cell.
+         */
+        virtual
+        const Quadrature<dim-1> &
+        get_face_quadrature () const = 0;
+
+        /**
+         * Compute the error indicators of this criterion from the
+         * indicators for the component masks returned by
+         * get_component_masks(), in the same order. The default
+         * implementation adds them up.
+         */
+        virtual
+        void
+        combine_indicators (const std::vector<Vector<float>> &indicators_per_mask,
+                            Vector<float> &error_indicators) const;
+    };
+
+
+
+    /**
+     * Compute the refinement indicators of all of the given Kelly-type
+     * @p criteria in one pass. This function loops over all locally owned
+     * cells in parallel and computes the jumps of the normal derivatives of
+     * all components any of the criteria asks for on each face, with one
+     * set of face values per distinct face quadrature formula. Afterwards,
+     * each criterion combines the indicators for its component masks.
+     * Faces with a periodic neighbor are treated like interior faces.
+     *
+     * Every cell integrates the jumps over all of its faces and only writes
+     * its own indicators, so that no synchronization between the threads is
+     * necessary. Consequently, every interior face is integrated twice,
+     * once from each side. deal.II's KellyErrorEstimator instead integrates
+     * every face once, but needs to be called for every component mask
+     * separately.
+     *
+     * @param[in] simulator_access An object that provides access to the
+     * solution.
+     * @param[in] criteria The criteria whose indicators should be computed.
+     * @param[out] error_indicators One vector of error indicators per
+     * criterion. The vectors already need to have the correct size.
+     */
+    template <int dim>
+    void
+    compute_kelly_indicators (const SimulatorAccess<dim> &simulator_access,
+                              const std::vector<const KellyInterface<dim> *> &criteria,
+                              const std::vector<Vector<float> *> &error_indicators);
+
+
+
 
 
 
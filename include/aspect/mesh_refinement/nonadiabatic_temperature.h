@@ -37,20 +37,23 @@ namespace aspect
      * @ingroup MeshRefinement
      */
     template <int dim>
-    class NonadiabaticTemperature : public Interface<dim>,
-      public SimulatorAccess<dim>
+    class NonadiabaticTemperature : public FieldGradientInterface<dim>
     {
       public:
         /**
-         * Execute this mesh refinement criterion.
-         *
-         * @param[out] error_indicators A vector that for every active cell of
-         * the current mesh (which may be a partition of a distributed mesh)
-         * provides an error indicator. This vector will already have the
-         * correct size when the function is called.
+         * Return the material properties this criterion needs.
+         */
+        MaterialModel::MaterialProperties::Property
+        get_needed_material_properties () const override;
+
+        /**
+         * Compute the difference between the temperature and the adiabatic
+         * temperature at the support points of the temperature element.
          */
         void
-        execute (Vector<float> &error_indicators) const override;
+        compute_field_values (const MaterialModel::MaterialModelInputs<dim> &in,
+                              const MaterialModel::MaterialModelOutputs<dim> &out,
+                              std::vector<double> &values) const override;
     };
   }
 }
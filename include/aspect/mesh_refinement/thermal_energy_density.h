@@ -38,20 +38,30 @@ namespace aspect
      * @ingroup MeshRefinement
      */
     template <int dim>
-    class ThermalEnergyDensity : public Interface<dim>,
-      public SimulatorAccess<dim>
+    class ThermalEnergyDensity : public FieldGradientInterface<dim>
     {
       public:
         /**
-         * Execute this mesh refinement criterion.
-         *
-         * @param[out] error_indicators A vector that for every active cell of
-         * the current mesh (which may be a partition of a distributed mesh)
-         * provides an error indicator. This vector will already have the
-         * correct size when the function is called.
+         * Return the material properties this criterion needs.
+         */
+        MaterialModel::MaterialProperties::Property
+        get_needed_material_properties () const override;
+
+        /**
+         * Compute the thermal energy density at the support points of the
+         * temperature element.
          */
         void
-        execute (Vector<float> &error_indicators) const override;
+        compute_field_values (const MaterialModel::MaterialModelInputs<dim> &in,
+                              const MaterialModel::MaterialModelOutputs<dim> &out,
+                              std::vector<double> &values) const override;
+
+        /**
+         * Return the power of the cell diameter by which the gradient of
+         * the thermal energy density is scaled, $1.5$.
+         */
+        double
+        get_cell_diameter_power () const override;
     };
   }
 }
@@ -37,20 +37,20 @@ namespace aspect
      * @ingroup MeshRefinement
      */
     template <int dim>
-    class Velocity : public Interface<dim>,
-      public SimulatorAccess<dim>
+    class Velocity : public KellyInterface<dim>
     {
       public:
         /**
-         * Execute this mesh refinement criterion.
-         *
-         * @param[out] error_indicators A vector that for every active cell of
-         * the current mesh (which may be a partition of a distributed mesh)
-         * provides an error indicator. This vector will already have the
-         * correct size when the function is called.
+         * Return the component mask of the velocity.
          */
-        void
-        execute (Vector<float> &error_indicators) const override;
+        std::vector<ComponentMask>
+        get_component_masks () const override;
+
+        /**
+         * Return the face quadrature formula of the velocity.
+         */
+        const Quadrature<dim-1> &
+        get_face_quadrature () const override;
     };
   }
 }
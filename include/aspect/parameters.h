@@ -553,6 +553,7 @@ namespace aspect
 
     // subsection: Advection solver parameters
     unsigned int                   advection_gmres_restart_length;
+    bool                           assemble_compositional_fields_together;
 
     // subsection: Stokes solver parameters
     bool                           use_direct_stokes_solver;
@@ -708,6 +709,7 @@ namespace aspect
      */
     int                            checkpoint_time_secs;
     int                            checkpoint_steps;
+    bool                           incremental_checkpoints;
     /**
      * @}
      */
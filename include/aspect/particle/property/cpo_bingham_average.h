@@ -112,6 +112,14 @@ namespace aspect
           UpdateTimeFlags
           need_update () const override;
 
+          /**
+           * The averages are computed from random draws of the grains,
+           * so the update depends on the order in which the particles
+           * are processed and can not be done in parallel.
+           */
+          bool
+          update_is_thread_safe () const override;
+
           /**
            * Return which data has to be provided to update the property.
            * The integrated strains needs the gradients of the velocity.
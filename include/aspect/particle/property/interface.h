@@ -434,6 +434,19 @@ namespace aspect
           UpdateTimeFlags
           need_update () const;
 
+          /**
+           * Return whether update_particle_properties() can be called for
+           * different cells concurrently from several threads, and whether
+           * doing so gives the same results as calling it for one cell after
+           * the other. The default implementation returns true. Plugins
+           * that modify internal state in their update function (for example
+           * by drawing from a random number generator) should return false,
+           * in which case the particles are updated on a single thread.
+           */
+          virtual
+          bool
+          update_is_thread_safe () const;
+
           /**
            * Return which data has to be provided to update all properties.
            * Note that particle properties can only ask for update_default
@@ -619,6 +632,14 @@ namespace aspect
           UpdateTimeFlags
           need_update () const;
 
+          /**
+           * Return whether the update_particle_properties() functions of
+           * all selected property plugins can be called concurrently for
+           * different cells. See Interface::update_is_thread_safe().
+           */
+          bool
+          update_is_thread_safe () const;
+
           /**
            * Return which data has to be provided to update all properties.
            * Note that particle properties can only ask for update_default
@@ -161,6 +161,15 @@ namespace aspect
          */
         unsigned int quadrature_degree_increase;
 
+        /**
+         * The ratio of the radius of a cell and the distance to a satellite
+         * below which the masses of the cell are replaced by a single point
+         * mass at their center of mass. A value of zero means that the
+         * contributions of all quadrature points are always summed up
+         * exactly.
+         */
+        double multipole_opening_angle;
+
         /**
          * Parameter for the fibonacci spiral sampling scheme:
          */
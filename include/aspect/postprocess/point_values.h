@@ -24,6 +24,7 @@
 
 #include <aspect/postprocess/interface.h>
 #include <aspect/simulator_access.h>
+#include <aspect/utilities.h>
 
 #include <deal.II/base/data_out_base.h>
 
@@ -48,6 +49,12 @@ namespace aspect
          */
         PointValues ();
 
+        /**
+         * Connect to the signals that tell us when the mesh changes, so
+         * that the evaluation points are located again.
+         */
+        void initialize () override;
+
         /**
          * Evaluate the solution and determine the values at the
          * selected points.
@@ -111,6 +118,14 @@ namespace aspect
          * that can be used by VectorTools.
          */
         std::vector<Point<dim>> evaluation_points_cartesian;
+
+        /**
+         * An object that knows which cells the evaluation points lie in.
+         * It is set up the first time the solution is evaluated after the
+         * mesh has changed.
+         */
+        Utilities::PointValueEvaluator<dim> point_value_evaluator;
+
         /**
          * The values of the solution at the evaluation points.
          */
@@ -25,8 +25,10 @@
 #include <aspect/postprocess/interface.h>
 #include <aspect/simulator_access.h>
 #include <aspect/plugins.h>
+#include <aspect/material_model/interface.h>
 
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/numerics/data_postprocessor.h>
 #include <deal.II/base/data_out_base.h>
 #include <deal.II/numerics/data_out.h>
@@ -178,6 +180,35 @@ namespace aspect
           std::list<std::string>
           required_other_postprocessors () const;
 
+          /**
+           * Return the material properties this postprocessor reads from
+           * the material model evaluation that is shared between all
+           * visualization postprocessors, see
+           * Visualization::get_material_model_evaluation(). The shared
+           * evaluation requests the union of the properties returned by all
+           * active visualization postprocessors.
+           *
+           * The default implementation returns
+           * MaterialModel::MaterialProperties::uninitialized, i.e., the
+           * postprocessor does not use the shared evaluation.
+           */
+          virtual
+          MaterialModel::MaterialProperties::Property
+          get_needed_material_properties () const;
+
+          /**
+           * Add the additional material model outputs this postprocessor
+           * needs from the shared material model evaluation to
+           * @p outputs. Several postprocessors may need the same kind of
+           * additional outputs, so implementations should only add an
+           * object if @p outputs does not contain one of the same type yet.
+           *
+           * The default implementation does nothing.
+           */
+          virtual
+          void
+          create_additional_material_model_outputs (MaterialModel::MaterialModelOutputs<dim> &outputs) const;
+
           /**
            * Save the state of this object to the argument given to this
            * function. This function is in support of checkpoint/restart
@@ -295,6 +326,36 @@ namespace aspect
           virtual
           ~SurfaceOnlyVisualization () = default;
       };
+
+
+
+      /**
+       * The material model inputs and outputs at the output points of one
+       * cell, together with the data they were computed from. This is
+       * the shared material model evaluation that
+       * Visualization::get_material_model_evaluation() returns.
+       */
+      template <int dim>
+      struct MaterialModelEvaluation
+      {
+        MaterialModelEvaluation (const DataPostprocessorInputs::Vector<dim> &input_data,
+                                 const Introspection<dim> &introspection);
+
+        /**
+         * Return whether this object was computed from the same cell,
+         * points, and solution as are given in @p input_data.
+         */
+        bool
+        matches (const DataPostprocessorInputs::Vector<dim> &input_data) const;
+
+        typename DoFHandler<dim>::cell_iterator cell;
+        std::vector<Point<dim>> evaluation_points;
+        std::vector<Vector<double>> solution_values;
+        std::vector<std::vector<Tensor<1,dim>>> solution_gradients;
+
+        MaterialModel::MaterialModelInputs<dim> inputs;
+        MaterialModel::MaterialModelOutputs<dim> outputs;
+      };
     }
 
 
@@ -418,6 +479,24 @@ namespace aspect
          */
         bool output_pointwise_stress_and_strain() const;
 
+        /**
+         * Return the material model inputs and outputs at the points given
+         * in @p input_data. Visualization postprocessors can call this
+         * function from their evaluate functions instead of evaluating the
+         * material model themselves. The material model is then only
+         * evaluated once per cell for all postprocessors, requesting the
+         * union of the material properties and additional outputs of all
+         * active visualization postprocessors (see
+         * VisualizationPostprocessors::Interface::get_needed_material_properties()
+         * and
+         * VisualizationPostprocessors::Interface::create_additional_material_model_outputs()).
+         *
+         * The returned evaluation is stored per thread and remains valid
+         * until the next call to this function on the same thread.
+         */
+        const VisualizationPostprocessors::MaterialModelEvaluation<dim> &
+        get_material_model_evaluation (const DataPostprocessorInputs::Vector<dim> &input_data) const;
+
         /**
          * Exception.
          */
@@ -598,6 +677,20 @@ namespace aspect
          */
         std::list<std::unique_ptr<VisualizationPostprocessors::Interface<dim>>> postprocessors;
 
+        /**
+         * The union of the material properties that the visualization
+         * postprocessors in the list above need from the shared material
+         * model evaluation.
+         */
+        MaterialModel::MaterialProperties::Property material_model_properties;
+
+        /**
+         * The most recent shared material model evaluation on each thread,
+         * see get_material_model_evaluation(). The stored evaluations are
+         * deleted at the end of every graphical output.
+         */
+        mutable Threads::ThreadLocalStorage<std::unique_ptr<VisualizationPostprocessors::MaterialModelEvaluation<dim>>> material_model_evaluations;
+
         /**
          * A structure that keeps some history about past output operations.
          * These variables are grouped into a structure because we need them
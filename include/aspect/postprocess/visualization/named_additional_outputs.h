@@ -69,6 +69,12 @@ namespace aspect
           evaluate_vector_field(const DataPostprocessorInputs::Vector<dim> &input_data,
                                 std::vector<Vector<double>> &computed_quantities) const override;
 
+          MaterialModel::MaterialProperties::Property
+          get_needed_material_properties () const override;
+
+          void
+          create_additional_material_model_outputs (MaterialModel::MaterialModelOutputs<dim> &outputs) const override;
+
         private:
           std::vector<std::string> property_names;
       };
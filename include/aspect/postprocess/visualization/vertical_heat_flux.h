@@ -59,6 +59,9 @@ namespace aspect
           void
           evaluate_vector_field(const DataPostprocessorInputs::Vector<dim> &input_data,
                                 std::vector<Vector<double>> &computed_quantities) const override;
+
+          MaterialModel::MaterialProperties::Property
+          get_needed_material_properties () const override;
       };
     }
   }
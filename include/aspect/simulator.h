@@ -70,7 +70,10 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #include <boost/iostreams/stream.hpp>
 
 #include <memory>
+#include <exception>
 #include <thread>
+#include <deque>
+#include <set>
 
 
 namespace aspect
@@ -86,7 +89,7 @@ namespace aspect
   template <int dim>
   class StokesMatrixFreeHandler;
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   class StokesMatrixFreeHandlerImplementation;
 
   namespace MeshDeformation
@@ -849,6 +852,18 @@ namespace aspect
        */
       void assemble_advection_system (const AdvectionField &advection_field);
 
+      /**
+       * Initiate the assembly of the matrices and right hand sides of
+       * several advection fields in a single loop over all cells. The
+       * material model and the heating models are evaluated only once per
+       * cell for all of these fields. All fields need to use the same finite
+       * element and must not have assemblers that work on faces.
+       *
+       * This function is implemented in
+       * <code>source/simulator/assembly.cc</code>.
+       */
+      void assemble_advection_systems (const std::vector<AdvectionField> &advection_fields);
+
       /**
        * Solve one block of the temperature/composition linear system.
        * Return the initial nonlinear residual, i.e., if the linear system to
@@ -1002,11 +1017,26 @@ namespace aspect
        * read from the input parameter file. See the manual for more
        * information.
        *
+       * Only the parts that need the current state of the program and MPI
+       * communication happen before this function returns. Compressing and
+       * writing the general information on the root process and replacing
+       * the previous snapshot by the new one happens on a separate thread.
+       *
        * This function is implemented in
        * <code>source/simulator/checkpoint_restart.cc</code>.
        */
       void create_snapshot();
 
+      /**
+       * Wait until the snapshot that create_snapshot() started to write in
+       * the background is complete. Rethrow any exception that occurred
+       * while writing it.
+       *
+       * This function is implemented in
+       * <code>source/simulator/checkpoint_restart.cc</code>.
+       */
+      void wait_for_snapshot_writing();
+
       /**
        * Restore the state of this program from a set of files in the output
        * directory. In reality, however, only some variables are stored (in
@@ -1191,6 +1221,34 @@ namespace aspect
                                           const typename DoFHandler<dim>::active_cell_iterator &cell,
                                           internal::Assembly::Scratch::AdvectionSystem<dim> &scratch,
                                           internal::Assembly::CopyData::AdvectionSystem<dim> &data);
+      /**
+       * Compute everything on a single cell that the assembly of all
+       * advection systems has in common: reinitialize the FEValues object,
+       * and evaluate the velocities, the material model and the heating
+       * models at the quadrature points.
+       *
+       * This function is implemented in
+       * <code>source/simulator/assembly.cc</code>.
+       */
+      void
+      local_prepare_advection_system (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                      internal::Assembly::Scratch::AdvectionSystem<dim>  &scratch);
+
+      /**
+       * Compute the integrals for one advection matrix and right hand side on
+       * a single cell, assuming that local_prepare_advection_system() has
+       * already been called for this cell.
+       *
+       * This function is implemented in
+       * <code>source/simulator/assembly.cc</code>.
+       */
+      void
+      local_assemble_advection_field (const AdvectionField &advection_field,
+                                      const Vector<double>           &viscosity_per_cell,
+                                      const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                      internal::Assembly::Scratch::AdvectionSystem<dim>  &scratch,
+                                      internal::Assembly::CopyData::AdvectionSystem<dim> &data);
+
       /**
        * Compute the integrals for one advection matrix and right hand side on
        * a single cell.
@@ -1927,6 +1985,20 @@ namespace aspect
        */
       double total_walltime_until_last_snapshot;
 
+      /**
+       * Whether the mesh has changed since the last snapshot was created.
+       * Incremental snapshots only write the mesh if this is the case.
+       */
+      bool mesh_changed_since_last_snapshot;
+
+      /**
+       * The names of the files in which this process has stored the blocks
+       * of vector data of incremental snapshots. The last element contains
+       * the blocks used by the most recent snapshot, the elements before it
+       * the blocks of the previous snapshots that may still be needed.
+       */
+      std::deque<std::set<std::string>> incremental_snapshot_chunks;
+
       /**
        * In output_statistics(), where we output the statistics object above,
        * we do the actual writing on a separate thread. This variable is the
@@ -1936,6 +2008,17 @@ namespace aspect
        */
       std::thread                         output_statistics_thread;
 
+      /**
+       * In create_snapshot(), the root process compresses and writes the
+       * general information of the snapshot, and then moves the files of
+       * the new snapshot into place, on a separate thread. This variable is
+       * the handle for this thread, and the following one stores an
+       * exception that may have occurred on it, so that it can be rethrown
+       * on the main thread in wait_for_snapshot_writing().
+       */
+      std::thread                         snapshot_writing_thread;
+      std::exception_ptr                  snapshot_writing_exception;
+
       /**
        * @}
        */
@@ -2175,7 +2258,7 @@ namespace aspect
       friend class MeshDeformation::MeshDeformationHandler<dim>;   // MeshDeformationHandler needs access to the internals of the Simulator
       friend class VolumeOfFluidHandler<dim>; // VolumeOfFluidHandler needs access to the internals of the Simulator
       friend class StokesMatrixFreeHandler<dim>;
-      template <int dimension, int velocity_degree>
+      template <int dimension, int velocity_degree, typename MGNumberType>
       friend class StokesMatrixFreeHandlerImplementation;
       friend struct Parameters<dim>;
   };
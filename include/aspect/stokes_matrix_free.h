@@ -26,6 +26,8 @@
 
 #include <aspect/simulator.h>
 
+#include <deal.II/base/aligned_vector.h>
+
 #include <deal.II/matrix_free/matrix_free.h>
 #include <deal.II/matrix_free/operators.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
@@ -44,11 +46,6 @@
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/la_parallel_block_vector.h>
 
-/**
- * Typedef for the number type for the multigrid operators. Can be either float or double.
- */
-using GMGNumberType = double;
-
 namespace aspect
 {
   using namespace dealii;
@@ -168,6 +165,49 @@ namespace aspect
        */
       std::set<types::boundary_id> free_surface_boundary_indicators;
 
+      /**
+       * If true, the operators describe the system of a model with melt
+       * transport, i.e., the pressure DoFHandler contains the fluid
+       * pressure (first component) and the compaction pressure (second
+       * component). This is only supported on the active level.
+       */
+      bool include_melt_transport;
+
+      /**
+       * Table which stores the Darcy coefficient $K_D$ for each
+       * quadrature point in models with melt transport.
+       */
+      Table<2, VectorizedArray<number>> darcy_coefficient_table;
+
+      /**
+       * Table which stores the inverse of the compaction viscosity for
+       * each quadrature point in models with melt transport.
+       */
+      Table<2, VectorizedArray<number>> inverse_compaction_viscosity_table;
+
+      /**
+       * Table which stores the product of the Darcy coefficient and the
+       * gradient of the fluid density divided by the fluid density for
+       * each quadrature point. This table is only filled in compressible
+       * models with melt transport.
+       */
+      Table<2, Tensor<1, dim, VectorizedArray<number>>> fluid_density_gradient_table;
+
+      /**
+       * Table which stores the scaling factor of the compaction pressure
+       * for each cell, see MaterialModel::MeltInterface::p_c_scale(). It is
+       * zero in cells that do not contain melt.
+       */
+      Table<2, VectorizedArray<number>> compaction_pressure_scaling_table;
+
+      /**
+       * The local indices (in the pressure vector) of the locally owned
+       * compaction pressure DoFs that are constrained to zero because they
+       * are not part of a melt cell. The operators act as the identity on
+       * these DoFs.
+       */
+      std::vector<unsigned int> constrained_compaction_pressure_dofs;
+
       /**
        * Determine an estimate for the memory consumption (in bytes) of this
        * object.
@@ -229,6 +269,15 @@ namespace aspect
                           const dealii::LinearAlgebra::distributed::BlockVector<number> &src,
                           const std::pair<unsigned int, unsigned int> &cell_range) const;
 
+        /**
+         * Defines the application of the cell matrix in models with melt
+         * transport.
+         */
+        void local_apply_melt (const dealii::MatrixFree<dim, number> &data,
+                               dealii::LinearAlgebra::distributed::BlockVector<number> &dst,
+                               const dealii::LinearAlgebra::distributed::BlockVector<number> &src,
+                               const std::pair<unsigned int, unsigned int> &cell_range) const;
+
         /**
          * This function doesn't do anything, it's created to use the matrixfree loop.
          */
@@ -282,6 +331,31 @@ namespace aspect
          */
         void compute_diagonal () override;
 
+        /**
+         * Compute and store the inverses of the cell matrices of this
+         * operator. For a discontinuous pressure element, the operator is
+         * block diagonal with one block per cell, so these are the blocks
+         * of its exact inverse.
+         */
+        void compute_inverse_block_diagonal ();
+
+        /**
+         * Apply the inverse computed by compute_inverse_block_diagonal(),
+         * i.e., the exact inverse of the operator if the pressure element is
+         * discontinuous.
+         */
+        void apply_inverse_block_diagonal (dealii::LinearAlgebra::distributed::Vector<number> &dst,
+                                           const dealii::LinearAlgebra::distributed::Vector<number> &src) const;
+
+        /**
+         * Assemble the operator in models with melt transport into the
+         * sparse matrix @p matrix, whose sparsity pattern has to be built
+         * with the same @p constraints. This matrix is used to build an
+         * AMG preconditioner for the fluid and compaction pressure block.
+         */
+        void compute_melt_matrix (const AffineConstraints<number> &constraints,
+                                  dealii::TrilinosWrappers::SparseMatrix &matrix) const;
+
       private:
 
         /**
@@ -299,6 +373,24 @@ namespace aspect
                           const dealii::LinearAlgebra::distributed::Vector<number> &src,
                           const std::pair<unsigned int, unsigned int> &cell_range) const;
 
+        /**
+         * Defines the application of the cell matrix in models with melt
+         * transport, where the operator describes the approximation of the
+         * Schur complement for the fluid and compaction pressure.
+         */
+        void local_apply_melt (const dealii::MatrixFree<dim, number> &data,
+                               dealii::LinearAlgebra::distributed::Vector<number> &dst,
+                               const dealii::LinearAlgebra::distributed::Vector<number> &src,
+                               const std::pair<unsigned int, unsigned int> &cell_range) const;
+
+        /**
+         * Defines the application of the inverse cell matrices.
+         */
+        void local_apply_inverse_block_diagonal (const dealii::MatrixFree<dim, number> &data,
+                                                 dealii::LinearAlgebra::distributed::Vector<number> &dst,
+                                                 const dealii::LinearAlgebra::distributed::Vector<number> &src,
+                                                 const std::pair<unsigned int, unsigned int> &cell_range) const;
+
 
         /**
          * Computes the diagonal contribution from a cell matrix.
@@ -308,10 +400,26 @@ namespace aspect
                                      const unsigned int                               &dummy,
                                      const std::pair<unsigned int,unsigned int>       &cell_range) const;
 
+        /**
+         * Computes the diagonal contribution from a cell matrix in models
+         * with melt transport.
+         */
+        void local_compute_diagonal_melt (const MatrixFree<dim,number>                     &data,
+                                          dealii::LinearAlgebra::distributed::Vector<number>  &dst,
+                                          const unsigned int                               &dummy,
+                                          const std::pair<unsigned int,unsigned int>       &cell_range) const;
+
         /**
          * A pointer to the current cell data that contains viscosity and other required parameters per cell.
          */
         const OperatorCellData<dim,number> *cell_data;
+
+        /**
+         * The inverses of the cell matrices computed by
+         * compute_inverse_block_diagonal(), stored row by row for each cell
+         * batch.
+         */
+        AlignedVector<VectorizedArray<number>> inverse_cell_matrices;
     };
 
     /**
@@ -480,18 +588,11 @@ namespace aspect
       get_constraints_p () const = 0;
 
       /**
-       * Return a pointer to the MGTransfer object used for the A block
-       * of the block GMG Stokes solver.
+       * Return the memory consumption in bytes of the MGTransfer objects
+       * used for the A block and the Schur complement block of the block
+       * GMG Stokes solver.
        */
-      virtual const MGTransferMF<dim,GMGNumberType> &
-      get_mg_transfer_A () const = 0;
-
-      /**
-       * Return a pointer to the MGTransfer object used for the Schur
-       * complement block of the block GMG Stokes solver.
-       */
-      virtual const MGTransferMF<dim,GMGNumberType> &
-      get_mg_transfer_S () const = 0;
+      virtual std::size_t get_mg_transfer_memory_consumption() const = 0;
 
       /**
        * Return the memory consumption in bytes that are used to store
@@ -508,9 +609,12 @@ namespace aspect
    * second template argument for the degree of the Stokes finite
    * element. This way, the main simulator does not need to know about the
    * degree by using a pointer to the base class and we can pick the desired
-   * velocity degree at runtime.
+   * velocity degree at runtime. The third template argument is the number
+   * type (float or double) of the operators on the multigrid levels, which
+   * is also selected at runtime. The active level operators always use
+   * double.
    */
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   class StokesMatrixFreeHandlerImplementation: public StokesMatrixFreeHandler<dim>
   {
     public:
@@ -599,15 +703,22 @@ namespace aspect
        * Return a pointer to the MGTransfer object used for the A block
        * of the block GMG Stokes solver.
        */
-      const MGTransferMF<dim,GMGNumberType> &
-      get_mg_transfer_A () const override;
+      const MGTransferMF<dim,MGNumberType> &
+      get_mg_transfer_A () const;
 
       /**
        * Return a pointer to the MGTransfer object used for the Schur
        * complement block of the block GMG Stokes solver.
        */
-      const MGTransferMF<dim,GMGNumberType> &
-      get_mg_transfer_S () const override;
+      const MGTransferMF<dim,MGNumberType> &
+      get_mg_transfer_S () const;
+
+      /**
+       * Return the memory consumption in bytes of the MGTransfer objects
+       * used for the A block and the Schur complement block of the block
+       * GMG Stokes solver.
+       */
+      std::size_t get_mg_transfer_memory_consumption() const override;
 
 
       /**
@@ -622,10 +733,23 @@ namespace aspect
        */
       void parse_parameters (ParameterHandler &prm);
 
+      /**
+       * Return whether the Schur complement approximation is preconditioned
+       * with geometric multigrid. This is not the case for a discontinuous
+       * pressure, where the exact inverse of the block diagonal
+       * approximation is applied instead, and for models with melt
+       * transport, where an AMG V-cycle on the active level is used.
+       */
+      bool schur_complement_uses_gmg () const;
+
       /**
        * Evaluate the MaterialModel to query information like the viscosity and
        * project this viscosity to the multigrid hierarchy. Also queries
        * other parameters like pressure scaling.
+       *
+       * The material model is evaluated on the active cells in parallel
+       * using WorkStream, and the viscosity table of the active level
+       * operators is filled directly from the cellwise projection.
        */
       void evaluate_material_model();
 
@@ -663,19 +787,19 @@ namespace aspect
       /**
        * Store the data for the Stokes operator (viscosity, etc.) for the active cells.
        */
-      MatrixFreeStokesOperators::OperatorCellData<dim, GMGNumberType> active_cell_data;
+      MatrixFreeStokesOperators::OperatorCellData<dim, double> active_cell_data;
 
       /**
        * Store the data for the Stokes operator (viscosity, etc.) for each multigrid level.
        */
-      MGLevelObject<MatrixFreeStokesOperators::OperatorCellData<dim, GMGNumberType>> level_cell_data;
+      MGLevelObject<MatrixFreeStokesOperators::OperatorCellData<dim, MGNumberType>> level_cell_data;
 
       using StokesMatrixType = MatrixFreeStokesOperators::StokesOperator<dim,velocity_degree,double>;
       using SchurComplementMatrixType = MatrixFreeStokesOperators::MassMatrixOperator<dim,velocity_degree-1,double>;
       using ABlockMatrixType = MatrixFreeStokesOperators::ABlockOperator<dim,velocity_degree,double>;
 
-      using GMGSchurComplementMatrixType = MatrixFreeStokesOperators::MassMatrixOperator<dim,velocity_degree-1,GMGNumberType>;
-      using GMGABlockMatrixType = MatrixFreeStokesOperators::ABlockOperator<dim,velocity_degree,GMGNumberType>;
+      using GMGSchurComplementMatrixType = MatrixFreeStokesOperators::MassMatrixOperator<dim,velocity_degree-1,MGNumberType>;
+      using GMGABlockMatrixType = MatrixFreeStokesOperators::ABlockOperator<dim,velocity_degree,MGNumberType>;
 
       StokesMatrixType stokes_matrix;
       ABlockMatrixType A_block_matrix;
@@ -691,10 +815,19 @@ namespace aspect
       MGConstrainedDoFs mg_constrained_dofs_Schur_complement;
       MGConstrainedDoFs mg_constrained_dofs_projection;
 
-      MGTransferMF<dim,GMGNumberType> mg_transfer_A_block;
-      MGTransferMF<dim,GMGNumberType> mg_transfer_Schur_complement;
+      MGTransferMF<dim,MGNumberType> mg_transfer_A_block;
+      MGTransferMF<dim,MGNumberType> mg_transfer_Schur_complement;
+
+      /**
+       * In models with melt transport, the Schur complement approximation
+       * assembled into a sparse matrix and the AMG preconditioner built
+       * from it. See build_preconditioner().
+       */
+      LinearAlgebra::SparseMatrix melt_Schur_complement_matrix;
+      LinearAlgebra::PreconditionAMG melt_Schur_complement_preconditioner;
 
       std::vector<std::shared_ptr<MatrixFree<dim,double>>> matrix_free_objects;
+      std::vector<std::shared_ptr<MatrixFree<dim,MGNumberType>>> level_matrix_free_objects;
   };
 }
 
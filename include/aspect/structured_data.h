@@ -149,6 +149,38 @@ namespace aspect
         void
         load_netcdf(const std::string &filename, const std::vector<std::string> &data_column_names = {});
 
+        /**
+         * Fill the current object with data read from a binary data file
+         * with filename @p filename. Reading these files is much faster than
+         * parsing ascii files, which matters for large data tables. Such
+         * files can be created from ascii data files with the script
+         * contrib/python/scripts/ascii2binary.py.
+         *
+         * The file is mapped into memory on the root process of
+         * @p communicator only, and the data tables are then shared with
+         * all other processes on the same machine.
+         *
+         * The file consists of the following entries, all in native byte
+         * order:
+         * - the 8 characters "ASPECTSD",
+         * - the format version (currently 1), the number of coordinate
+         *   dimensions, and the number of data components as 32 bit unsigned
+         *   integers,
+         * - the number of grid points in each coordinate direction as 32 bit
+         *   unsigned integers,
+         * - for each data component the length of its name as a 32 bit
+         *   unsigned integer followed by the characters of the name,
+         * - zero padding up to the next multiple of 8 bytes,
+         * - the coordinate values in each direction as double precision
+         *   numbers,
+         * - the data values of each component as double precision numbers,
+         *   in the same order as in ascii data files, i.e., with the first
+         *   coordinate ascending first.
+         */
+        void
+        load_binary(const std::string &filename,
+                    const MPI_Comm communicator);
+
 
         /**
          * Loads data from a file replacing the current data.
@@ -162,6 +194,7 @@ namespace aspect
          * The following formats are currently supported:
          * - ASCII files (typically ending in .txt)
          * - gzip compressed ASCII files (ending in .gz)
+         * - binary data files (ending in .bin), see load_binary()
          * - URLs starting with "http" (handled by libDAB)
          */
         void
@@ -195,6 +228,35 @@ namespace aspect
         get_gradients(const Point<dim> &position,
                       const unsigned int component);
 
+        /**
+         * Returns the computed data for several components at several
+         * positions at once. In contrast to calling the single-point
+         * get_data() function once per position and component, this
+         * function locates each position in the data grid only once and
+         * then interpolates all requested components from the same grid
+         * cell.
+         *
+         * @param positions The positions at which to compute the data.
+         * @param components The indices of the data columns to be returned.
+         * @param data_values The computed data. Will be resized to
+         * <code>positions.size()</code> entries, each of which contains
+         * <code>components.size()</code> values in the order given by
+         * @p components.
+         */
+        void
+        get_data(const std::vector<Point<dim>>      &positions,
+                 const std::vector<unsigned int>    &components,
+                 std::vector<std::vector<double>>   &data_values) const;
+
+        /**
+         * Same as the function above, but for a single position. @p data_values
+         * is resized to the size of @p components.
+         */
+        void
+        get_data(const Point<dim>                   &position,
+                 const std::vector<unsigned int>    &components,
+                 std::vector<double>                &data_values) const;
+
         /**
          * Returns a vector that contains the names of all data columns in the
          * order of their appearance in the data file (and their order in the
@@ -262,11 +324,19 @@ namespace aspect
         std::vector<std::string> data_component_names;
 
         /**
-         * Interpolation functions to access the data.
-         * Either InterpolatedUniformGridData or InterpolatedTensorProductGridData;
-         * the type is determined from the grid specified in the data file.
+         * The data tables, one for each data component. The values are
+         * interpolated (multi-)linearly between the grid points given by
+         * @p coordinate_values.
+         */
+        std::vector<Table<dim,double>> data;
+
+        /**
+         * The grid spacing in each direction. Only used if the coordinate
+         * values are equidistant, in which case the grid cell containing a
+         * given position can be computed directly instead of searching
+         * through the coordinate values.
          */
-        std::vector<std::unique_ptr<Function<dim>>> data;
+        std::array<double,dim> grid_spacing;
 
         /**
          * The coordinate values in each direction as specified in the data file.
@@ -302,6 +372,30 @@ namespace aspect
         TableIndices<dim>
         compute_table_indices(const TableIndices<dim> &sizes, const std::size_t idx) const;
 
+        /**
+         * Find the cell of the data grid that contains @p position and
+         * store the table indices of its lower left corner in @p ix and the
+         * local coordinates of @p position within this cell in
+         * @p unit_position. Positions outside of the data grid are
+         * associated with the closest grid cell, and their local coordinates
+         * are truncated to the range [0,1], i.e., the data is extended
+         * constantly beyond the boundaries of the grid.
+         */
+        void
+        compute_interpolation_position(const Point<dim> &position,
+                                       TableIndices<dim> &ix,
+                                       Point<dim> &unit_position) const;
+
+        /**
+         * Interpolate the data in @p table at the position described by the
+         * cell indices @p ix and the local coordinates @p unit_position
+         * computed by compute_interpolation_position().
+         */
+        double
+        interpolate(const Table<dim,double> &table,
+                    const TableIndices<dim> &ix,
+                    const Point<dim> &unit_position) const;
+
     };
 
     /**
@@ -394,6 +488,19 @@ namespace aspect
                             const Point<dim>                    &position,
                             const unsigned int                   component) const;
 
+        /**
+         * Returns several data components at the given position. The data
+         * position is computed and located in the data grid only once for
+         * all components, and the current and old data file (for
+         * time-dependent data) are interpolated in the same pass.
+         * @p data_values is resized to the size of @p components.
+         */
+        void
+        get_data_components (const types::boundary_id             boundary_indicator,
+                             const Point<dim>                    &position,
+                             const std::vector<unsigned int>     &components,
+                             std::vector<double>                 &data_values) const;
+
         /**
          * Returns the maximum value of the given data component.
          */
@@ -557,6 +664,17 @@ namespace aspect
         get_data_component (const Point<dim> &position,
                             const unsigned int component) const;
 
+        /**
+         * Returns several data components at the given position. The
+         * position is located in the data grid only once for all
+         * components. @p data_values is resized to the size of
+         * @p components.
+         */
+        void
+        get_data_components (const Point<dim> &position,
+                             const std::vector<unsigned int> &components,
+                             std::vector<double> &data_values) const;
+
         /**
          * Declare the parameters all derived classes take from input files.
          */
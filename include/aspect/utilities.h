@@ -370,6 +370,100 @@ namespace aspect
                               const MPI_Comm mpi_communicator);
 
 
+
+    /**
+     * A class that evaluates finite element vectors at a fixed set of
+     * points. The points are located in the mesh only once, in reinit(),
+     * and this information is then reused by every call to evaluate()
+     * until the mesh changes. Each point is assigned to exactly one of the
+     * processes that own a cell around it, only this process evaluates
+     * the finite element vector at the point, and the values at all points
+     * are communicated in a single reduction. This is considerably cheaper
+     * than calling VectorTools::point_value() for every point on every
+     * process, in particular for large numbers of points.
+     */
+    template <int dim>
+    class PointValueEvaluator
+    {
+      public:
+        /**
+         * Constructor. The object can only be used for evaluation after
+         * reinit() has been called.
+         */
+        PointValueEvaluator ();
+
+        /**
+         * Find the locally owned cells around the given @p points and the
+         * coordinates of the points on the reference cell. This function
+         * needs to be called again whenever the mesh or the mapping
+         * changes. It throws an exception if one of the points lies
+         * outside of the domain.
+         */
+        void
+        reinit (const std::vector<Point<dim>> &points,
+                const Mapping<dim> &mapping,
+                const DoFHandler<dim> &dof_handler,
+                const MPI_Comm mpi_communicator);
+
+        /**
+         * Forget the location of the points, for example because the mesh
+         * has changed.
+         */
+        void
+        clear ();
+
+        /**
+         * Return whether reinit() has been called since the object was
+         * created or clear() was called the last time.
+         */
+        bool
+        is_initialized () const;
+
+        /**
+         * Evaluate all components of the finite element vector @p solution,
+         * which needs to be defined on the DoFHandler given to reinit() and
+         * contain all locally relevant entries, at the points given to
+         * reinit(). On return, @p values contains on every process one
+         * vector with the values of all components for each point.
+         */
+        void
+        evaluate (const LinearAlgebra::BlockVector &solution,
+                  std::vector<Vector<double>> &values) const;
+
+      private:
+        /**
+         * The points located in one locally owned cell.
+         */
+        struct CellPoints
+        {
+          typename DoFHandler<dim>::active_cell_iterator cell;
+          std::vector<Point<dim>> reference_points;
+          std::vector<unsigned int> point_indices;
+        };
+
+        /**
+         * All locally owned cells that contain at least one point this
+         * process is responsible for.
+         */
+        std::vector<CellPoints> cell_points;
+
+        /**
+         * The total number of points on all processes.
+         */
+        unsigned int n_points;
+
+        /**
+         * The communicator used to combine the values of all processes.
+         */
+        MPI_Comm mpi_communicator;
+
+        /**
+         * Whether the points have been located in the current mesh.
+         */
+        bool initialized;
+    };
+
+
     namespace Coordinates
     {
 
@@ -548,6 +642,28 @@ namespace aspect
                                                       double theta,   // colatitude (radians)
                                                       double phi );   // longitude (radians)
 
+    /**
+     * Compute all real spherical harmonics from degree zero up to and including
+     * @p max_degree at the point given by the colatitude @p theta and the
+     * longitude @p phi. The normalization and sign convention are the same as in
+     * real_spherical_harmonic(), but instead of evaluating each degree and order
+     * separately, the associated Legendre functions are computed by the standard
+     * three-term recurrence for fully normalized functions and the trigonometric
+     * terms $\cos m\phi$ and $\sin m\phi$ by the Chebyshev recurrence. This makes
+     * the evaluation of all $(l_{\max}+1)(l_{\max}+2)/2$ functions cost about as
+     * much as a single call to real_spherical_harmonic(), and keeps the
+     * evaluation stable well beyond degree 100.
+     *
+     * The results are stored in @p cos_components and @p sin_components, which
+     * are resized as necessary. The value for degree $l$ and order $m$ can be
+     * found at index $l(l+1)/2+m$. For $m=0$ the sine part is zero.
+     */
+    void real_spherical_harmonics (const unsigned int max_degree,
+                                   const double theta,
+                                   const double phi,
+                                   std::vector<double> &cos_components,
+                                   std::vector<double> &sin_components);
+
     /**
      * A struct to enable numerical output with a comma as thousands separator
      */
@@ -35,6 +35,8 @@ namespace aspect
     ComputeProfile<dim>::ComputeProfile()
       :
       initialized(false),
+      surface_pressure(numbers::signaling_nan<double>()),
+      surface_temperature(numbers::signaling_nan<double>()),
       surface_condition_function(2)
     {}
 
@@ -46,8 +48,18 @@ namespace aspect
     {
       if (use_surface_condition_function)
         {
-          initialized = false;
           surface_condition_function.set_time(this->get_time());
+
+          // The profile only changes if the surface conditions do, so
+          // only recompute it in that case.
+          if (initialized
+              &&
+              surface_condition_function.value(Point<1>(0.0),0) == surface_pressure
+              &&
+              surface_condition_function.value(Point<1>(0.0),1) == surface_temperature)
+            return;
+
+          initialized = false;
           initialize();
         }
     }
@@ -75,13 +87,6 @@ namespace aspect
 
       delta_z = this->get_geometry_model().maximal_depth() / (n_points-1);
 
-      MaterialModel::MaterialModelInputs<dim> in(1, this->n_compositional_fields());
-      MaterialModel::MaterialModelOutputs<dim> out(1, this->n_compositional_fields());
-
-      // Constant properties on the reference profile
-      in.requested_properties = MaterialModel::MaterialProperties::equation_of_state_properties;
-      in.velocity[0] = Tensor <1,dim> ();
-
       // Check whether gravity is pointing up / out or down / in. In the normal case it should
       // point down / in and therefore gravity should be positive, leading to increasing
       // adiabatic pressures and temperatures with depth. In some cases it will point up / out
@@ -94,6 +99,109 @@ namespace aspect
                                      1 :
                                      -1;
 
+      if (!use_surface_condition_function)
+        {
+          surface_pressure = this->get_surface_pressure();
+          surface_temperature = this->get_adiabatic_surface_temperature();
+        }
+      else
+        {
+          surface_pressure = surface_condition_function.value(Point<1>(0.0),0);
+          surface_temperature = surface_condition_function.value(Point<1>(0.0),1);
+        }
+
+      // If requested, only the root process integrates the profile and
+      // all other processes receive the result. Otherwise every process
+      // computes the (identical) profile itself.
+      const unsigned int root_process = 0;
+      if (!compute_on_root_process_only
+          ||
+          Utilities::MPI::this_mpi_process(this->get_mpi_communicator()) == root_process)
+        {
+          if (integration_method == explicit_euler)
+            compute_profile_euler(gravity_direction);
+          else
+            compute_profile_runge_kutta(gravity_direction);
+        }
+
+      if (compute_on_root_process_only)
+        {
+          temperatures = Utilities::MPI::broadcast(this->get_mpi_communicator(), temperatures, root_process);
+          pressures = Utilities::MPI::broadcast(this->get_mpi_communicator(), pressures, root_process);
+          densities = Utilities::MPI::broadcast(this->get_mpi_communicator(), densities, root_process);
+        }
+
+      if (gravity_direction == 1 && this->get_surface_pressure() >= 0)
+        {
+          Assert (*std::min_element (pressures.begin(), pressures.end()) >=
+                  -std::numeric_limits<double>::epsilon() * pressures.size(),
+                  ExcMessage("Adiabatic ComputeProfile encountered a negative pressure of "
+                             + dealii::Utilities::to_string(*std::min_element (pressures.begin(), pressures.end()))));
+        }
+      else if (gravity_direction == -1 && this->get_surface_pressure() <= 0)
+        {
+          Assert (*std::max_element (pressures.begin(), pressures.end()) <=
+                  std::numeric_limits<double>::epsilon() * pressures.size(),
+                  ExcMessage("Adiabatic ComputeProfile encountered a positive pressure of "
+                             + dealii::Utilities::to_string(*std::max_element (pressures.begin(), pressures.end()))));
+        }
+
+      Assert (*std::min_element (temperatures.begin(), temperatures.end()) >=
+              -std::numeric_limits<double>::epsilon() * temperatures.size(),
+              ExcMessage("Adiabatic ComputeProfile encountered a negative temperature."));
+
+
+      initialized = true;
+    }
+
+
+
+    template <int dim>
+    std::vector<std::vector<double>>
+    ComputeProfile<dim>::compute_reference_compositions (const std::vector<Point<dim>> &points) const
+    {
+      std::vector<std::vector<double>> compositions (points.size(),
+                                                     std::vector<double>(this->n_compositional_fields()));
+
+      if (reference_composition == initial_composition)
+        initial_composition_manager->initial_compositions(points, compositions);
+      else if (reference_composition == reference_function)
+        {
+          for (unsigned int i=0; i<points.size(); ++i)
+            {
+              const Point<1> p(this->get_geometry_model().depth(points[i]));
+              for (unsigned int c=0; c<this->n_compositional_fields(); ++c)
+                compositions[i][c] = composition_function->value(p, c);
+            }
+        }
+      else
+        AssertThrow(false,ExcNotImplemented());
+
+      return compositions;
+    }
+
+
+
+    template <int dim>
+    void
+    ComputeProfile<dim>::compute_profile_euler (const int gravity_direction)
+    {
+      MaterialModel::MaterialModelInputs<dim> in(1, this->n_compositional_fields());
+      MaterialModel::MaterialModelOutputs<dim> out(1, this->n_compositional_fields());
+
+      // Constant properties on the reference profile
+      in.requested_properties = MaterialModel::MaterialProperties::equation_of_state_properties;
+      in.velocity[0] = Tensor <1,dim> ();
+
+      // The composition does not depend on the integration, so compute it
+      // for all points of the profile at once.
+      std::vector<Point<dim>> representative_points (n_points);
+      for (unsigned int i=0; i<n_points; ++i)
+        representative_points[i] = this->get_geometry_model().representative_point
+                                   (static_cast<double>(i)/static_cast<double>(n_points-1)*this->get_geometry_model().maximal_depth());
+
+      const std::vector<std::vector<double>> compositions = compute_reference_compositions(representative_points);
+
       // now integrate downward using the explicit Euler method for simplicity
       //
       // note: p'(z) = rho(p,T) * |g|
@@ -102,16 +210,8 @@ namespace aspect
         {
           if (i==0)
             {
-              if (!use_surface_condition_function)
-                {
-                  pressures[0] = this->get_surface_pressure();
-                  temperatures[0] = this->get_adiabatic_surface_temperature();
-                }
-              else
-                {
-                  pressures[0] = surface_condition_function.value(Point<1>(0.0),0);
-                  temperatures[0] = surface_condition_function.value(Point<1>(0.0),1);
-                }
+              pressures[0] = surface_pressure;
+              temperatures[0] = surface_temperature;
             }
           else
             {
@@ -135,8 +235,7 @@ namespace aspect
                                 temperatures[0];
             }
 
-          const double z = static_cast<double>(i)/static_cast<double>(n_points-1)*this->get_geometry_model().maximal_depth();
-          const Point<dim> representative_point = this->get_geometry_model().representative_point (z);
+          const Point<dim> &representative_point = representative_points[i];
           const Tensor <1,dim> g = this->get_gravity_model().gravity_vector(representative_point);
 
           in.position[0] = representative_point;
@@ -151,45 +250,102 @@ namespace aspect
           else
             in.pressure_gradient[0] = Tensor <1,dim> ();
 
-          if (reference_composition == initial_composition)
-            for (unsigned int c=0; c<this->n_compositional_fields(); ++c)
-              in.composition[0][c] = initial_composition_manager->initial_composition(representative_point, c);
-          else if (reference_composition == reference_function)
-            {
-              const double depth = this->get_geometry_model().depth(representative_point);
-              const Point<1> p(depth);
-              for (unsigned int c=0; c<this->n_compositional_fields(); ++c)
-                in.composition[0][c] = composition_function->value(p, c);
-            }
-          else
-            AssertThrow(false,ExcNotImplemented());
+          for (unsigned int c=0; c<this->n_compositional_fields(); ++c)
+            in.composition[0][c] = compositions[i][c];
 
           this->get_material_model().evaluate(in, out);
 
           densities[i] = out.densities[0];
         }
+    }
 
-      if (gravity_direction == 1 && this->get_surface_pressure() >= 0)
-        {
-          Assert (*std::min_element (pressures.begin(), pressures.end()) >=
-                  -std::numeric_limits<double>::epsilon() * pressures.size(),
-                  ExcMessage("Adiabatic ComputeProfile encountered a negative pressure of "
-                             + dealii::Utilities::to_string(*std::min_element (pressures.begin(), pressures.end()))));
-        }
-      else if (gravity_direction == -1 && this->get_surface_pressure() <= 0)
-        {
-          Assert (*std::max_element (pressures.begin(), pressures.end()) <=
-                  std::numeric_limits<double>::epsilon() * pressures.size(),
-                  ExcMessage("Adiabatic ComputeProfile encountered a positive pressure of "
-                             + dealii::Utilities::to_string(*std::max_element (pressures.begin(), pressures.end()))));
-        }
 
-      Assert (*std::min_element (temperatures.begin(), temperatures.end()) >=
-              -std::numeric_limits<double>::epsilon() * temperatures.size(),
-              ExcMessage("Adiabatic ComputeProfile encountered a negative temperature."));
 
+    template <int dim>
+    void
+    ComputeProfile<dim>::compute_profile_runge_kutta (const int gravity_direction)
+    {
+      MaterialModel::MaterialModelInputs<dim> in(1, this->n_compositional_fields());
+      MaterialModel::MaterialModelOutputs<dim> out(1, this->n_compositional_fields());
+
+      in.requested_properties = MaterialModel::MaterialProperties::equation_of_state_properties;
+      in.velocity[0] = Tensor <1,dim> ();
 
-      initialized = true;
+      // The Runge-Kutta stages evaluate the material model at the points
+      // of the profile and halfway between them. Compute the composition
+      // for all of these points at once. Point k is located at depth
+      // k*delta_z/2.
+      const unsigned int n_evaluation_points = 2*n_points-1;
+      std::vector<Point<dim>> representative_points (n_evaluation_points);
+      for (unsigned int k=0; k<n_evaluation_points; ++k)
+        representative_points[k] = this->get_geometry_model().representative_point
+                                   (static_cast<double>(k)/static_cast<double>(n_evaluation_points-1)*this->get_geometry_model().maximal_depth());
+
+      const std::vector<std::vector<double>> compositions = compute_reference_compositions(representative_points);
+
+      // The right hand side of the hydrostatic equations
+      //   p'(z) = rho(p,T) |g|
+      //   T'(z) = alpha |g| T / C_p
+      // at evaluation point k. The pressure gradient input of the material
+      // model is approximated by the most recently computed pressure
+      // derivative.
+      double last_dp_dz = 0.0;
+      const auto right_hand_side = [&](const unsigned int k,
+                                       const double pressure,
+                                       const double temperature) -> std::array<double,2>
+      {
+        const Point<dim> &representative_point = representative_points[k];
+        const Tensor <1,dim> g = this->get_gravity_model().gravity_vector(representative_point);
+        const double gravity = gravity_direction * g.norm();
+
+        in.position[0] = representative_point;
+        in.temperature[0] = temperature;
+        in.pressure[0] = pressure;
+        in.pressure_gradient[0] = g/(g.norm() != 0.0 ? g.norm() : 1.0) * last_dp_dz;
+        for (unsigned int c=0; c<this->n_compositional_fields(); ++c)
+          in.composition[0][c] = compositions[k][c];
+
+        this->get_material_model().evaluate(in, out);
+
+        // Handle the case that cp is zero (happens in simple Stokes test problems like sol_cx). By setting
+        // 1/cp = 0.0 we will have a constant temperature profile with depth.
+        const double one_over_cp = (out.specific_heat[0]>0.0) ? 1.0/out.specific_heat[0] : 0.0;
+
+        last_dp_dz = out.densities[0] * gravity;
+        return {{last_dp_dz,
+                 (this->include_adiabatic_heating())
+                 ?
+                 out.thermal_expansion_coefficients[0] * gravity * temperature * one_over_cp
+                 :
+                 0.0
+                }};
+      };
+
+      pressures[0] = surface_pressure;
+      temperatures[0] = surface_temperature;
+
+      // integrate downward using the classical fourth order Runge-Kutta method
+      for (unsigned int i=0; i<n_points; ++i)
+        {
+          const std::array<double,2> k1 = right_hand_side(2*i, pressures[i], temperatures[i]);
+          densities[i] = out.densities[0];
+
+          if (i == n_points-1)
+            break;
+
+          const std::array<double,2> k2 = right_hand_side(2*i+1,
+                                                          pressures[i] + 0.5 * delta_z * k1[0],
+                                                          temperatures[i] + 0.5 * delta_z * k1[1]);
+          const std::array<double,2> k3 = right_hand_side(2*i+1,
+                                                          pressures[i] + 0.5 * delta_z * k2[0],
+                                                          temperatures[i] + 0.5 * delta_z * k2[1]);
+          const std::array<double,2> k4 = right_hand_side(2*i+2,
+                                                          pressures[i] + delta_z * k3[0],
+                                                          temperatures[i] + delta_z * k3[1]);
+
+          pressures[i+1] = pressures[i] + delta_z / 6. * (k1[0] + 2.*k2[0] + 2.*k3[0] + k4[0]);
+          temperatures[i+1] = temperatures[i] + delta_z / 6. * (k1[1] + 2.*k2[1] + 2.*k3[1] + k4[1]);
+        }
     }
 
 
@@ -315,12 +471,29 @@ namespace aspect
                              "profile. The higher the number of points, the more accurate "
                              "the downward integration from the adiabatic surface "
                              "temperature will be.");
+          prm.declare_entry ("Integration method", "explicit Euler",
+                             Patterns::Selection("explicit Euler|Runge-Kutta"),
+                             "The method used to integrate the hydrostatic equations "
+                             "for pressure and temperature downward from the surface. "
+                             "'explicit Euler' evaluates the material model once per "
+                             "point of the profile and is first order accurate. "
+                             "'Runge-Kutta' uses the classical fourth order Runge-Kutta "
+                             "method, which evaluates the material model four times per "
+                             "point, but reaches the same accuracy with a much smaller "
+                             "'Number of points'.");
+          prm.declare_entry ("Compute profile on root process only", "false",
+                             Patterns::Bool(),
+                             "Whether to compute the profile only on the first process "
+                             "and send it to all other processes, instead of computing "
+                             "it on every process. This requires that evaluating the "
+                             "material model and the initial composition does not "
+                             "involve communication between processes.");
           prm.declare_entry ("Use surface condition function", "false",
                              Patterns::Bool(),
                              "Whether to use the 'Surface condition function' to determine surface "
                              "conditions, or the 'Adiabatic surface temperature' and 'Surface pressure' "
                              "parameters. If this is set to true the reference profile is updated "
-                             "every timestep. The function expression of the function should be "
+                             "every timestep in which the surface conditions change. The function expression of the function should be "
                              "independent of space, but can depend on time 't'. The function must "
                              "return two components, the first one being reference surface pressure, "
                              "the second one being reference surface temperature.");
@@ -376,6 +549,15 @@ namespace aspect
             }
 
           n_points = prm.get_integer ("Number of points");
+
+          if (prm.get ("Integration method") == "explicit Euler")
+            integration_method = explicit_euler;
+          else if (prm.get ("Integration method") == "Runge-Kutta")
+            integration_method = runge_kutta;
+          else
+            AssertThrow(false, ExcNotImplemented());
+
+          compute_on_root_process_only = prm.get_bool ("Compute profile on root process only");
           use_surface_condition_function = prm.get_bool("Use surface condition function");
           if (use_surface_condition_function)
             {
@@ -69,11 +69,20 @@ namespace aspect
     boundary_velocity (const types::boundary_id ,
                        const Point<dim> &position) const
     {
+      // Look up all velocity components at once, so that the position
+      // only needs to be located in the data grid a single time.
+      std::vector<unsigned int> components(dim);
+      std::vector<double> velocity_values;
+      for (unsigned int i = 0; i < dim; ++i)
+        components[i] = i;
+      Utilities::AsciiDataBoundary<dim>::get_data_components(*(boundary_ids.begin()),
+                                                             position,
+                                                             components,
+                                                             velocity_values);
+
       Tensor<1,dim> velocity;
       for (unsigned int i = 0; i < dim; ++i)
-        velocity[i] = Utilities::AsciiDataBoundary<dim>::get_data_component(*(boundary_ids.begin()),
-                                                                            position,
-                                                                            i);
+        velocity[i] = velocity_values[i];
       if (use_spherical_unit_vectors)
         velocity = Utilities::Coordinates::spherical_to_cartesian_vector(velocity, position);
 
@@ -26,6 +26,7 @@
 #include <deal.II/base/exceptions.h>
 #include <tuple>
 
+#include <algorithm>
 #include <list>
 
 
@@ -33,6 +34,21 @@ namespace aspect
 {
   namespace InitialComposition
   {
+    template <int dim>
+    void
+    Interface<dim>::initial_compositions (const std::vector<Point<dim>> &positions,
+                                          std::vector<std::vector<double>> &values) const
+    {
+      Assert (values.size() == positions.size(),
+              ExcDimensionMismatch (values.size(), positions.size()));
+
+      for (unsigned int q=0; q<positions.size(); ++q)
+        for (unsigned int c=0; c<values[q].size(); ++c)
+          values[q][c] = initial_composition(positions[q], c);
+    }
+
+
+
     // ------------------------------ Manager -----------------------------
     // ------------------------------ Deal with registering initial composition models and automating
     // ------------------------------ their setup and selection at run time
@@ -143,6 +159,33 @@ namespace aspect
     }
 
 
+
+    template <int dim>
+    void
+    Manager<dim>::initial_compositions (const std::vector<Point<dim>> &positions,
+                                        std::vector<std::vector<double>> &values) const
+    {
+      Assert (values.size() == positions.size(),
+              ExcDimensionMismatch (values.size(), positions.size()));
+
+      for (auto &point_values : values)
+        std::fill (point_values.begin(), point_values.end(), 0.0);
+
+      std::vector<std::vector<double>> plugin_values (values);
+      int i = 0;
+
+      for (const auto &initial_composition_object : this->plugin_objects)
+        {
+          initial_composition_object->initial_compositions(positions, plugin_values);
+
+          for (unsigned int q=0; q<positions.size(); ++q)
+            for (unsigned int c=0; c<values[q].size(); ++c)
+              values[q][c] = model_operators[i](values[q][c], plugin_values[q][c]);
+          ++i;
+        }
+    }
+
+
     template <int dim>
     const std::vector<std::string> &
     Manager<dim>::get_active_initial_composition_names () const
@@ -60,8 +60,10 @@ namespace aspect
       // The first data column corresponds to the slab depth and the second column to the slab thickness.
       // 'Slab depth' stands for the depth of the upper surface of the slab, 'Slab thickness'
       // for the vertical distance between upper and lower surface.
-      const double slab_depth     = slab_boundary.get_data_component(surface_boundary_id, position, 0);
-      const double slab_thickness = slab_boundary.get_data_component(surface_boundary_id, position, 1);
+      std::vector<double> slab_data;
+      slab_boundary.get_data_components(surface_boundary_id, position, {0, 1}, slab_data);
+      const double slab_depth     = slab_data[0];
+      const double slab_thickness = slab_data[1];
 
       // Return 0.0 if there is no slab in this location in the data. No slab is encoded in
       // the data file as a slab thickness of 0.0 and/or a depth larger than the depth of
@@ -25,6 +25,8 @@
 #include <aspect/geometry_model/interface.h>
 #include <aspect/citation_info.h>
 
+#include <deal.II/base/parallel.h>
+
 #include <world_builder/world.h>
 
 
@@ -58,6 +60,52 @@ namespace aspect
 
 
 
+    template <int dim>
+    void
+    WorldBuilder<dim>::
+    initial_compositions (const std::vector<Point<dim>> &positions,
+                          std::vector<std::vector<double>> &values) const
+    {
+      Assert (values.size() == positions.size(),
+              ExcDimensionMismatch (values.size(), positions.size()));
+
+      // Ask for all relevant compositions in a single query, so that the
+      // World Builder only has to determine once per point which features
+      // the point is located in.
+      std::vector<std::array<unsigned int,3>> properties;
+      std::vector<unsigned int> composition_indices;
+      for (unsigned int c=0; c<relevant_compositions.size(); ++c)
+        if (relevant_compositions[c] == true)
+          {
+            properties.push_back({{2, c, 0}});
+            composition_indices.push_back(c);
+          }
+
+      for (auto &point_values : values)
+        std::fill (point_values.begin(), point_values.end(), 0.0);
+
+      if (properties.size() == 0)
+        return;
+
+      parallel::apply_to_subranges (0U, static_cast<unsigned int>(positions.size()),
+                                    [&](const unsigned int begin, const unsigned int end)
+      {
+        for (unsigned int q=begin; q<end; ++q)
+          {
+            const std::vector<double> compositions
+              = world_builder->properties(Utilities::convert_point_to_array(positions[q]),
+                                          -this->get_geometry_model().height_above_reference_surface(positions[q]),
+                                          properties);
+
+            for (unsigned int i=0; i<composition_indices.size(); ++i)
+              values[q][composition_indices[i]] = compositions[i];
+          }
+      },
+      /* grainsize = */ 1);
+    }
+
+
+
     template <int dim>
     void
     WorldBuilder<dim>::declare_parameters (ParameterHandler &prm)
@@ -180,33 +180,54 @@ namespace aspect
         // mu = rho*Vs^2; K_s = rho*Vp^2 - 4./3.*mu
         // The Voigt average is an arithmetic volumetric average,
         // while the Reuss average is a harmonic volumetric average.
-        for (unsigned int i = 0; i < in.n_evaluation_points(); ++i)
+        const unsigned int n_points = in.n_evaluation_points();
+
+        if (material_lookup.size() == 1)
           {
-            if (material_lookup.size() == 1)
+            MaterialUtilities::Lookup::LookupOutputs lookup_outputs;
+            material_lookup[0]->evaluate(in.temperature, in.pressure,
+                                         MaterialUtilities::Lookup::LookupProperties::seismic_Vp
+                                         | MaterialUtilities::Lookup::LookupProperties::seismic_Vs,
+                                         lookup_outputs);
+
+            for (unsigned int i = 0; i < n_points; ++i)
               {
-                seismic_out->vs[i] = material_lookup[0]->seismic_Vs(in.temperature[i],in.pressure[i]);
-                seismic_out->vp[i] = material_lookup[0]->seismic_Vp(in.temperature[i],in.pressure[i]);
+                seismic_out->vs[i] = lookup_outputs.seismic_Vs[i];
+                seismic_out->vp[i] = lookup_outputs.seismic_Vp[i];
               }
-            else
+          }
+        else
+          {
+            std::vector<double> k_voigt(n_points, 0.);
+            std::vector<double> mu_voigt(n_points, 0.);
+            std::vector<double> invk_reuss(n_points, 0.);
+            std::vector<double> invmu_reuss(n_points, 0.);
+
+            MaterialUtilities::Lookup::LookupOutputs lookup_outputs;
+            for (unsigned int j = 0; j < material_lookup.size(); ++j)
               {
-                double k_voigt = 0.;
-                double mu_voigt = 0.;
-                double invk_reuss = 0.;
-                double invmu_reuss = 0.;
+                material_lookup[j]->evaluate(in.temperature, in.pressure,
+                                             MaterialUtilities::Lookup::LookupProperties::density
+                                             | MaterialUtilities::Lookup::LookupProperties::seismic_Vp
+                                             | MaterialUtilities::Lookup::LookupProperties::seismic_Vs,
+                                             lookup_outputs);
 
-                for (unsigned int j = 0; j < material_lookup.size(); ++j)
+                for (unsigned int i = 0; i < n_points; ++i)
                   {
-                    const double mu = material_lookup[j]->density(in.temperature[i],in.pressure[i])*std::pow(material_lookup[j]->seismic_Vs(in.temperature[i],in.pressure[i]), 2.);
-                    const double k =  material_lookup[j]->density(in.temperature[i],in.pressure[i])*std::pow(material_lookup[j]->seismic_Vp(in.temperature[i],in.pressure[i]), 2.) - 4./3.*mu;
+                    const double mu = lookup_outputs.densities[i]*std::pow(lookup_outputs.seismic_Vs[i], 2.);
+                    const double k =  lookup_outputs.densities[i]*std::pow(lookup_outputs.seismic_Vp[i], 2.) - 4./3.*mu;
 
-                    k_voigt += volume_fractions[i][j] * k;
-                    mu_voigt += volume_fractions[i][j] * mu;
-                    invk_reuss += volume_fractions[i][j] / k;
-                    invmu_reuss += volume_fractions[i][j] / mu;
+                    k_voigt[i] += volume_fractions[i][j] * k;
+                    mu_voigt[i] += volume_fractions[i][j] * mu;
+                    invk_reuss[i] += volume_fractions[i][j] / k;
+                    invmu_reuss[i] += volume_fractions[i][j] / mu;
                   }
+              }
 
-                const double k_VRH = (k_voigt + 1./invk_reuss)/2.;
-                const double mu_VRH = (mu_voigt + 1./invmu_reuss)/2.;
+            for (unsigned int i = 0; i < n_points; ++i)
+              {
+                const double k_VRH = (k_voigt[i] + 1./invk_reuss[i])/2.;
+                const double mu_VRH = (mu_voigt[i] + 1./invmu_reuss[i])/2.;
                 seismic_out->vp[i] = std::sqrt((k_VRH + 4./3.*mu_VRH)/composite_densities[i]);
                 seismic_out->vs[i] = std::sqrt(mu_VRH/composite_densities[i]);
               }
@@ -320,22 +341,32 @@ namespace aspect
       evaluate(const MaterialModel::MaterialModelInputs<dim> &in,
                std::vector<MaterialModel::EquationOfStateOutputs<dim>> &eos_outputs) const
       {
-        for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
+        // Only calculate the non-reactive specific heat and
+        // thermal expansivity if latent heat is to be ignored.
+        MaterialUtilities::Lookup::LookupProperties::Property requested_properties
+          = MaterialUtilities::Lookup::LookupProperties::density | MaterialUtilities::Lookup::LookupProperties::dRhodp;
+        if (!latent_heat)
+          requested_properties = requested_properties
+                                 | MaterialUtilities::Lookup::LookupProperties::thermal_expansivity
+                                 | MaterialUtilities::Lookup::LookupProperties::specific_heat;
+
+        // Look up all properties of one material at all evaluation points at once,
+        // so that each point is only located once in each table.
+        MaterialUtilities::Lookup::LookupOutputs lookup_outputs;
+        const unsigned int n_materials = (in.n_evaluation_points() > 0 ? eos_outputs[0].densities.size() : 0);
+        for (unsigned int j=0; j<n_materials; ++j)
           {
-            const double pressure = in.pressure[i];
-            const double temperature = in.temperature[i];
+            material_lookup[j]->evaluate(in.temperature, in.pressure, requested_properties, lookup_outputs);
 
-            for (unsigned int j=0; j<eos_outputs[i].densities.size(); ++j)
+            for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
               {
-                eos_outputs[i].densities[j] = material_lookup[j]->density(temperature, pressure);
-                eos_outputs[i].compressibilities[j] = material_lookup[j]->dRhodp(temperature, pressure)/eos_outputs[i].densities[j];
+                eos_outputs[i].densities[j] = lookup_outputs.densities[i];
+                eos_outputs[i].compressibilities[j] = lookup_outputs.dRhodp[i]/eos_outputs[i].densities[j];
 
-                // Only calculate the non-reactive specific heat and
-                // thermal expansivity if latent heat is to be ignored.
                 if (!latent_heat)
                   {
-                    eos_outputs[i].thermal_expansion_coefficients[j] = material_lookup[j]->thermal_expansivity(temperature, pressure);
-                    eos_outputs[i].specific_heat_capacities[j] = material_lookup[j]->specific_heat(temperature, pressure);
+                    eos_outputs[i].thermal_expansion_coefficients[j] = lookup_outputs.thermal_expansivities[i];
+                    eos_outputs[i].specific_heat_capacities[j] = lookup_outputs.specific_heats[i];
                   }
 
                 eos_outputs[i].entropy_derivative_pressure[j] = 0.;
@@ -392,22 +423,33 @@ namespace aspect
         if (in.current_cell.state() == IteratorState::valid)
           dH = enthalpy_derivatives(in);
 
-        for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
+        if ((in.current_cell.state() == IteratorState::valid)
+            && (dH[0].second > 0) && (dH[1].second > 0))
           {
-            // Use the adiabatic pressure instead of the real one,
-            // to stabilize against pressure oscillations in phase transitions
-            const double pressure = this->get_adiabatic_conditions().pressure(in.position[i]);
-
-            if ((in.current_cell.state() == IteratorState::valid)
-                && (dH[0].second > 0) && (dH[1].second > 0))
+            for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
               {
                 eos_outputs[i].thermal_expansion_coefficients[0] = (1 - average_density * dH[1].first) / average_temperature;
                 eos_outputs[i].specific_heat_capacities[0] = dH[0].first;
               }
-            else
+          }
+        else
+          {
+            // Use the adiabatic pressure instead of the real one,
+            // to stabilize against pressure oscillations in phase transitions
+            std::vector<double> pressures(in.n_evaluation_points());
+            for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
+              pressures[i] = this->get_adiabatic_conditions().pressure(in.position[i]);
+
+            MaterialUtilities::Lookup::LookupOutputs lookup_outputs;
+            material_lookup[0]->evaluate(in.temperature, pressures,
+                                         MaterialUtilities::Lookup::LookupProperties::dHdT
+                                         | MaterialUtilities::Lookup::LookupProperties::dHdp,
+                                         lookup_outputs);
+
+            for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
               {
-                eos_outputs[i].thermal_expansion_coefficients[0] = (1 - eos_outputs[i].densities[0] * material_lookup[0]->dHdp(in.temperature[i],pressure)) / in.temperature[i];
-                eos_outputs[i].specific_heat_capacities[0] = material_lookup[0]->dHdT(in.temperature[i],pressure);
+                eos_outputs[i].thermal_expansion_coefficients[0] = (1 - eos_outputs[i].densities[0] * lookup_outputs.dHdp[i]) / in.temperature[i];
+                eos_outputs[i].specific_heat_capacities[0] = lookup_outputs.dHdT[i];
               }
           }
       }
@@ -80,6 +80,34 @@ namespace aspect
       }
 
 
+
+      template <int dim>
+      double
+      CompositionalViscosityPrefactors<dim>::compute_logarithmic_pressure_derivative (const MaterialModel::MaterialModelInputs<dim> &in,
+                                                                                      const unsigned int composition_index,
+                                                                                      const unsigned int q,
+                                                                                      const ModifiedFlowLaws &modified_flow_laws) const
+      {
+        switch (viscosity_prefactor_scheme)
+          {
+            case none:
+              return 0.;
+            case hk04_olivine_hydration:
+            {
+              // The prefactor is the water fugacity to the power of r, and the
+              // logarithm of the water fugacity depends linearly on the pressure.
+              const double r = modified_flow_laws == diffusion
+                               ?
+                               -diffusion_water_fugacity_exponents[composition_index]
+                               :
+                               -dislocation_water_fugacity_exponents[composition_index];
+              return r * activation_volume_H2O / (constants::gas_constant * in.temperature[q]);
+            }
+          }
+        return 0.;
+      }
+
+
       template <int dim>
       void
       CompositionalViscosityPrefactors<dim>::declare_parameters (ParameterHandler &prm)
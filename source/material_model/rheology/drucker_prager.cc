@@ -181,6 +181,64 @@ namespace aspect
 
 
 
+      template <int dim>
+      double
+      DruckerPrager<dim>::compute_yield_stress_derivative (const double cohesion,
+                                                           const double angle_internal_friction,
+                                                           const double pressure,
+                                                           const double max_yield_stress) const
+      {
+        // Once the yield stress is capped, it no longer depends on the pressure.
+        if (compute_yield_stress(cohesion, angle_internal_friction, pressure, std::numeric_limits<double>::infinity())
+            >= max_yield_stress)
+          return 0.;
+
+        const double sin_phi = std::sin(angle_internal_friction);
+        const double stress_inv_part = 1. / (std::sqrt(3.0) * (3.0 + sin_phi));
+
+        return ( (dim==3)
+                 ?
+                 6.0 * sin_phi * stress_inv_part
+                 :
+                 sin_phi);
+      }
+
+
+
+      template <int dim>
+      std::array<double, 3>
+      DruckerPrager<dim>::compute_viscosity_derivatives (const double cohesion,
+                                                         const double angle_internal_friction,
+                                                         const double pressure,
+                                                         const double effective_strain_rate,
+                                                         const double max_yield_stress,
+                                                         const double non_yielding_viscosity) const
+      {
+        const double yield_stress = compute_yield_stress(cohesion, angle_internal_friction, pressure, max_yield_stress);
+        const double yield_stress_derivative = compute_yield_stress_derivative(cohesion, angle_internal_friction, pressure, max_yield_stress);
+
+        const double plastic_viscosity = yield_stress / (2. * effective_strain_rate);
+
+        // Without a damper, the apparent viscosity is
+        // eta_app = tau_yield / (2 * edot_eff).
+        if (!use_plastic_damper)
+          return {{yield_stress_derivative / (2. * effective_strain_rate),
+                   -plastic_viscosity / effective_strain_rate,
+                   0.
+                  }};
+
+        // With a damper, eta_app = b * (eta_d + tau_yield / (2 * edot_eff)),
+        // where b = 1 / (1 + eta_d / eta_ve), see compute_viscosity().
+        const double b = 1. / (1. + damper_viscosity / non_yielding_viscosity);
+
+        return {{b * yield_stress_derivative / (2. * effective_strain_rate),
+                 -b * plastic_viscosity / effective_strain_rate,
+                 (damper_viscosity + plastic_viscosity) * b * b * damper_viscosity / (non_yielding_viscosity * non_yielding_viscosity)
+                }};
+      }
+
+
+
       template <int dim>
       void
       DruckerPrager<dim>::declare_parameters (ParameterHandler &prm)
@@ -180,7 +180,8 @@ namespace aspect
                                                   const double temperature,
                                                   const unsigned int composition,
                                                   const std::vector<double> &phase_function_values,
-                                                  const std::vector<unsigned int> &n_phase_transitions_per_composition) const
+                                                  const std::vector<unsigned int> &n_phase_transitions_per_composition,
+                                                  bool *stress_cutoff_applied) const
       {
         /**
          * A generalized Peierls creep formulation. The Peierls creep expression
@@ -203,11 +204,17 @@ namespace aspect
         // on stress will be triggered if the input strain rate is smaller.
         const double log_strain_rate = std::log(strain_rate);
 
+        if (stress_cutoff_applied != nullptr)
+          *stress_cutoff_applied = false;
+
         if (apply_strict_cutoff)
           {
             const std::pair<double, double> log_edot_and_deriv = compute_exact_log_strain_rate_and_derivative(std::log(p.stress_cutoff), pressure, temperature, p);
             if (log_strain_rate < log_edot_and_deriv.first)
               {
+                if (stress_cutoff_applied != nullptr)
+                  *stress_cutoff_applied = true;
+
                 double viscosity = 0.5 * p.stress_cutoff / strain_rate;
                 return viscosity;
               }
@@ -273,10 +280,14 @@ namespace aspect
                                             const double temperature,
                                             const unsigned int composition,
                                             const std::vector<double> &phase_function_values,
-                                            const std::vector<unsigned int> &n_phase_transitions_per_composition) const
+                                            const std::vector<unsigned int> &n_phase_transitions_per_composition,
+                                            bool *stress_cutoff_applied) const
       {
         double viscosity = 0.0;
 
+        if (stress_cutoff_applied != nullptr)
+          *stress_cutoff_applied = false;
+
         switch (peierls_creep_flow_law)
           {
             case viscosity_approximation:
@@ -286,7 +297,8 @@ namespace aspect
             }
             case exact:
             {
-              viscosity = compute_exact_viscosity(strain_rate, pressure, temperature, composition, phase_function_values, n_phase_transitions_per_composition);
+              viscosity = compute_exact_viscosity(strain_rate, pressure, temperature, composition, phase_function_values, n_phase_transitions_per_composition,
+                                                  stress_cutoff_applied);
               break;
             }
             default:
@@ -100,10 +100,23 @@ namespace aspect
                                        const unsigned int i,
                                        const std::vector<double> &volume_fractions,
                                        const std::vector<double> &phase_function_values,
-                                       const std::vector<unsigned int> &n_phase_transitions_per_composition) const
+                                       const std::vector<unsigned int> &n_phase_transitions_per_composition,
+                                       const bool compute_derivatives) const
       {
         IsostrainViscosities output_parameters;
 
+        // Compute the derivatives of the viscosities alongside the viscosities themselves
+        // if requested and possible. We track the derivatives of the logarithm of each
+        // viscosity with respect to the strain rate invariant edot_ii and the pressure
+        // through all of the steps below, which allows us to combine them with simple
+        // product and harmonic averaging rules.
+        const bool compute_analytic_derivatives = compute_derivatives && analytic_viscosity_derivatives_available();
+        if (compute_analytic_derivatives)
+          {
+            output_parameters.composition_dviscosities_dstrain_rate_invariant.resize(volume_fractions.size(), numbers::signaling_nan<double>());
+            output_parameters.composition_dviscosities_dpressure.resize(volume_fractions.size(), numbers::signaling_nan<double>());
+          }
+
         // Initialize or fill variables used to calculate viscosities
         output_parameters.composition_yielding.resize(volume_fractions.size(), false);
         output_parameters.composition_viscosities.resize(volume_fractions.size(), numbers::signaling_nan<double>());
@@ -128,12 +141,16 @@ namespace aspect
                                                this->get_nonlinear_iteration() == 0);
 
         double edot_ii;
+        bool edot_ii_depends_on_strain_rate = false;
         if (use_reference_strainrate)
           edot_ii = ref_strain_rate;
         else
-          // Calculate the square root of the second moment invariant for the deviatoric strain rate tensor.
-          edot_ii = std::max(std::sqrt(std::max(-second_invariant(deviator(in.strain_rate[i])), 0.)),
-                             min_strain_rate);
+          {
+            // Calculate the square root of the second moment invariant for the deviatoric strain rate tensor.
+            const double unlimited_edot_ii = std::sqrt(std::max(-second_invariant(deviator(in.strain_rate[i])), 0.));
+            edot_ii = std::max(unlimited_edot_ii, min_strain_rate);
+            edot_ii_depends_on_strain_rate = (unlimited_edot_ii > min_strain_rate);
+          }
 
         // Calculate viscosities for each of the individual compositional phases
         for (unsigned int j=0; j < volume_fractions.size(); ++j)
@@ -141,6 +158,11 @@ namespace aspect
             // Step 1: viscous behavior
             double non_yielding_viscosity = numbers::signaling_nan<double>();
 
+            // The derivatives of the logarithm of the current viscosity with respect to
+            // edot_ii and the pressure, if compute_analytic_derivatives is true.
+            double dlog_viscosity_dstrain_rate = 0.;
+            double dlog_viscosity_dpressure = 0.;
+
             // Choice of activation volume depends on whether there is an adiabatic temperature
             // gradient used when calculating the viscosity. This allows the same activation volume
             // to be used in incompressible and compressible models.
@@ -158,6 +180,11 @@ namespace aspect
                           "), adiabatic_temperature_gradient_for_viscosity ("
                           + Utilities::to_string(adiabatic_temperature_gradient_for_viscosity) + ") and pressure ("
                           + Utilities::to_string(in.pressure[i]) + ")."));
+            const double dtemperature_for_viscosity_dpressure = (this->simulator_is_past_initialization())
+                                                                ?
+                                                                adiabatic_temperature_gradient_for_viscosity
+                                                                :
+                                                                0.;
             {
 
               // Step 1a: compute viscosity from diffusion creep law, at least if it is going to be used
@@ -169,6 +196,23 @@ namespace aspect
               if (use_adiabatic_pressure_in_creep)
                 pressure_for_creep = this->get_adiabatic_conditions().pressure(in.position[i]);
 
+              const double dpressure_for_creep_dpressure = (use_adiabatic_pressure_in_creep ? 0. : 1.);
+
+              // The pressure derivative of the logarithm of a creep viscosity with an
+              // Arrhenius term exp((E + P*V)/(nRT)), where both the pressure and
+              // the temperature used in the flow law may depend on the pressure.
+              const auto arrhenius_dlog_viscosity_dpressure = [&](const double activation_energy,
+                                                                  const double activation_volume,
+                                                                  const double stress_exponent)
+              {
+                return (activation_volume * dpressure_for_creep_dpressure
+                        / (constants::gas_constant * temperature_for_viscosity)
+                        -
+                        (activation_energy + pressure_for_creep * activation_volume) * dtemperature_for_viscosity_dpressure
+                        / (constants::gas_constant * temperature_for_viscosity * temperature_for_viscosity))
+                       / stress_exponent;
+              };
+
               const double viscosity_diffusion
                 = (viscous_flow_law != dislocation
                    ?
@@ -188,6 +232,44 @@ namespace aspect
                    :
                    numbers::signaling_nan<double>());
 
+              // Derivatives of the logarithms of the diffusion and dislocation creep viscosities,
+              // including the compositional viscosity prefactors applied below. Viscosities that
+              // have been capped at their maximum value do not depend on pressure or strain rate.
+              double dlog_viscosity_diffusion_dpressure = 0.;
+              double dlog_viscosity_dislocation_dstrain_rate = 0.;
+              double dlog_viscosity_dislocation_dpressure = 0.;
+              if (compute_analytic_derivatives)
+                {
+                  const double max_creep_viscosity = std::sqrt(std::numeric_limits<double>::max());
+
+                  if (viscous_flow_law != dislocation)
+                    {
+                      const DiffusionCreepParameters p = diffusion_creep.compute_creep_parameters(j,
+                                                                                                  phase_function_values,
+                                                                                                  n_phase_transitions_per_composition);
+                      if (viscosity_diffusion < max_creep_viscosity)
+                        dlog_viscosity_diffusion_dpressure = arrhenius_dlog_viscosity_dpressure(p.activation_energy, p.activation_volume, 1.);
+
+                      dlog_viscosity_diffusion_dpressure += compositional_viscosity_prefactors.compute_logarithmic_pressure_derivative(in, j, i,
+                                                            CompositionalViscosityPrefactors<dim>::ModifiedFlowLaws::diffusion);
+                    }
+
+                  if (viscous_flow_law != diffusion)
+                    {
+                      const DislocationCreepParameters p = dislocation_creep.compute_creep_parameters(j,
+                                                                                                      phase_function_values,
+                                                                                                      n_phase_transitions_per_composition);
+                      if (viscosity_dislocation < max_creep_viscosity)
+                        {
+                          dlog_viscosity_dislocation_dstrain_rate = (1. - p.stress_exponent) / (p.stress_exponent * edot_ii);
+                          dlog_viscosity_dislocation_dpressure = arrhenius_dlog_viscosity_dpressure(p.activation_energy, p.activation_volume, p.stress_exponent);
+                        }
+
+                      dlog_viscosity_dislocation_dpressure += compositional_viscosity_prefactors.compute_logarithmic_pressure_derivative(in, j, i,
+                                                              CompositionalViscosityPrefactors<dim>::ModifiedFlowLaws::dislocation);
+                    }
+                }
+
               // Step 1c: select which form of viscosity to use (diffusion, dislocation, fk, or composite), and apply
               // pre-exponential weakening, if required.
               switch (viscous_flow_law)
@@ -196,12 +278,15 @@ namespace aspect
                   {
                     non_yielding_viscosity = compositional_viscosity_prefactors.compute_viscosity(in, viscosity_diffusion, j, i, \
                                                                                                   CompositionalViscosityPrefactors<dim>::ModifiedFlowLaws::diffusion);
+                    dlog_viscosity_dpressure = dlog_viscosity_diffusion_dpressure;
                     break;
                   }
                   case dislocation:
                   {
                     non_yielding_viscosity = compositional_viscosity_prefactors.compute_viscosity(in, viscosity_dislocation, j, i, \
                                                                                                   CompositionalViscosityPrefactors<dim>::ModifiedFlowLaws::dislocation);
+                    dlog_viscosity_dstrain_rate = dlog_viscosity_dislocation_dstrain_rate;
+                    dlog_viscosity_dpressure = dlog_viscosity_dislocation_dpressure;
                     break;
                   }
                   case frank_kamenetskii:
@@ -220,6 +305,13 @@ namespace aspect
                                                                 CompositionalViscosityPrefactors<dim>::ModifiedFlowLaws::dislocation);
                     non_yielding_viscosity = (scaled_viscosity_diffusion * scaled_viscosity_dislocation)/
                                              (scaled_viscosity_diffusion + scaled_viscosity_dislocation);
+
+                    // For eta = a*b/(a+b), d(log eta) = (b * d(log a) + a * d(log b)) / (a+b).
+                    dlog_viscosity_dstrain_rate = scaled_viscosity_diffusion * dlog_viscosity_dislocation_dstrain_rate
+                                                  / (scaled_viscosity_diffusion + scaled_viscosity_dislocation);
+                    dlog_viscosity_dpressure = (scaled_viscosity_dislocation * dlog_viscosity_diffusion_dpressure
+                                                + scaled_viscosity_diffusion * dlog_viscosity_dislocation_dpressure)
+                                               / (scaled_viscosity_diffusion + scaled_viscosity_dislocation);
                     break;
                   }
                   default:
@@ -232,9 +324,64 @@ namespace aspect
               // Step 1d: compute the viscosity from the Peierls creep law and harmonically average with current viscosities
               if (use_peierls_creep)
                 {
+                  bool peierls_stress_cutoff_applied = false;
                   const double viscosity_peierls = peierls_creep->compute_viscosity(edot_ii, pressure_for_creep, temperature_for_viscosity, j,
                                                                                     phase_function_values,
-                                                                                    n_phase_transitions_per_composition);
+                                                                                    n_phase_transitions_per_composition,
+                                                                                    &peierls_stress_cutoff_applied);
+
+                  if (compute_analytic_derivatives)
+                    {
+                      double dlog_viscosity_peierls_dstrain_rate = 0.;
+                      double dlog_viscosity_peierls_dpressure = 0.;
+
+                      if (peierls_stress_cutoff_applied)
+                        {
+                          // The strict stress cutoff fixes the stress, so that
+                          // eta = 0.5 * stress_cutoff / edot_ii, which does not
+                          // depend on the pressure.
+                          dlog_viscosity_peierls_dstrain_rate = -1. / edot_ii;
+                        }
+                      else if (viscosity_peierls < std::sqrt(std::numeric_limits<double>::max()))
+                        {
+                          // The Peierls creep law defines the strain rate as a function of stress,
+                          // so we obtain the derivatives of the viscosity eta = stress / (2 edot_ii)
+                          // from the derivatives of the strain rate at the current stress.
+                          const PeierlsCreepParameters p = peierls_creep->compute_creep_parameters(j,
+                                                                                                   phase_function_values,
+                                                                                                   n_phase_transitions_per_composition);
+                          const double stress = 2. * viscosity_peierls * edot_ii;
+                          const std::pair<double, double> edot_and_deriv = peierls_creep->compute_strain_rate_and_derivative(stress,
+                                                                           pressure_for_creep,
+                                                                           temperature_for_viscosity,
+                                                                           p);
+                          const double dlog_edot_dlog_stress = stress * edot_and_deriv.second / edot_and_deriv.first;
+                          dlog_viscosity_peierls_dstrain_rate = (1. / dlog_edot_dlog_stress - 1.) / edot_ii;
+
+                          // The pressure dependence of the strain rate at a fixed stress involves
+                          // the pressure in several nested terms, so we approximate it by a
+                          // finite difference of the (closed form) strain rate expression.
+                          const double pressure_difference = std::fabs(in.pressure[i]) * 1e-7;
+                          if (pressure_difference > 0)
+                            {
+                              const double edot_pressure_difference =
+                                peierls_creep->compute_strain_rate_and_derivative(stress,
+                                                                                  pressure_for_creep + pressure_difference * dpressure_for_creep_dpressure,
+                                                                                  temperature_for_viscosity + pressure_difference * dtemperature_for_viscosity_dpressure,
+                                                                                  p).first;
+                              const double dlog_edot_dpressure = std::log(edot_pressure_difference / edot_and_deriv.first) / pressure_difference;
+                              dlog_viscosity_peierls_dpressure = -dlog_edot_dpressure / dlog_edot_dlog_stress;
+                            }
+                        }
+
+                      dlog_viscosity_dstrain_rate = (viscosity_peierls * dlog_viscosity_dstrain_rate
+                                                     + non_yielding_viscosity * dlog_viscosity_peierls_dstrain_rate)
+                                                    / (non_yielding_viscosity + viscosity_peierls);
+                      dlog_viscosity_dpressure = (viscosity_peierls * dlog_viscosity_dpressure
+                                                  + non_yielding_viscosity * dlog_viscosity_peierls_dpressure)
+                                                 / (non_yielding_viscosity + viscosity_peierls);
+                    }
+
                   non_yielding_viscosity = (non_yielding_viscosity * viscosity_peierls) / (non_yielding_viscosity + viscosity_peierls);
                 }
             }
@@ -323,6 +470,14 @@ namespace aspect
             if (allow_negative_pressures_in_plasticity == false)
               pressure_for_plasticity = std::max(pressure_for_plasticity,0.0);
 
+            const double dpressure_for_plasticity_dpressure = (use_adiabatic_pressure_in_plasticity
+                                                               ||
+                                                               (allow_negative_pressures_in_plasticity == false && in.pressure[i] < 0.)
+                                                               ?
+                                                               0.
+                                                               :
+                                                               1.);
+
             // Step 5a: calculate the Drucker-Prager yield stress
             const double yield_stress = drucker_prager_plasticity.compute_yield_stress(current_cohesion,
                                                                                        current_friction,
@@ -340,6 +495,27 @@ namespace aspect
                                                    * std::pow((effective_edot_ii/ref_strain_rate),
                                                               1./exponents_stress_limiter[j] - 1.0);
                   effective_viscosity = 1. / ( 1./viscosity_limiter + 1./non_yielding_viscosity);
+
+                  if (compute_analytic_derivatives)
+                    {
+                      const double dlog_viscosity_limiter_dstrain_rate = (1./exponents_stress_limiter[j] - 1.0) / edot_ii;
+                      const double dlog_viscosity_limiter_dpressure = (yield_stress > 0.
+                                                                       ?
+                                                                       drucker_prager_plasticity.compute_yield_stress_derivative(current_cohesion,
+                                                                           current_friction,
+                                                                           pressure_for_plasticity,
+                                                                           drucker_prager_parameters.max_yield_stress)
+                                                                       * dpressure_for_plasticity_dpressure / yield_stress
+                                                                       :
+                                                                       0.);
+
+                      dlog_viscosity_dstrain_rate = (non_yielding_viscosity * dlog_viscosity_limiter_dstrain_rate
+                                                     + viscosity_limiter * dlog_viscosity_dstrain_rate)
+                                                    / (viscosity_limiter + non_yielding_viscosity);
+                      dlog_viscosity_dpressure = (non_yielding_viscosity * dlog_viscosity_limiter_dpressure
+                                                  + viscosity_limiter * dlog_viscosity_dpressure)
+                                                 / (viscosity_limiter + non_yielding_viscosity);
+                    }
                   break;
                 }
                 case drucker_prager:
@@ -359,6 +535,24 @@ namespace aspect
                                                                                         drucker_prager_parameters.max_yield_stress,
                                                                                         non_yielding_viscosity);
                       output_parameters.composition_yielding[j] = true;
+
+                      if (compute_analytic_derivatives)
+                        {
+                          const std::array<double, 3> plastic_derivatives =
+                            drucker_prager_plasticity.compute_viscosity_derivatives(current_cohesion,
+                                                                                    current_friction,
+                                                                                    pressure_for_plasticity,
+                                                                                    effective_edot_ii,
+                                                                                    drucker_prager_parameters.max_yield_stress,
+                                                                                    non_yielding_viscosity);
+
+                          dlog_viscosity_dstrain_rate = (plastic_derivatives[1]
+                                                         + plastic_derivatives[2] * non_yielding_viscosity * dlog_viscosity_dstrain_rate)
+                                                        / effective_viscosity;
+                          dlog_viscosity_dpressure = (plastic_derivatives[0] * dpressure_for_plasticity_dpressure
+                                                      + plastic_derivatives[2] * non_yielding_viscosity * dlog_viscosity_dpressure)
+                                                     / effective_viscosity;
+                        }
                     }
                   break;
                 }
@@ -385,6 +579,29 @@ namespace aspect
                                                                MaterialModel::MaterialUtilities::PhaseUtilities::logarithmic
                                                              );
             output_parameters.composition_viscosities[j] = std::min(std::max(effective_viscosity, minimum_viscosity_for_composition), maximum_viscosity_for_composition);
+
+            // Step 7: convert the derivatives of the logarithm of the viscosity into derivatives
+            // of the viscosity. Viscosities that are limited by the minimum and maximum bounds
+            // do not depend on strain rate or pressure.
+            if (compute_analytic_derivatives)
+              {
+                const bool viscosity_is_limited = effective_viscosity < minimum_viscosity_for_composition
+                                                  ||
+                                                  effective_viscosity > maximum_viscosity_for_composition;
+
+                output_parameters.composition_dviscosities_dstrain_rate_invariant[j] =
+                  (viscosity_is_limited || !edot_ii_depends_on_strain_rate
+                   ?
+                   0.
+                   :
+                   output_parameters.composition_viscosities[j] * dlog_viscosity_dstrain_rate);
+                output_parameters.composition_dviscosities_dpressure[j] =
+                  (viscosity_is_limited
+                   ?
+                   0.
+                   :
+                   output_parameters.composition_viscosities[j] * dlog_viscosity_dpressure);
+              }
           }
         return output_parameters;
       }
@@ -396,7 +613,7 @@ namespace aspect
       ViscoPlastic<dim>::
       compute_viscosity_derivatives(const unsigned int i,
                                     const std::vector<double> &volume_fractions,
-                                    const std::vector<double> &composition_viscosities,
+                                    const IsostrainViscosities &isostrain_viscosities,
                                     const MaterialModel::MaterialModelInputs<dim> &in,
                                     MaterialModel::MaterialModelOutputs<dim> &out,
                                     const std::vector<double> &phase_function_values,
@@ -407,80 +624,45 @@ namespace aspect
 
         if (derivatives != nullptr)
           {
+            const std::vector<double> &composition_viscosities = isostrain_viscosities.composition_viscosities;
+
             // compute derivatives if necessary
             std::vector<SymmetricTensor<2,dim>> composition_viscosities_derivatives(volume_fractions.size());
             std::vector<double> composition_dviscosities_dpressure(volume_fractions.size());
 
-            const double finite_difference_accuracy = 1e-7;
-
-            // A new material model inputs variable that uses the strain rate and pressure difference.
-            MaterialModel::MaterialModelInputs<dim> in_derivatives = in;
-
             Assert(std::isfinite(in.strain_rate[i].norm()),
                    ExcMessage("Invalid strain_rate in the MaterialModelInputs. This is likely because it was "
                               "not filled by the caller."));
 
-            const SymmetricTensor<2,dim> deviatoric_strain_rate = deviator(in.strain_rate[i]);
-
-            // For each independent component, compute the derivative.
-            for (unsigned int component = 0; component < SymmetricTensor<2,dim>::n_independent_components; ++component)
+            if (isostrain_viscosities.composition_dviscosities_dpressure.size() == volume_fractions.size())
               {
-                const TableIndices<2> strain_rate_indices = SymmetricTensor<2,dim>::unrolled_to_component_indices (component);
-
-                const SymmetricTensor<2,dim> strain_rate_difference = deviatoric_strain_rate
-                                                                      + std::max(std::fabs(deviatoric_strain_rate[strain_rate_indices]), min_strain_rate)
-                                                                      * finite_difference_accuracy
-                                                                      * Utilities::nth_basis_for_symmetric_tensors<dim>(component);
-
-                in_derivatives.strain_rate[i] = strain_rate_difference;
-
-                std::vector<double> eta_component =
-                  calculate_isostrain_viscosities(in_derivatives, i, volume_fractions,
-                                                  phase_function_values, n_phase_transitions_per_composition).composition_viscosities;
-
-                // For each composition of the independent component, compute the derivative.
-                for (unsigned int composition_index = 0; composition_index < eta_component.size(); ++composition_index)
+                // The derivatives have been computed analytically alongside the viscosities.
+                // The viscosities only depend on the strain rate through the square root of the
+                // second moment invariant of the deviatoric strain rate, edot_ii, and
+                // d(edot_ii)/d(strain_rate) = deviator(strain_rate) / (2 * edot_ii).
+                const SymmetricTensor<2,dim> deviatoric_strain_rate = deviator(in.strain_rate[i]);
+                const double edot_ii = std::sqrt(std::max(-second_invariant(deviatoric_strain_rate), 0.));
+
+                for (unsigned int composition_index = 0; composition_index < volume_fractions.size(); ++composition_index)
                   {
-                    // compute the difference between the viscosity with and without the strain-rate difference.
-                    double viscosity_derivative = eta_component[composition_index] - composition_viscosities[composition_index];
-                    if (viscosity_derivative != 0)
-                      {
-                        // when the difference is non-zero, divide by the difference.
-                        viscosity_derivative /= std::max(std::fabs(strain_rate_difference[strain_rate_indices]), min_strain_rate)
-                                                * finite_difference_accuracy;
-                      }
-                    composition_viscosities_derivatives[composition_index][strain_rate_indices] = viscosity_derivative;
-                  }
-              }
-
-            // Now compute the derivative of the viscosity to the pressure
-            const double pressure_difference = in.pressure[i] + (std::fabs(in.pressure[i]) * finite_difference_accuracy);
-
-            in_derivatives.pressure[i] = pressure_difference;
+                    const double dviscosity_dstrain_rate_invariant
+                      = isostrain_viscosities.composition_dviscosities_dstrain_rate_invariant[composition_index];
 
-            // Modify the in_derivatives object again to take the original strain rate.
-            in_derivatives.strain_rate[i] = in.strain_rate[i];
+                    // The derivative with respect to edot_ii is zero whenever edot_ii
+                    // is limited by the minimum strain rate, so we never divide by zero here.
+                    if (dviscosity_dstrain_rate_invariant != 0)
+                      composition_viscosities_derivatives[composition_index] = dviscosity_dstrain_rate_invariant / (2. * edot_ii)
+                                                                               * deviatoric_strain_rate;
 
-            const std::vector<double> viscosity_difference =
-              calculate_isostrain_viscosities(in_derivatives, i, volume_fractions,
-                                              phase_function_values, n_phase_transitions_per_composition).composition_viscosities;
-
-            for (unsigned int composition_index = 0; composition_index < viscosity_difference.size(); ++composition_index)
-              {
-                double viscosity_derivative = viscosity_difference[composition_index] - composition_viscosities[composition_index];
-                if (viscosity_difference[composition_index] != 0)
-                  {
-                    if (in.pressure[i] != 0)
-                      {
-                        viscosity_derivative /= std::fabs(in.pressure[i]) * finite_difference_accuracy;
-                      }
-                    else
-                      {
-                        viscosity_derivative = 0;
-                      }
+                    composition_dviscosities_dpressure[composition_index]
+                      = isostrain_viscosities.composition_dviscosities_dpressure[composition_index];
                   }
-                composition_dviscosities_dpressure[composition_index] = viscosity_derivative;
               }
+            else
+              compute_finite_difference_viscosity_derivatives(i, volume_fractions, composition_viscosities, in,
+                                                              phase_function_values, n_phase_transitions_per_composition,
+                                                              composition_viscosities_derivatives,
+                                                              composition_dviscosities_dpressure);
 
             double viscosity_averaging_p = 0; // Geometric
             if (viscosity_averaging == MaterialUtilities::harmonic)
@@ -507,6 +689,110 @@ namespace aspect
 
 
 
+      template <int dim>
+      void
+      ViscoPlastic<dim>::
+      compute_finite_difference_viscosity_derivatives(const unsigned int i,
+                                                      const std::vector<double> &volume_fractions,
+                                                      const std::vector<double> &composition_viscosities,
+                                                      const MaterialModel::MaterialModelInputs<dim> &in,
+                                                      const std::vector<double> &phase_function_values,
+                                                      const std::vector<unsigned int> &n_phase_transitions_per_composition,
+                                                      std::vector<SymmetricTensor<2,dim>> &composition_viscosities_derivatives,
+                                                      std::vector<double> &composition_dviscosities_dpressure) const
+      {
+        const double finite_difference_accuracy = 1e-7;
+
+        // A new material model inputs variable that uses the strain rate and pressure difference.
+        MaterialModel::MaterialModelInputs<dim> in_derivatives = in;
+
+        const SymmetricTensor<2,dim> deviatoric_strain_rate = deviator(in.strain_rate[i]);
+
+        // For each independent component, compute the derivative.
+        for (unsigned int component = 0; component < SymmetricTensor<2,dim>::n_independent_components; ++component)
+          {
+            const TableIndices<2> strain_rate_indices = SymmetricTensor<2,dim>::unrolled_to_component_indices (component);
+
+            const SymmetricTensor<2,dim> strain_rate_difference = deviatoric_strain_rate
+                                                                  + std::max(std::fabs(deviatoric_strain_rate[strain_rate_indices]), min_strain_rate)
+                                                                  * finite_difference_accuracy
+                                                                  * Utilities::nth_basis_for_symmetric_tensors<dim>(component);
+
+            in_derivatives.strain_rate[i] = strain_rate_difference;
+
+            std::vector<double> eta_component =
+              calculate_isostrain_viscosities(in_derivatives, i, volume_fractions,
+                                              phase_function_values, n_phase_transitions_per_composition).composition_viscosities;
+
+            // For each composition of the independent component, compute the derivative.
+            for (unsigned int composition_index = 0; composition_index < eta_component.size(); ++composition_index)
+              {
+                // compute the difference between the viscosity with and without the strain-rate difference.
+                double viscosity_derivative = eta_component[composition_index] - composition_viscosities[composition_index];
+                if (viscosity_derivative != 0)
+                  {
+                    // when the difference is non-zero, divide by the difference.
+                    viscosity_derivative /= std::max(std::fabs(strain_rate_difference[strain_rate_indices]), min_strain_rate)
+                                            * finite_difference_accuracy;
+                  }
+                composition_viscosities_derivatives[composition_index][strain_rate_indices] = viscosity_derivative;
+              }
+          }
+
+        // Now compute the derivative of the viscosity to the pressure
+        const double pressure_difference = in.pressure[i] + (std::fabs(in.pressure[i]) * finite_difference_accuracy);
+
+        in_derivatives.pressure[i] = pressure_difference;
+
+        // Modify the in_derivatives object again to take the original strain rate.
+        in_derivatives.strain_rate[i] = in.strain_rate[i];
+
+        const std::vector<double> viscosity_difference =
+          calculate_isostrain_viscosities(in_derivatives, i, volume_fractions,
+                                          phase_function_values, n_phase_transitions_per_composition).composition_viscosities;
+
+        for (unsigned int composition_index = 0; composition_index < viscosity_difference.size(); ++composition_index)
+          {
+            double viscosity_derivative = viscosity_difference[composition_index] - composition_viscosities[composition_index];
+            if (viscosity_difference[composition_index] != 0)
+              {
+                if (in.pressure[i] != 0)
+                  {
+                    viscosity_derivative /= std::fabs(in.pressure[i]) * finite_difference_accuracy;
+                  }
+                else
+                  {
+                    viscosity_derivative = 0;
+                  }
+              }
+            composition_dviscosities_dpressure[composition_index] = viscosity_derivative;
+          }
+      }
+
+
+
+      template <int dim>
+      bool
+      ViscoPlastic<dim>::
+      analytic_viscosity_derivatives_available() const
+      {
+        // With elasticity, the effective strain rate does not only depend on the
+        // invariant of the strain rate, and the parameters of the Frank-Kamenetskii
+        // rheology, dynamic friction, and temperature activated strain softening
+        // are not accessible here. Use finite differences in these cases.
+        return this->get_parameters().enable_elasticity == false
+               &&
+               viscous_flow_law != frank_kamenetskii
+               &&
+               friction_models.get_friction_mechanism() != dynamic_friction
+               &&
+               (strain_rheology.use_temperature_activated_strain_softening == false
+                ||
+                adiabatic_temperature_gradient_for_viscosity == 0.);
+      }
+
+
+
       template <int dim>
       ComponentMask
       ViscoPlastic<dim>::
@@ -140,6 +140,10 @@ namespace aspect
         = std::make_unique<internal::RadialViscosityLookup>(data_directory+radial_viscosity_file_name,
                                                             this->get_mpi_communicator());
       average_temperature.resize(n_lateral_slices);
+
+      if (use_lateral_average_temperature)
+        this->get_lateral_averaging().register_lateral_averages(n_lateral_slices,
+                                                                std::vector<std::string>(1,"temperature"));
     }
 
 
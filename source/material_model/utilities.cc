@@ -45,6 +45,19 @@ namespace aspect
     {
       namespace Lookup
       {
+        LookupOutputs::LookupOutputs (const unsigned int n_points)
+          :
+          densities(n_points, numbers::signaling_nan<double>()),
+          thermal_expansivities(n_points, numbers::signaling_nan<double>()),
+          specific_heats(n_points, numbers::signaling_nan<double>()),
+          seismic_Vp(n_points, numbers::signaling_nan<double>()),
+          seismic_Vs(n_points, numbers::signaling_nan<double>()),
+          enthalpies(n_points, numbers::signaling_nan<double>()),
+          dRhodp(n_points, numbers::signaling_nan<double>()),
+          dHdT(n_points, numbers::signaling_nan<double>()),
+          dHdp(n_points, numbers::signaling_nan<double>())
+        {}
+
         double
         MaterialLookup::specific_heat(const double temperature,
                                       const double pressure) const
@@ -223,17 +236,114 @@ namespace aspect
           return dominant_phase_names;
         }
 
+        void
+        MaterialLookup::evaluate (const std::vector<double> &temperatures,
+                                  const std::vector<double> &pressures,
+                                  const LookupProperties::Property requested_properties,
+                                  LookupOutputs &outputs) const
+        {
+          Assert(temperatures.size() == pressures.size(), ExcInternalError());
+          const unsigned int n_points = temperatures.size();
+
+          const auto requests = [&](const LookupProperties::Property property)
+          {
+            return (requested_properties & property) != 0;
+          };
+
+          const auto resize_if_requested = [&](const LookupProperties::Property property,
+                                               std::vector<double> &output)
+          {
+            if (requests(property))
+              output.resize(n_points);
+          };
+
+          resize_if_requested(LookupProperties::density, outputs.densities);
+          resize_if_requested(LookupProperties::thermal_expansivity, outputs.thermal_expansivities);
+          resize_if_requested(LookupProperties::specific_heat, outputs.specific_heats);
+          resize_if_requested(LookupProperties::seismic_Vp, outputs.seismic_Vp);
+          resize_if_requested(LookupProperties::seismic_Vs, outputs.seismic_Vs);
+          resize_if_requested(LookupProperties::enthalpy, outputs.enthalpies);
+          resize_if_requested(LookupProperties::dRhodp, outputs.dRhodp);
+          resize_if_requested(LookupProperties::dHdT, outputs.dHdT);
+          resize_if_requested(LookupProperties::dHdp, outputs.dHdp);
+
+          const bool needs_pressure_difference = requests(LookupProperties::dRhodp) || requests(LookupProperties::dHdp);
+          const bool needs_temperature_difference = requests(LookupProperties::dHdT);
+
+          for (unsigned int q=0; q<n_points; ++q)
+            {
+              const TablePosition position = locate(temperatures[q], pressures[q]);
+
+              // Properties that are computed from the same table at the same position
+              // share the table value.
+              const double rho = ((requests(LookupProperties::density) || requests(LookupProperties::dRhodp))
+                                  ?
+                                  value(position, density_values, interpolation)
+                                  :
+                                  numbers::signaling_nan<double>());
+              const double h = ((requests(LookupProperties::dHdT) || requests(LookupProperties::dHdp))
+                                ?
+                                value(position, enthalpy_values, interpolation)
+                                :
+                                numbers::signaling_nan<double>());
+
+              if (requests(LookupProperties::density))
+                outputs.densities[q] = rho;
+              if (requests(LookupProperties::thermal_expansivity))
+                outputs.thermal_expansivities[q] = value(position, thermal_expansivity_values, interpolation);
+              if (requests(LookupProperties::specific_heat))
+                outputs.specific_heats[q] = value(position, specific_heat_values, interpolation);
+              if (requests(LookupProperties::seismic_Vp))
+                outputs.seismic_Vp[q] = value(position, vp_values, false);
+              if (requests(LookupProperties::seismic_Vs))
+                outputs.seismic_Vs[q] = value(position, vs_values, false);
+              if (requests(LookupProperties::enthalpy))
+                outputs.enthalpies[q] = value(position, enthalpy_values, true);
+
+              if (needs_pressure_difference)
+                {
+                  const TablePosition position_dp = locate(temperatures[q], pressures[q]+delta_press);
+
+                  if (requests(LookupProperties::dRhodp))
+                    outputs.dRhodp[q] = (value(position_dp, density_values, interpolation) - rho) / delta_press;
+                  if (requests(LookupProperties::dHdp))
+                    outputs.dHdp[q] = (value(position_dp, enthalpy_values, interpolation) - h) / delta_press;
+                }
+
+              if (needs_temperature_difference)
+                {
+                  const TablePosition position_dT = locate(temperatures[q]+delta_temp, pressures[q]);
+                  outputs.dHdT[q] = (value(position_dT, enthalpy_values, interpolation) - h) / delta_temp;
+                }
+            }
+        }
+
+        MaterialLookup::TablePosition
+        MaterialLookup::locate (const double temperature,
+                                const double pressure) const
+        {
+          const double nT = get_nT(temperature);
+          const double np = get_np(pressure);
+
+          TablePosition position;
+          position.inT = static_cast<unsigned int>(nT);
+          position.inp = static_cast<unsigned int>(np);
+
+          // compute the coordinates of this point in the
+          // reference cell between the data points
+          position.xi = nT-position.inT;
+          position.eta = np-position.inp;
+
+          return position;
+        }
+
         double
-        MaterialLookup::value (const double temperature,
-                               const double pressure,
+        MaterialLookup::value (const TablePosition &position,
                                const Table<2, double> &values,
                                const bool interpol) const
         {
-          const double nT = get_nT(temperature);
-          const unsigned int inT = static_cast<unsigned int>(nT);
-
-          const double np = get_np(pressure);
-          const unsigned int inp = static_cast<unsigned int>(np);
+          const unsigned int inT = position.inT;
+          const unsigned int inp = position.inp;
 
           Assert(inT<values.n_rows(), ExcMessage("Attempting to look up a temperature value with index greater than the number of rows."));
           Assert(inp<values.n_cols(), ExcMessage("Attempting to look up a pressure value with index greater than the number of columns."));
@@ -242,10 +352,8 @@ namespace aspect
             return values[inT][inp];
           else
             {
-              // compute the coordinates of this point in the
-              // reference cell between the data points
-              const double xi = nT-inT;
-              const double eta = np-inp;
+              const double xi = position.xi;
+              const double eta = position.eta;
 
               Assert ((0 <= xi) && (xi <= 1), ExcInternalError());
               Assert ((0 <= eta) && (eta <= 1), ExcInternalError());
@@ -258,6 +366,15 @@ namespace aspect
             }
         }
 
+        double
+        MaterialLookup::value (const double temperature,
+                               const double pressure,
+                               const Table<2, double> &values,
+                               const bool interpol) const
+        {
+          return value(locate(temperature, pressure), values, interpol);
+        }
+
         unsigned int
         MaterialLookup::value (const double temperature,
                                const double pressure,
@@ -21,41 +21,44 @@
 
 #include <aspect/mesh_refinement/composition.h>
 
-#include <deal.II/base/quadrature_lib.h>
-#include <deal.II/numerics/error_estimator.h>
-
 namespace aspect
 {
   namespace MeshRefinement
   {
     template <int dim>
-    void
-    Composition<dim>::execute(Vector<float> &indicators) const
+    std::vector<ComponentMask>
+    Composition<dim>::get_component_masks() const
     {
       AssertThrow (this->n_compositional_fields() >= 1,
                    ExcMessage ("This refinement criterion cannot be used when no "
                                "compositional fields are active!"));
-      indicators = 0;
-      Vector<float> this_indicator (indicators.size());
 
-      const Quadrature<dim-1> &quadrature = this->introspection().face_quadratures.compositional_fields;
+      // one indicator per field, so that they can be scaled individually
+      return this->introspection().component_masks.compositional_fields;
+    }
+
+
+
+    template <int dim>
+    const Quadrature<dim-1> &
+    Composition<dim>::get_face_quadrature() const
+    {
+      return this->introspection().face_quadratures.compositional_fields;
+    }
 
+
+
+    template <int dim>
+    void
+    Composition<dim>::combine_indicators(const std::vector<Vector<float>> &indicators_per_mask,
+                                         Vector<float> &indicators) const
+    {
+      AssertDimension (indicators_per_mask.size(), this->n_compositional_fields());
+
+      indicators = 0;
       for (unsigned int c=0; c<this->n_compositional_fields(); ++c)
-        {
-          this_indicator = 0;
-          KellyErrorEstimator<dim>::estimate (this->get_mapping(),
-                                              this->get_dof_handler(),
-                                              quadrature,
-                                              std::map<types::boundary_id,const Function<dim>*>(),
-                                              this->get_solution(),
-                                              this_indicator,
-                                              this->introspection().component_masks.compositional_fields[c],
-                                              nullptr,
-                                              0,
-                                              this->get_triangulation().locally_owned_subdomain());
-          // compute indicators += c*this_indicator:
-          indicators.add(composition_scaling_factors[c], this_indicator);
-        }
+        // compute indicators += scaling factor * indicator of field c:
+        indicators.add(composition_scaling_factors[c], indicators_per_mask[c]);
     }
 
     template <int dim>
@@ -22,6 +22,15 @@
 #include <aspect/mesh_refinement/interface.h>
 #include <aspect/utilities.h>
 
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_extractors.h>
+#include <deal.II/grid/filtered_iterator.h>
+#include <deal.II/numerics/derivative_approximation.h>
+
+#include <algorithm>
+#include <cmath>
 #include <typeinfo>
 
 
@@ -47,6 +56,575 @@ namespace aspect
 
 
 
+// ------------------------------ FieldGradientInterface -----------------------------
+
+    template <int dim>
+    void
+    FieldGradientInterface<dim>::execute (Vector<float> &error_indicators) const
+    {
+      compute_field_gradient_indicators<dim> (*this,
+                                               std::vector<const FieldGradientInterface<dim> *> (1, this),
+                                               std::vector<Vector<float> *> (1, &error_indicators));
+    }
+
+
+
+    template <int dim>
+    double
+    FieldGradientInterface<dim>::get_cell_diameter_power () const
+    {
+      return 1.0 + dim/2.0;
+    }
+
+
+
+    namespace internal
+    {
+      /**
+       * Scratch object for the parallel loop over all cells in
+       * compute_field_gradient_indicators().
+       */
+      template <int dim>
+      struct FieldGradientScratch
+      {
+        FieldGradientScratch (const Mapping<dim> &mapping,
+                              const FiniteElement<dim> &fe,
+                              const Quadrature<dim> &quadrature,
+                              const unsigned int n_compositional_fields,
+                              const MaterialModel::MaterialProperties::Property requested_properties)
+          :
+          fe_values (mapping,
+                     fe,
+                     quadrature,
+                     update_quadrature_points | update_values | update_gradients),
+          material_model_inputs (quadrature.size(), n_compositional_fields),
+          material_model_outputs (quadrature.size(), n_compositional_fields)
+        {
+          material_model_inputs.requested_properties = requested_properties;
+        }
+
+        FieldGradientScratch (const FieldGradientScratch &scratch)
+          :
+          fe_values (scratch.fe_values.get_mapping(),
+                     scratch.fe_values.get_fe(),
+                     scratch.fe_values.get_quadrature(),
+                     scratch.fe_values.get_update_flags()),
+          material_model_inputs (scratch.material_model_inputs),
+          material_model_outputs (scratch.material_model_outputs)
+        {}
+
+        FEValues<dim> fe_values;
+        MaterialModel::MaterialModelInputs<dim> material_model_inputs;
+        MaterialModel::MaterialModelOutputs<dim> material_model_outputs;
+      };
+
+
+
+      /**
+       * Copy object for the parallel loop over all cells in
+       * compute_field_gradient_indicators(). It stores the values of the
+       * field of every criterion at the temperature dofs of one cell.
+       */
+      struct FieldGradientCopyData
+      {
+        FieldGradientCopyData (const unsigned int dofs_per_cell,
+                               const unsigned int n_criteria,
+                               const unsigned int n_support_points)
+          :
+          local_dof_indices (dofs_per_cell),
+          field_values (n_criteria, std::vector<double>(n_support_points))
+        {}
+
+        std::vector<types::global_dof_index> local_dof_indices;
+        std::vector<std::vector<double>> field_values;
+      };
+    }
+
+
+
+    template <int dim>
+    void
+    compute_field_gradient_indicators (const SimulatorAccess<dim> &simulator_access,
+                                       const std::vector<const FieldGradientInterface<dim> *> &criteria,
+                                       const std::vector<Vector<float> *> &error_indicators)
+    {
+      Assert (criteria.size() == error_indicators.size(),
+              ExcDimensionMismatch (criteria.size(), error_indicators.size()));
+
+      const Introspection<dim> &introspection = simulator_access.introspection();
+      const FiniteElement<dim> &fe = simulator_access.get_fe();
+      const FiniteElement<dim> &temperature_fe = fe.base_element(introspection.base_elements.temperature);
+
+      // the material model only needs to compute what at least one of
+      // the criteria asks for
+      MaterialModel::MaterialProperties::Property requested_properties
+        = MaterialModel::MaterialProperties::uninitialized;
+      for (const auto &criterion : criteria)
+        requested_properties = requested_properties | criterion->get_needed_material_properties();
+
+      // create vectors in which we set the temperature block to be a finite
+      // element interpolation of the field of each criterion. we do so by
+      // setting up a quadrature formula with the temperature unit support
+      // points, then looping over these points, compute the output quantity
+      // at them, and writing the result into the output vector in the same
+      // order (because quadrature points and temperature dofs are, by design
+      // of the quadrature formula, numbered in the same way)
+      std::vector<LinearAlgebra::BlockVector> vec_distributed (criteria.size(),
+                                                               LinearAlgebra::BlockVector (introspection.index_sets.system_partitioning,
+                                                                   simulator_access.get_mpi_communicator()));
+
+      const Quadrature<dim> quadrature(temperature_fe.get_unit_support_points());
+
+      auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                        internal::FieldGradientScratch<dim> &scratch,
+                        internal::FieldGradientCopyData &data)
+      {
+        scratch.fe_values.reinit(cell);
+        scratch.material_model_inputs.reinit(scratch.fe_values,
+                                             cell,
+                                             introspection,
+                                             simulator_access.get_solution());
+
+        if (requested_properties != MaterialModel::MaterialProperties::uninitialized)
+          simulator_access.get_material_model().evaluate(scratch.material_model_inputs,
+                                                         scratch.material_model_outputs);
+
+        for (unsigned int c=0; c<criteria.size(); ++c)
+          criteria[c]->compute_field_values(scratch.material_model_inputs,
+                                            scratch.material_model_outputs,
+                                            data.field_values[c]);
+
+        cell->get_dof_indices (data.local_dof_indices);
+      };
+
+      // writing into the distributed vectors is not thread-safe, so
+      // this happens in the copier
+      auto copier = [&](const internal::FieldGradientCopyData &data)
+      {
+        for (unsigned int i=0; i<temperature_fe.dofs_per_cell; ++i)
+          {
+            const unsigned int system_local_dof
+              = fe.component_to_system_index(introspection.component_indices.temperature,
+                                             /*dof index within component=*/i);
+
+            for (unsigned int c=0; c<criteria.size(); ++c)
+              vec_distributed[c](data.local_dof_indices[system_local_dof])
+                = data.field_values[c][i];
+          }
+      };
+
+      using CellFilter = FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+
+      WorkStream::run (CellFilter (IteratorFilters::LocallyOwnedCell(),
+                                   simulator_access.get_dof_handler().begin_active()),
+                       CellFilter (IteratorFilters::LocallyOwnedCell(),
+                                   simulator_access.get_dof_handler().end()),
+                       worker,
+                       copier,
+                       internal::FieldGradientScratch<dim> (simulator_access.get_mapping(),
+                                                            fe,
+                                                            quadrature,
+                                                            simulator_access.n_compositional_fields(),
+                                                            requested_properties),
+                       internal::FieldGradientCopyData (fe.dofs_per_cell,
+                                                        criteria.size(),
+                                                        quadrature.size()));
+
+      // now create a vector with the requisite ghost elements
+      // and use it for estimating the gradients
+      LinearAlgebra::BlockVector vec (introspection.index_sets.system_partitioning,
+                                      introspection.index_sets.system_relevant_partitioning,
+                                      simulator_access.get_mpi_communicator());
+
+      for (unsigned int c=0; c<criteria.size(); ++c)
+        {
+          Vector<float> &indicators = *error_indicators[c];
+          indicators = 0;
+
+          vec_distributed[c].compress(VectorOperation::insert);
+          vec = vec_distributed[c];
+
+          DerivativeApproximation::approximate_gradient  (simulator_access.get_mapping(),
+                                                          simulator_access.get_dof_handler(),
+                                                          vec,
+                                                          indicators,
+                                                          introspection.component_indices.temperature);
+
+          // Scale gradient in each cell with the correct power of h. Otherwise,
+          // error indicators do not reduce when refined if there is a jump
+          // in the field. (note that the gradient itself scales like 1/h, so
+          // multiplying it with any factor h^s, s>1 will yield convergence
+          // of the error indicators to zero as h->0)
+          const double power = criteria[c]->get_cell_diameter_power();
+          for (const auto &cell : simulator_access.get_dof_handler().active_cell_iterators())
+            if (cell->is_locally_owned())
+              indicators(cell->active_cell_index()) *= std::pow(cell->diameter(), power);
+        }
+    }
+
+
+
+// ------------------------------ KellyInterface -----------------------------
+
+    template <int dim>
+    void
+    KellyInterface<dim>::execute (Vector<float> &error_indicators) const
+    {
+      compute_kelly_indicators<dim> (*this,
+                                     std::vector<const KellyInterface<dim> *> (1, this),
+                                     std::vector<Vector<float> *> (1, &error_indicators));
+    }
+
+
+
+    template <int dim>
+    void
+    KellyInterface<dim>::combine_indicators (const std::vector<Vector<float>> &indicators_per_mask,
+                                             Vector<float> &error_indicators) const
+    {
+      error_indicators = 0;
+      for (const auto &indicators : indicators_per_mask)
+        error_indicators += indicators;
+    }
+
+
+
+    namespace internal
+    {
+      /**
+       * Scratch object for the parallel loop over all cells in
+       * compute_kelly_indicators(). It contains one set of objects to
+       * evaluate the solution on both sides of a face for every distinct
+       * face quadrature formula.
+       */
+      template <int dim>
+      struct KellyScratch
+      {
+        KellyScratch (const Mapping<dim> &mapping,
+                      const FiniteElement<dim> &fe,
+                      const std::vector<Quadrature<dim-1>> &quadratures)
+          :
+          mapping (mapping),
+          fe (fe),
+          quadratures (quadratures),
+          jump_integrals (quadratures.size(), std::vector<double>(fe.n_components()))
+        {
+          for (const auto &quadrature : quadratures)
+            {
+              face_values.emplace_back (std::make_unique<FEFaceValues<dim>> (mapping, fe, quadrature,
+                                                                             update_gradients | update_normal_vectors | update_JxW_values));
+              subface_values.emplace_back (std::make_unique<FESubfaceValues<dim>> (mapping, fe, quadrature,
+                                                                                   update_gradients | update_normal_vectors | update_JxW_values));
+              neighbor_face_values.emplace_back (std::make_unique<FEFaceValues<dim>> (mapping, fe, quadrature,
+                                                                                      update_gradients));
+              neighbor_subface_values.emplace_back (std::make_unique<FESubfaceValues<dim>> (mapping, fe, quadrature,
+                                                                                            update_gradients));
+            }
+        }
+
+        KellyScratch (const KellyScratch &scratch)
+          :
+          KellyScratch (scratch.mapping, scratch.fe, scratch.quadratures)
+        {}
+
+        const Mapping<dim> &mapping;
+        const FiniteElement<dim> &fe;
+        const std::vector<Quadrature<dim-1>> &quadratures;
+
+        std::vector<std::unique_ptr<FEFaceValues<dim>>> face_values;
+        std::vector<std::unique_ptr<FESubfaceValues<dim>>> subface_values;
+        std::vector<std::unique_ptr<FEFaceValues<dim>>> neighbor_face_values;
+        std::vector<std::unique_ptr<FESubfaceValues<dim>>> neighbor_subface_values;
+
+        std::vector<Tensor<1,dim>> gradients;
+        std::vector<Tensor<1,dim>> neighbor_gradients;
+
+        /**
+         * The integral of the squared jump of the normal derivative of
+         * each component over all faces of the current cell, computed with
+         * each of the quadrature formulas.
+         */
+        std::vector<std::vector<double>> jump_integrals;
+      };
+
+
+
+      /**
+       * Every cell only writes its own entries of the error indicators,
+       * so there is nothing to copy.
+       */
+      struct KellyCopyData
+      {};
+
+
+
+      /**
+       * Add the integrals of the squared jumps of the normal derivatives of
+       * the given @p components over one face (or subface) to
+       * @p jump_integrals. @p present_values needs to be initialized on the
+       * present cell and provides the normal vectors and integration weights,
+       * @p neighbor_values needs to be initialized on the same (sub)face seen
+       * from the neighbor cell.
+       */
+      template <int dim>
+      void
+      integrate_normal_derivative_jumps (const FEFaceValuesBase<dim> &present_values,
+                                         const FEFaceValuesBase<dim> &neighbor_values,
+                                         const LinearAlgebra::BlockVector &solution,
+                                         const std::vector<unsigned int> &components,
+                                         std::vector<Tensor<1,dim>> &gradients,
+                                         std::vector<Tensor<1,dim>> &neighbor_gradients,
+                                         std::vector<double> &jump_integrals)
+      {
+        const unsigned int n_q_points = present_values.n_quadrature_points;
+        gradients.resize (n_q_points);
+        neighbor_gradients.resize (n_q_points);
+
+        for (const unsigned int c : components)
+          {
+            const FEValuesExtractors::Scalar extractor (c);
+            present_values[extractor].get_function_gradients (solution, gradients);
+            neighbor_values[extractor].get_function_gradients (solution, neighbor_gradients);
+
+            double integral = 0;
+            for (unsigned int q=0; q<n_q_points; ++q)
+              {
+                const double jump = (gradients[q] - neighbor_gradients[q]) * present_values.normal_vector(q);
+                integral += jump * jump * present_values.JxW(q);
+              }
+            jump_integrals[c] += integral;
+          }
+      }
+    }
+
+
+
+    template <int dim>
+    void
+    compute_kelly_indicators (const SimulatorAccess<dim> &simulator_access,
+                              const std::vector<const KellyInterface<dim> *> &criteria,
+                              const std::vector<Vector<float> *> &error_indicators)
+    {
+      Assert (criteria.size() == error_indicators.size(),
+              ExcDimensionMismatch (criteria.size(), error_indicators.size()));
+
+      const FiniteElement<dim> &fe = simulator_access.get_fe();
+      const LinearAlgebra::BlockVector &solution = simulator_access.get_solution();
+
+      // collect the component masks of all criteria, and which of the
+      // distinct face quadrature formulas each of them uses. then collect
+      // for each quadrature formula the components whose jumps need to
+      // be computed with it, so that no component is evaluated twice
+      // with the same formula even if several criteria ask for it
+      struct MaskIndicator
+      {
+        std::vector<unsigned int> components;
+        unsigned int quadrature_index;
+      };
+
+      std::vector<Quadrature<dim-1>> quadratures;
+      std::vector<std::vector<MaskIndicator>> mask_indicators (criteria.size());
+      for (unsigned int i=0; i<criteria.size(); ++i)
+        {
+          const Quadrature<dim-1> &quadrature = criteria[i]->get_face_quadrature();
+          const unsigned int quadrature_index
+            = std::find (quadratures.begin(), quadratures.end(), quadrature) - quadratures.begin();
+          if (quadrature_index == quadratures.size())
+            quadratures.push_back (quadrature);
+
+          for (const ComponentMask &mask : criteria[i]->get_component_masks())
+            {
+              MaskIndicator mask_indicator;
+              for (unsigned int c=0; c<fe.n_components(); ++c)
+                if (mask[c])
+                  mask_indicator.components.push_back (c);
+              mask_indicator.quadrature_index = quadrature_index;
+              mask_indicators[i].push_back (mask_indicator);
+            }
+        }
+
+      // use one vector of jump integrals per quadrature formula if the
+      // same component is requested with different formulas
+      std::vector<std::vector<unsigned int>> components_per_quadrature (quadratures.size());
+      for (const auto &criterion_mask_indicators : mask_indicators)
+        for (const MaskIndicator &mask_indicator : criterion_mask_indicators)
+          for (const unsigned int c : mask_indicator.components)
+            components_per_quadrature[mask_indicator.quadrature_index].push_back (c);
+      for (auto &components : components_per_quadrature)
+        {
+          std::sort (components.begin(), components.end());
+          components.erase (std::unique (components.begin(), components.end()), components.end());
+        }
+
+      std::vector<std::vector<Vector<float>>> indicators_per_mask (criteria.size());
+      for (unsigned int i=0; i<criteria.size(); ++i)
+        indicators_per_mask[i].resize (mask_indicators[i].size(),
+                                       Vector<float> (error_indicators[i]->size()));
+
+      auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                        internal::KellyScratch<dim> &scratch,
+                        internal::KellyCopyData &)
+      {
+        for (unsigned int g=0; g<quadratures.size(); ++g)
+          {
+            std::fill (scratch.jump_integrals[g].begin(), scratch.jump_integrals[g].end(), 0.);
+            const std::vector<unsigned int> &components = components_per_quadrature[g];
+
+            for (const unsigned int f : cell->face_indices())
+              {
+                // faces at the boundary do not contribute, just like in
+                // deal.II's KellyErrorEstimator without Neumann data.
+                // periodic faces are treated like interior faces between
+                // the cell and its periodic neighbor
+                if (cell->at_boundary(f))
+                  {
+                    if (cell->has_periodic_neighbor(f) == false)
+                      continue;
+
+                    const typename DoFHandler<dim>::cell_iterator neighbor = cell->periodic_neighbor(f);
+                    if (neighbor->has_children())
+                      {
+                        // the periodic neighbor is finer: integrate over
+                        // all of its children adjacent to this face
+                        const unsigned int neighbor_face = cell->periodic_neighbor_face_no(f);
+                        for (unsigned int subface=0; subface<neighbor->face(neighbor_face)->n_children(); ++subface)
+                          {
+                            scratch.subface_values[g]->reinit (cell, f, subface);
+                            scratch.neighbor_face_values[g]->reinit (cell->periodic_neighbor_child_on_subface(f, subface),
+                                                                     neighbor_face);
+                            internal::integrate_normal_derivative_jumps (*scratch.subface_values[g],
+                                                                         *scratch.neighbor_face_values[g],
+                                                                         solution,
+                                                                         components,
+                                                                         scratch.gradients,
+                                                                         scratch.neighbor_gradients,
+                                                                         scratch.jump_integrals[g]);
+                          }
+                      }
+                    else if (cell->periodic_neighbor_is_coarser(f))
+                      {
+                        // the face of this cell is a subface of the
+                        // periodic neighbor
+                        const std::pair<unsigned int, unsigned int> neighbor_face_subface
+                          = cell->periodic_neighbor_of_coarser_periodic_neighbor(f);
+                        scratch.face_values[g]->reinit (cell, f);
+                        scratch.neighbor_subface_values[g]->reinit (neighbor,
+                                                                    neighbor_face_subface.first,
+                                                                    neighbor_face_subface.second);
+                        internal::integrate_normal_derivative_jumps (*scratch.face_values[g],
+                                                                     *scratch.neighbor_subface_values[g],
+                                                                     solution,
+                                                                     components,
+                                                                     scratch.gradients,
+                                                                     scratch.neighbor_gradients,
+                                                                     scratch.jump_integrals[g]);
+                      }
+                    else
+                      {
+                        scratch.face_values[g]->reinit (cell, f);
+                        scratch.neighbor_face_values[g]->reinit (neighbor,
+                                                                 cell->periodic_neighbor_face_no(f));
+                        internal::integrate_normal_derivative_jumps (*scratch.face_values[g],
+                                                                     *scratch.neighbor_face_values[g],
+                                                                     solution,
+                                                                     components,
+                                                                     scratch.gradients,
+                                                                     scratch.neighbor_gradients,
+                                                                     scratch.jump_integrals[g]);
+                      }
+                    continue;
+                  }
+
+                if (cell->face(f)->has_children())
+                  {
+                    // the neighbor is finer: integrate over all subfaces
+                    const unsigned int neighbor_neighbor = cell->neighbor_of_neighbor(f);
+                    for (unsigned int subface=0; subface<cell->face(f)->n_children(); ++subface)
+                      {
+                        scratch.subface_values[g]->reinit (cell, f, subface);
+                        scratch.neighbor_face_values[g]->reinit (cell->neighbor_child_on_subface(f, subface),
+                                                                 neighbor_neighbor);
+                        internal::integrate_normal_derivative_jumps (*scratch.subface_values[g],
+                                                                     *scratch.neighbor_face_values[g],
+                                                                     solution,
+                                                                     components,
+                                                                     scratch.gradients,
+                                                                     scratch.neighbor_gradients,
+                                                                     scratch.jump_integrals[g]);
+                      }
+                  }
+                else if (cell->neighbor_is_coarser(f))
+                  {
+                    // the face of this cell is a subface of the neighbor
+                    const std::pair<unsigned int, unsigned int> neighbor_face_subface
+                      = cell->neighbor_of_coarser_neighbor(f);
+                    scratch.face_values[g]->reinit (cell, f);
+                    scratch.neighbor_subface_values[g]->reinit (cell->neighbor(f),
+                                                                neighbor_face_subface.first,
+                                                                neighbor_face_subface.second);
+                    internal::integrate_normal_derivative_jumps (*scratch.face_values[g],
+                                                                 *scratch.neighbor_subface_values[g],
+                                                                 solution,
+                                                                 components,
+                                                                 scratch.gradients,
+                                                                 scratch.neighbor_gradients,
+                                                                 scratch.jump_integrals[g]);
+                  }
+                else
+                  {
+                    scratch.face_values[g]->reinit (cell, f);
+                    scratch.neighbor_face_values[g]->reinit (cell->neighbor(f),
+                                                             cell->neighbor_of_neighbor(f));
+                    internal::integrate_normal_derivative_jumps (*scratch.face_values[g],
+                                                                 *scratch.neighbor_face_values[g],
+                                                                 solution,
+                                                                 components,
+                                                                 scratch.gradients,
+                                                                 scratch.neighbor_gradients,
+                                                                 scratch.jump_integrals[g]);
+                  }
+              }
+
+          }
+
+        // every cell only writes its own entry of the indicator vectors,
+        // so this is safe to do from several threads at the same time.
+        // the price for this is that every interior face is integrated
+        // twice, once from each of the cells adjacent to it, whereas
+        // deal.II's KellyErrorEstimator stores the face integrals and
+        // integrates every face only once
+        const double factor = cell->diameter() / 24;
+        for (unsigned int i=0; i<criteria.size(); ++i)
+          for (unsigned int m=0; m<mask_indicators[i].size(); ++m)
+            {
+              double sum = 0;
+              for (const unsigned int c : mask_indicators[i][m].components)
+                sum += scratch.jump_integrals[mask_indicators[i][m].quadrature_index][c];
+
+              indicators_per_mask[i][m](cell->active_cell_index()) = std::sqrt(factor * sum);
+            }
+      };
+
+      using CellFilter = FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+
+      WorkStream::run (CellFilter (IteratorFilters::LocallyOwnedCell(),
+                                   simulator_access.get_dof_handler().begin_active()),
+                       CellFilter (IteratorFilters::LocallyOwnedCell(),
+                                   simulator_access.get_dof_handler().end()),
+                       worker,
+                       std::function<void (const internal::KellyCopyData &)>(),
+                       internal::KellyScratch<dim> (simulator_access.get_mapping(),
+                                                    fe,
+                                                    quadratures),
+                       internal::KellyCopyData());
+
+      for (unsigned int i=0; i<criteria.size(); ++i)
+        criteria[i]->combine_indicators (indicators_per_mask[i],
+                                         *error_indicators[i]);
+    }
+
+
+
 // ------------------------------ Manager -----------------------------
 
     template <int dim>
@@ -60,6 +638,48 @@ namespace aspect
       // verify that its values are non-negative numbers
       std::vector<Vector<float>> all_error_indicators (this->plugin_objects.size(),
                                                         Vector<float>(error_indicators.size()));
+
+      // criteria that compute their indicators from the gradient of a
+      // field at the temperature support points share a single loop over
+      // all cells and a single evaluation of the material model per cell.
+      // collect them here and compute their indicators together, at the
+      // place where the first of them would have been executed
+      std::vector<const FieldGradientInterface<dim> *> field_gradient_criteria;
+      std::vector<Vector<float> *> field_gradient_indicators;
+      {
+        unsigned int index = 0;
+        for (const auto &p : this->plugin_objects)
+          {
+            if (const FieldGradientInterface<dim> *criterion
+                = dynamic_cast<const FieldGradientInterface<dim> *>(p.get()))
+              {
+                field_gradient_criteria.push_back (criterion);
+                field_gradient_indicators.push_back (&all_error_indicators[index]);
+              }
+            ++index;
+          }
+      }
+      bool field_gradient_indicators_computed = false;
+
+      // the same holds for criteria that are based on the jumps of
+      // normal derivatives across faces
+      std::vector<const KellyInterface<dim> *> kelly_criteria;
+      std::vector<Vector<float> *> kelly_indicators;
+      {
+        unsigned int index = 0;
+        for (const auto &p : this->plugin_objects)
+          {
+            if (const KellyInterface<dim> *criterion
+                = dynamic_cast<const KellyInterface<dim> *>(p.get()))
+              {
+                kelly_criteria.push_back (criterion);
+                kelly_indicators.push_back (&all_error_indicators[index]);
+              }
+            ++index;
+          }
+      }
+      bool kelly_indicators_computed = false;
+
       unsigned int index = 0;
       for (typename std::list<std::unique_ptr<Interface<dim>>>::const_iterator
            p = this->plugin_objects.begin();
@@ -67,7 +687,28 @@ namespace aspect
         {
           try
             {
-              (*p)->execute (all_error_indicators[index]);
+              if (dynamic_cast<const FieldGradientInterface<dim> *>(p->get()) != nullptr)
+                {
+                  if (field_gradient_indicators_computed == false)
+                    {
+                      compute_field_gradient_indicators (*this,
+                                                         field_gradient_criteria,
+                                                         field_gradient_indicators);
+                      field_gradient_indicators_computed = true;
+                    }
+                }
+              else if (dynamic_cast<const KellyInterface<dim> *>(p->get()) != nullptr)
+                {
+                  if (kelly_indicators_computed == false)
+                    {
+                      compute_kelly_indicators (*this,
+                                                kelly_criteria,
+                                                kelly_indicators);
+                      kelly_indicators_computed = true;
+                    }
+                }
+              else
+                (*p)->execute (all_error_indicators[index]);
 
               for (unsigned int i=0; i<error_indicators.size(); ++i)
                 Assert (all_error_indicators[index](i) >= 0,
@@ -441,7 +1082,15 @@ namespace aspect
   {
 #define INSTANTIATE(dim) \
   template class Interface<dim>; \
-  template class Manager<dim>;
+  template class FieldGradientInterface<dim>; \
+  template class Manager<dim>; \
+  template void compute_field_gradient_indicators<dim> (const SimulatorAccess<dim> &, \
+                                                        const std::vector<const FieldGradientInterface<dim> *> &, \
+                                                        const std::vector<Vector<float> *> &); \
+  template class KellyInterface<dim>; \
+  template void compute_kelly_indicators<dim> (const SimulatorAccess<dim> &, \
+                                               const std::vector<const KellyInterface<dim> *> &, \
+                                               const std::vector<Vector<float> *> &);
 
     ASPECT_INSTANTIATE(INSTANTIATE)
 
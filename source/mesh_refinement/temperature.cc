@@ -21,30 +21,24 @@
 
 #include <aspect/mesh_refinement/temperature.h>
 
-#include <deal.II/base/quadrature_lib.h>
-#include <deal.II/numerics/error_estimator.h>
-
 namespace aspect
 {
   namespace MeshRefinement
   {
     template <int dim>
-    void
-    Temperature<dim>::execute(Vector<float> &indicators) const
+    std::vector<ComponentMask>
+    Temperature<dim>::get_component_masks() const
     {
-      indicators = 0;
+      return {this->introspection().component_masks.temperature};
+    }
+
 
-      const Quadrature<dim-1> &quadrature = this->introspection().face_quadratures.temperature;
-      KellyErrorEstimator<dim>::estimate (this->get_mapping(),
-                                          this->get_dof_handler(),
-                                          quadrature,
-                                          std::map<types::boundary_id,const Function<dim>*>(),
-                                          this->get_solution(),
-                                          indicators,
-                                          this->introspection().component_masks.temperature,
-                                          nullptr,
-                                          0,
-                                          this->get_triangulation().locally_owned_subdomain());
+
+    template <int dim>
+    const Quadrature<dim-1> &
+    Temperature<dim>::get_face_quadrature() const
+    {
+      return this->introspection().face_quadratures.temperature;
     }
   }
 }
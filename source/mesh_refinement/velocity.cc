@@ -21,30 +21,24 @@
 
 #include <aspect/mesh_refinement/velocity.h>
 
-#include <deal.II/base/quadrature_lib.h>
-#include <deal.II/numerics/error_estimator.h>
-
 namespace aspect
 {
   namespace MeshRefinement
   {
     template <int dim>
-    void
-    Velocity<dim>::execute(Vector<float> &indicators) const
+    std::vector<ComponentMask>
+    Velocity<dim>::get_component_masks() const
     {
-      indicators = 0;
+      return {this->introspection().component_masks.velocities};
+    }
+
 
-      const Quadrature<dim-1> &quadrature = this->introspection().face_quadratures.velocities;
-      KellyErrorEstimator<dim>::estimate (this->get_mapping(),
-                                          this->get_dof_handler(),
-                                          quadrature,
-                                          std::map<types::boundary_id,const Function<dim>*>(),
-                                          this->get_solution(),
-                                          indicators,
-                                          this->introspection().component_masks.velocities,
-                                          nullptr,
-                                          0,
-                                          this->get_triangulation().locally_owned_subdomain());
+
+    template <int dim>
+    const Quadrature<dim-1> &
+    Velocity<dim>::get_face_quadrature() const
+    {
+      return this->introspection().face_quadratures.velocities;
     }
   }
 }
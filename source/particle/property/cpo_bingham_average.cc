@@ -194,6 +194,15 @@ namespace aspect
 
 
 
+      template <int dim>
+      bool
+      CpoBinghamAverage<dim>::update_is_thread_safe() const
+      {
+        return false;
+      }
+
+
+
       template <int dim>
       UpdateFlags
       CpoBinghamAverage<dim>::get_needed_update_flags () const
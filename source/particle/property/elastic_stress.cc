@@ -30,11 +30,7 @@ namespace aspect
     namespace Property
     {
       template <int dim>
-      ElasticStress<dim>::ElasticStress ()
-        :
-        material_inputs(1,0),
-        material_outputs(1,0)
-      {}
+      ElasticStress<dim>::ElasticStress () = default;
 
 
 
@@ -42,10 +38,6 @@ namespace aspect
       void
       ElasticStress<dim>::initialize ()
       {
-        material_inputs = MaterialModel::MaterialModelInputs<dim>(1, this->n_compositional_fields());
-
-        material_outputs = MaterialModel::MaterialModelOutputs<dim>(1, this->n_compositional_fields());
-
         AssertThrow((Plugins::plugin_type_matches<const MaterialModel::ViscoPlastic<dim>>(this->get_material_model())
                      ||
                      Plugins::plugin_type_matches<const MaterialModel::Viscoelastic<dim>>(this->get_material_model())),
@@ -92,6 +84,9 @@ namespace aspect
       ElasticStress<dim>::update_particle_properties(const ParticleUpdateInputs<dim> &inputs,
                                                      typename ParticleHandler<dim>::particle_iterator_range &particles) const
       {
+        MaterialModel::MaterialModelInputs<dim> material_inputs(1, this->n_compositional_fields());
+        MaterialModel::MaterialModelOutputs<dim> material_outputs(1, this->n_compositional_fields());
+
         unsigned int p = 0;
         for (auto &particle: particles)
           {
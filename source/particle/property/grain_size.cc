@@ -29,11 +29,7 @@ namespace aspect
     namespace Property
     {
       template <int dim>
-      GrainSize<dim>::GrainSize ()
-        :
-        material_inputs(1,0),
-        material_outputs(1,0)
-      {}
+      GrainSize<dim>::GrainSize () = default;
 
 
 
@@ -41,9 +37,6 @@ namespace aspect
       void
       GrainSize<dim>::initialize ()
       {
-        material_inputs  = MaterialModel::MaterialModelInputs<dim>(1, this->n_compositional_fields());
-        material_outputs = MaterialModel::MaterialModelOutputs<dim>(1, this->n_compositional_fields());
-
         AssertThrow(this->introspection().compositional_name_exists("grain_size"),
                     ExcMessage("This particle property only makes sense if "
                                "there is a compositional field named 'grain_size'."));
@@ -69,8 +62,8 @@ namespace aspect
       GrainSize<dim>::update_particle_properties(const ParticleUpdateInputs<dim> &inputs,
                                                  typename ParticleHandler<dim>::particle_iterator_range &particles) const
       {
-        material_inputs  = MaterialModel::MaterialModelInputs<dim>(inputs.solution.size(), this->n_compositional_fields());
-        material_outputs = MaterialModel::MaterialModelOutputs<dim>(inputs.solution.size(), this->n_compositional_fields());
+        MaterialModel::MaterialModelInputs<dim> material_inputs(inputs.solution.size(), this->n_compositional_fields());
+        MaterialModel::MaterialModelOutputs<dim> material_outputs(inputs.solution.size(), this->n_compositional_fields());
         material_inputs.requested_properties = MaterialModel::MaterialProperties::reaction_terms;
         material_inputs.current_cell = inputs.current_cell;
 
@@ -264,6 +264,15 @@ namespace aspect
 
 
 
+      template <int dim>
+      bool
+      Interface<dim>::update_is_thread_safe () const
+      {
+        return true;
+      }
+
+
+
       template <int dim>
       UpdateFlags
       Interface<dim>::get_needed_update_flags () const
@@ -577,6 +586,19 @@ namespace aspect
 
 
 
+      template <int dim>
+      bool
+      Manager<dim>::update_is_thread_safe () const
+      {
+        for (const auto &p : this->plugin_objects)
+          if (p->update_is_thread_safe() == false)
+            return false;
+
+        return true;
+      }
+
+
+
       template <int dim>
       UpdateFlags
       Manager<dim>::get_needed_update_flags () const
@@ -33,8 +33,7 @@ namespace aspect
       template <int dim>
       ViscoPlasticStrainInvariant<dim>::ViscoPlasticStrainInvariant ()
         :
-        n_components(0),
-        material_inputs(1,0)
+        n_components(0)
       {}
 
 
@@ -49,7 +48,6 @@ namespace aspect
                                "with the visco_plastic material model."));
 
         n_components = 0;
-        material_inputs = MaterialModel::MaterialModelInputs<dim>(1,this->n_compositional_fields());
 
         // Find out which fields are used.
         if (this->introspection().compositional_name_exists("plastic_strain"))
@@ -108,6 +106,8 @@ namespace aspect
         const double dt = this->get_timestep();
         const unsigned int data_position = this->data_position;
 
+        MaterialModel::MaterialModelInputs<dim> material_inputs(1,this->n_compositional_fields());
+
         unsigned int p = 0;
         for (auto &particle: particles)
           {
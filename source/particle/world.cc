@@ -26,7 +26,9 @@
 #include <aspect/melt.h>
 
 #include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/grid/grid_tools.h>
 
 #include <deal.II/fe/mapping_cartesian.h>
@@ -39,6 +41,50 @@ namespace aspect
 {
   namespace Particle
   {
+    namespace internal
+    {
+      /**
+       * Scratch object for the thread-parallel loops over all cells in
+       * World::update_particles() and World::advect_particles(). Every
+       * thread works on its own copy, so that the objects that evaluate the
+       * solution at the particle positions are not shared between threads.
+       */
+      template <int dim>
+      struct ParticleScratch
+      {
+        ParticleScratch (const SimulatorAccess<dim> &simulator_access,
+                         const UpdateFlags update_flags)
+          :
+          simulator_access (simulator_access),
+          update_flags (update_flags),
+          evaluator (construct_solution_evaluator(simulator_access, update_flags))
+        {}
+
+        ParticleScratch (const ParticleScratch &scratch)
+          :
+          simulator_access (scratch.simulator_access),
+          update_flags (scratch.update_flags),
+          evaluator (construct_solution_evaluator(scratch.simulator_access, scratch.update_flags))
+        {}
+
+        const SimulatorAccess<dim> &simulator_access;
+        const UpdateFlags update_flags;
+
+        std::unique_ptr<SolutionEvaluator<dim>> evaluator;
+        Property::ParticleUpdateInputs<dim> inputs;
+        small_vector<Point<dim>> positions;
+      };
+
+      /**
+       * The loops over all cells write directly into the particles
+       * of the cell that is being worked on, so there is nothing to copy.
+       */
+      struct ParticleCopyData
+      {};
+    }
+
+
+
     template <int dim>
     World<dim>::World()
       = default;
@@ -620,8 +666,6 @@ namespace aspect
     void
     World<dim>::update_particles()
     {
-      // TODO: Change this loop over all cells to use the WorkStream interface
-
       if (property_manager->get_n_property_components() > 0)
         {
           TimerOutput::Scope timer_section(this->get_computing_timer(), "Particles: Update properties");
@@ -633,26 +677,42 @@ namespace aspect
 
           const UpdateFlags update_flags = property_manager->get_needed_update_flags();
 
-          std::unique_ptr<SolutionEvaluator<dim>> evaluator = construct_solution_evaluator(*this,
-                                                               update_flags);
-
-          Property::ParticleUpdateInputs<dim> inputs;
-          small_vector<Point<dim>> positions;
-
-          // Loop over all cells and update the particles cell-wise
-          for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-            if (cell->is_locally_owned())
+          // Update the particles cell-wise. The particles of each cell are
+          // only touched by the work on that cell, so cells can be
+          // processed concurrently.
+          auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                            internal::ParticleScratch<dim> &scratch,
+                            internal::ParticleCopyData &)
+          {
+            // Only update particles if there are any in this cell
+            if (particle_handler->n_particles_in_cell(cell) > 0)
               {
-                // Only update particles if there are any in this cell
-                if (particle_handler->n_particles_in_cell(cell) > 0)
-                  {
-                    inputs.current_cell = cell;
-                    local_update_particles(inputs,
-                                           positions,
-                                           *evaluator);
-                  }
-
+                scratch.inputs.current_cell = cell;
+                local_update_particles(scratch.inputs,
+                                       scratch.positions,
+                                       *scratch.evaluator);
               }
+          };
+
+          using CellFilter = FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+          const CellFilter begin (IteratorFilters::LocallyOwnedCell(), this->get_dof_handler().begin_active());
+          const CellFilter end (IteratorFilters::LocallyOwnedCell(), this->get_dof_handler().end());
+
+          internal::ParticleScratch<dim> scratch (*this, update_flags);
+          internal::ParticleCopyData copy_data;
+
+          // Some property plugins can not be updated concurrently. Use the
+          // same worker on a single thread for them.
+          if (property_manager->update_is_thread_safe())
+            WorkStream::run (begin,
+                             end,
+                             worker,
+                             std::function<void (const internal::ParticleCopyData &)>(),
+                             scratch,
+                             copy_data);
+          else
+            for (CellFilter cell = begin; cell != end; ++cell)
+              worker (cell, scratch, copy_data);
         }
     }
 
@@ -663,7 +723,6 @@ namespace aspect
     World<dim>::advect_particles()
     {
       {
-        // TODO: Change this loop over all cells to use the WorkStream interface
         TimerOutput::Scope timer_section(this->get_computing_timer(), "Particles: Advect");
 
         Assert(dealii::internal::FEPointEvaluation::is_fast_path_supported(this->get_mapping()) == true,
@@ -671,25 +730,35 @@ namespace aspect
                           "of the class FEPointEvaluation. The mapping currently in use does not support this path. "
                           "It is safe to uncomment this assertion, but you can expect a performance penalty."));
 
-        std::unique_ptr<SolutionEvaluator<dim>> evaluator = construct_solution_evaluator(*this,
-                                                             update_values);
+        // Advect the particles cell-wise. The integrators only modify the
+        // location and properties of the particles they are given, so
+        // cells can be processed concurrently.
+        auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                          internal::ParticleScratch<dim> &scratch,
+                          internal::ParticleCopyData &)
+        {
+          const typename ParticleHandler<dim>::particle_iterator_range
+          particles_in_cell = particle_handler->particles_in_cell(cell);
 
-        // Loop over all cells and advect the particles cell-wise
-        for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-          if (cell->is_locally_owned())
+          // Only advect particles, if there are any in this cell
+          if (particles_in_cell.begin() != particles_in_cell.end())
             {
-              const typename ParticleHandler<dim>::particle_iterator_range
-              particles_in_cell = particle_handler->particles_in_cell(cell);
-
-              // Only advect particles, if there are any in this cell
-              if (particles_in_cell.begin() != particles_in_cell.end())
-                {
-                  local_advect_particles(cell,
-                                         particles_in_cell.begin(),
-                                         particles_in_cell.end(),
-                                         *evaluator);
-                }
+              local_advect_particles(cell,
+                                     particles_in_cell.begin(),
+                                     particles_in_cell.end(),
+                                     *scratch.evaluator);
             }
+        };
+
+        using CellFilter = FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+        WorkStream::run (CellFilter (IteratorFilters::LocallyOwnedCell(),
+                                     this->get_dof_handler().begin_active()),
+                         CellFilter (IteratorFilters::LocallyOwnedCell(),
+                                     this->get_dof_handler().end()),
+                         worker,
+                         std::function<void (const internal::ParticleCopyData &)>(),
+                         internal::ParticleScratch<dim> (*this, update_values),
+                         internal::ParticleCopyData());
       }
 
       {
@@ -41,36 +41,27 @@ namespace aspect
     std::pair<std::vector<double>,std::vector<double>>
     Geoid<dim>::to_spherical_harmonic_coefficients(const std::vector<std::vector<double>> &spherical_function) const
     {
-      std::vector<double> cosi(spherical_function.size(),0);
-      std::vector<double> sini(spherical_function.size(),0);
-      std::vector<double> coecos;
-      std::vector<double> coesin;
-
-      for (unsigned int ideg =  min_degree; ideg < max_degree+1; ++ideg)
+      const unsigned int n_coefficients = (max_degree+1)*(max_degree+2)/2 - min_degree*(min_degree+1)/2;
+      const unsigned int first_index = min_degree*(min_degree+1)/2;
+      std::vector<double> coecos(n_coefficients, 0.);
+      std::vector<double> coesin(n_coefficients, 0.);
+
+      // Do the spherical harmonic expansion. All degrees and orders of
+      // the real spherical harmonics are evaluated together at each point,
+      // and the contribution of each spherical infinitesimal is integrated.
+      std::vector<double> cos_components;
+      std::vector<double> sin_components;
+      for (const auto &spherical_point : spherical_function)
         {
-          for (unsigned int iord = 0; iord < ideg+1; ++iord)
-            {
-              // Do the spherical harmonic expansion.
-              for (unsigned int ds_num = 0; ds_num < spherical_function.size(); ++ds_num)
-                {
-                  // Normalization after Dahlen and Tromp (1986) Appendix B.6.
-                  const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,spherical_function.at(ds_num).at(0),spherical_function.at(ds_num).at(1));
-                  const double cos_component = sph_harm_vals.first; // real / cos part
-                  const double sin_component = sph_harm_vals.second; // imaginary / sin part
+          // Normalization after Dahlen and Tromp (1986) Appendix B.6.
+          aspect::Utilities::real_spherical_harmonics(max_degree, spherical_point[0], spherical_point[1],
+                                                      cos_components, sin_components);
 
-                  cosi.at(ds_num) = (spherical_function.at(ds_num).at(3) * cos_component);
-                  sini.at(ds_num) = (spherical_function.at(ds_num).at(3) * sin_component);
-                }
-              // Integrate the contribution of each spherical infinitesimal.
-              double cosii = 0;
-              double sinii = 0;
-              for (unsigned int ds_num = 0; ds_num < spherical_function.size(); ++ds_num)
-                {
-                  cosii += cosi.at(ds_num) * spherical_function.at(ds_num).at(2);
-                  sinii += sini.at(ds_num) * spherical_function.at(ds_num).at(2);
-                }
-              coecos.push_back(cosii);
-              coesin.push_back(sinii);
+          const double weighted_value = spherical_point[3] * spherical_point[2];
+          for (unsigned int i=0; i<n_coefficients; ++i)
+            {
+              coecos[i] += weighted_value * cos_components[first_index+i];
+              coesin[i] += weighted_value * sin_components[first_index+i];
             }
         }
       // Sum over each processor.
@@ -110,54 +101,58 @@ namespace aspect
       MaterialModel::MaterialModelOutputs<3> out(fe_values.n_quadrature_points, this->n_compositional_fields());
       in.requested_properties = MaterialModel::MaterialProperties::density;
 
-      std::vector<std::vector<double>>
-      composition_values(this->n_compositional_fields(), std::vector<double>(quadrature_formula.size()));
+      const unsigned int n_coefficients = (max_degree+1)*(max_degree+2)/2 - min_degree*(min_degree+1)/2;
+      const unsigned int first_index = min_degree*(min_degree+1)/2;
+      std::vector<double> SH_density_coecos(n_coefficients, 0.);
+      std::vector<double> SH_density_coesin(n_coefficients, 0.);
+
+      std::vector<double> cos_components;
+      std::vector<double> sin_components;
 
       // Directly do the global 3d integral over each quadrature point of every cell (different from traditional way to do layer integral).
       // This is necessary because of ASPECT's adaptive mesh refinement feature.
-      std::vector<double> SH_density_coecos;
-      std::vector<double> SH_density_coesin;
-      for (unsigned int ideg =  min_degree; ideg < max_degree+1; ++ideg)
-        {
-          for (unsigned int iord = 0; iord < ideg+1; ++iord)
-            {
-              // Initialization of the density contribution integral per degree, order.
-              double integrated_density_cos_component = 0;
-              double integrated_density_sin_component = 0;
-
-              // Loop over all of the cells.
-              for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-                if (cell->is_locally_owned())
-                  {
-                    fe_values.reinit (cell);
-                    // Set use_strain_rates to false since we don't need viscosity.
-                    in.reinit(fe_values, cell, this->introspection(), this->get_solution());
+      // Every cell is visited only once: the material model is evaluated once per cell
+      // and the contributions to all degrees and orders are accumulated at each
+      // quadrature point.
+      for (const auto &cell : this->get_dof_handler().active_cell_iterators())
+        if (cell->is_locally_owned())
+          {
+            fe_values.reinit (cell);
+            // Set use_strain_rates to false since we don't need viscosity.
+            in.reinit(fe_values, cell, this->introspection(), this->get_solution());
 
-                    this->get_material_model().evaluate(in, out);
+            this->get_material_model().evaluate(in, out);
 
-                    // Compute the integral of the density function
-                    // over the cell, by looping over all quadrature points.
-                    for (unsigned int q=0; q<quadrature_formula.size(); ++q)
-                      {
-                        // Convert coordinates from [x,y,z] to [r, phi, theta].
-                        const std::array<double,3> scoord = aspect::Utilities::Coordinates::cartesian_to_spherical_coordinates(in.position[q]);
+            // Compute the integral of the density function
+            // over the cell, by looping over all quadrature points.
+            for (unsigned int q=0; q<quadrature_formula.size(); ++q)
+              {
+                // Convert coordinates from [x,y,z] to [r, phi, theta].
+                const std::array<double,3> scoord = aspect::Utilities::Coordinates::cartesian_to_spherical_coordinates(in.position[q]);
 
-                        // Normalization after Dahlen and Tromp (1986) Appendix B.6.
-                        const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,scoord[2],scoord[1]);
-                        const double cos_component = sph_harm_vals.first; // real / cos part
-                        const double sin_component = sph_harm_vals.second; // imaginary / sin part
+                // Normalization after Dahlen and Tromp (1986) Appendix B.6.
+                aspect::Utilities::real_spherical_harmonics(max_degree, scoord[2], scoord[1],
+                                                            cos_components, sin_components);
 
-                        const double density = out.densities[q];
-                        const double r_q = in.position[q].norm();
+                const double density = out.densities[q];
+                const double r_q = in.position[q].norm();
 
-                        integrated_density_cos_component += density * (1./r_q) * std::pow(r_q/outer_radius,ideg+1) * cos_component * fe_values.JxW(q);
-                        integrated_density_sin_component += density * (1./r_q) * std::pow(r_q/outer_radius,ideg+1) * sin_component * fe_values.JxW(q);
+                // The radial factor (r_q/outer_radius)^(l+1) is computed
+                // incrementally for increasing degree.
+                double radial_factor = std::pow(r_q/outer_radius, min_degree+1);
+                for (unsigned int ideg = min_degree, i = 0; ideg < max_degree+1; ++ideg)
+                  {
+                    const double weight = density * (1./r_q) * radial_factor * fe_values.JxW(q);
+                    for (unsigned int iord = 0; iord < ideg+1; ++iord, ++i)
+                      {
+                        SH_density_coecos[i] += weight * cos_components[first_index+i];
+                        SH_density_coesin[i] += weight * sin_components[first_index+i];
                       }
+                    radial_factor *= r_q/outer_radius;
                   }
-              SH_density_coecos.push_back(integrated_density_cos_component);
-              SH_density_coesin.push_back(integrated_density_sin_component);
-            }
-        }
+              }
+          }
+
       // Sum over each processor.
       dealii::Utilities::MPI::sum (SH_density_coecos,this->get_mpi_communicator(),SH_density_coecos);
       dealii::Utilities::MPI::sum (SH_density_coesin,this->get_mpi_communicator(),SH_density_coesin);
@@ -537,26 +532,47 @@ namespace aspect
           surface_cell_spherical_coordinates.emplace_back(theta,phi);
         }
 
-      // Compute the grid geoid anomaly based on spherical harmonics.
+      // Compute the grid geoid anomaly (and if requested the free-air gravity
+      // anomaly) based on spherical harmonics. All spherical harmonics are
+      // evaluated at once for each surface point.
       std::vector<double> geoid_anomaly;
+      std::vector<double> gravity_anomaly;
+      geoid_anomaly.reserve(surface_cell_spherical_coordinates.size());
+      if (output_gravity_anomaly == true)
+        gravity_anomaly.reserve(surface_cell_spherical_coordinates.size());
+
+      const unsigned int first_index = min_degree*(min_degree+1)/2;
+      std::vector<double> cos_components;
+      std::vector<double> sin_components;
       for (const auto &surface_cell_spherical_coordinate : surface_cell_spherical_coordinates)
         {
+          // Normalization after Dahlen and Tromp (1986) Appendix B.6.
+          aspect::Utilities::real_spherical_harmonics(max_degree,
+                                                      surface_cell_spherical_coordinate.first,
+                                                      surface_cell_spherical_coordinate.second,
+                                                      cos_components, sin_components);
+
           int ind = 0;
           double geoid_value = 0;
+          double gravity_value = 0;
           for (unsigned int ideg =  min_degree; ideg < max_degree+1; ++ideg)
             {
+              double geoid_degree_value = 0;
               for (unsigned int iord = 0; iord < ideg+1; ++iord)
                 {
-                  // Normalization after Dahlen and Tromp (1986) Appendix B.6.
-                  const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,surface_cell_spherical_coordinate.first,surface_cell_spherical_coordinate.second);
-                  const double cos_component = sph_harm_vals.first; // real / cos part
-                  const double sin_component = sph_harm_vals.second; // imaginary / sin part
-
-                  geoid_value += geoid_coecos.at(ind)*cos_component+geoid_coesin.at(ind)*sin_component;
+                  geoid_degree_value += geoid_coecos.at(ind)*cos_components[first_index+ind]
+                                        + geoid_coesin.at(ind)*sin_components[first_index+ind];
                   ++ind;
                 }
+              geoid_value += geoid_degree_value;
+
+              // The conversion from geoid to gravity anomaly is given by gravity_anomaly = (l-1)*g/R_surface * geoid_anomaly
+              // based on Forte (2007) equation [97].
+              gravity_value += geoid_degree_value * (ideg - 1) * surface_gravity / outer_radius;
             }
           geoid_anomaly.push_back(geoid_value);
+          if (output_gravity_anomaly == true)
+            gravity_anomaly.push_back(gravity_value);
         }
 
       // The user can get the spherical harmonic coefficients of the density anomaly contribution if needed
@@ -808,32 +824,6 @@ namespace aspect
                                      << " gravity_anomaly" << std::endl;
             }
 
-          // Compute the grid gravity anomaly based on spherical harmonics.
-          std::vector<double> gravity_anomaly;
-          gravity_anomaly.reserve(surface_cell_spherical_coordinates.size());
-
-          for (const auto &surface_cell_spherical_coordinate : surface_cell_spherical_coordinates)
-            {
-              int ind = 0;
-              double gravity_value = 0;
-              for (unsigned int ideg =  min_degree; ideg < max_degree+1; ++ideg)
-                {
-                  for (unsigned int iord = 0; iord < ideg+1; ++iord)
-                    {
-                      // Normalization after Dahlen and Tromp (1986) Appendix B.6.
-                      const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,surface_cell_spherical_coordinate.first,surface_cell_spherical_coordinate.second);
-                      const double cos_component = sph_harm_vals.first; // real / cos part
-                      const double sin_component = sph_harm_vals.second; // imaginary / sin part
-
-                      // The conversion from geoid to gravity anomaly is given by gravity_anomaly = (l-1)*g/R_surface * geoid_anomaly
-                      // based on Forte (2007) equation [97].
-                      gravity_value += (geoid_coecos.at(ind)*cos_component+geoid_coesin.at(ind)*sin_component) * (ideg - 1) * surface_gravity / outer_radius;
-                      ++ind;
-                    }
-                }
-              gravity_anomaly.push_back(gravity_value);
-            }
-
           // Prepare the output data.
           if (output_in_lat_lon == true)
             {
@@ -911,15 +901,15 @@ namespace aspect
       const double phi = scoord[1];
       double value = 0.;
 
-      for (unsigned int ideg=min_degree, k=0; ideg < max_degree+1; ++ideg)
-        for (unsigned int iord = 0; iord < ideg+1; ++iord, ++k)
-          {
-            std::pair<double,double> val = aspect::Utilities::real_spherical_harmonic( ideg, iord, theta, phi );
+      std::vector<double> cos_components;
+      std::vector<double> sin_components;
+      aspect::Utilities::real_spherical_harmonics(max_degree, theta, phi, cos_components, sin_components);
 
-            value += geoid_coecos[k] * val.first +
-                     geoid_coesin[k] * val.second;
+      const unsigned int first_index = min_degree*(min_degree+1)/2;
+      for (unsigned int k=0; k<geoid_coecos.size(); ++k)
+        value += geoid_coecos[k] * cos_components[first_index+k] +
+                 geoid_coesin[k] * sin_components[first_index+k];
 
-          }
       return value;
     }
 
@@ -1002,6 +992,9 @@ namespace aspect
           include_CMB_topo_contribution = prm.get_bool ("Include CMB topography contribution");
           max_degree = prm.get_integer ("Maximum degree");
           min_degree = prm.get_integer ("Minimum degree");
+          AssertThrow (min_degree <= max_degree,
+                       ExcMessage("The parameter 'Minimum degree' of the geoid postprocessor "
+                                  "must not be larger than the parameter 'Maximum degree'."));
           output_in_lat_lon = prm.get_bool ("Output data in geographical coordinates");
           density_above = prm.get_double ("Density above");
           density_below = prm.get_double ("Density below");
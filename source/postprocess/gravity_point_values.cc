@@ -29,17 +29,205 @@
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/mpi.templates.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/vectorization.h>
 #include <deal.II/fe/fe_values.h>
 
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <array>
+
 
 namespace aspect
 {
   namespace Postprocess
   {
+    namespace internal
+    {
+      /**
+       * The masses of all locally owned quadrature points, multiplied by
+       * the gravitational constant, together with their positions. The
+       * data is stored as a structure of arrays and grouped by cell. The
+       * points of each cell are padded to a multiple of the SIMD width
+       * with points of zero mass, so that the contributions of the points
+       * of a cell can be computed for several points at once.
+       *
+       * For every cell, we also store the sum of the masses, their center
+       * of mass, and the largest distance of a quadrature point from this
+       * center. This allows to replace the contribution of all points of
+       * a cell by the one of a single point mass for satellites that are
+       * far away from the cell.
+       */
+      template <int dim>
+      struct GravitySources
+      {
+        /**
+         * The coordinates of the points, one array per coordinate direction.
+         */
+        std::array<std::vector<double>,dim> coordinates;
+        std::vector<double> mass;
+        std::vector<double> mass_anomaly;
+
+        /**
+         * The index of the first point of each cell in the arrays above,
+         * with one additional entry for the end of the last cell.
+         */
+        std::vector<unsigned int> cell_begin;
+
+        std::vector<Point<dim>> cell_center;
+        std::vector<double> cell_radius;
+        std::vector<double> cell_mass;
+        std::vector<double> cell_mass_anomaly;
+      };
+
+
+
+      /**
+       * Add the contribution of the point mass @p mass (and the mass anomaly
+       * @p mass_anomaly) at distance @p r_vector from a satellite to the
+       * gravity acceleration, anomaly, potential and gradient at this
+       * satellite.
+       */
+      template <int dim>
+      inline
+      void
+      add_point_mass (const Tensor<1,dim> &r_vector,
+                      const double mass,
+                      const double mass_anomaly,
+                      Tensor<1,dim> &g,
+                      Tensor<1,dim> &g_anomaly,
+                      double &g_potential,
+                      SymmetricTensor<2,dim> &g_gradient)
+      {
+        const double r_squared = r_vector.norm_square();
+        const double one_over_r = 1. / std::sqrt(r_squared);
+        const double one_over_r_cubed = one_over_r * one_over_r * one_over_r;
+        const double one_over_r_to_the_5 = one_over_r_cubed * one_over_r * one_over_r;
+
+        g -= mass * one_over_r_cubed * r_vector;
+        g_anomaly -= mass_anomaly * one_over_r_cubed * r_vector;
+        g_potential -= mass * one_over_r;
+
+        const double grad_KK = mass * one_over_r_to_the_5;
+        for (unsigned int e=0; e<dim; ++e)
+          for (unsigned int f=e; f<dim; ++f)
+            g_gradient[e][f] += grad_KK * (3.0 * r_vector[e] * r_vector[f]
+                                           - (e==f ? r_squared : 0));
+      }
+
+
+
+      /**
+       * Compute the gravity acceleration, anomaly, potential and gradient
+       * at the satellite at @p satellite_position that result from all
+       * masses in @p sources. Cells whose radius is smaller than
+       * @p opening_angle times their distance to the satellite are
+       * replaced by a point mass at their center of mass; for all other
+       * cells, the contributions of their quadrature points are summed up
+       * with SIMD instructions.
+       */
+      template <int dim>
+      void
+      compute_gravity_at_point (const GravitySources<dim> &sources,
+                                const Point<dim> &satellite_position,
+                                const double opening_angle,
+                                Tensor<1,dim> &g,
+                                Tensor<1,dim> &g_anomaly,
+                                double &g_potential,
+                                SymmetricTensor<2,dim> &g_gradient)
+      {
+        using VA = VectorizedArray<double>;
+        constexpr unsigned int n_lanes = VA::size();
+
+        // The sums are stored per SIMD lane. The gradient is symmetric, so
+        // we only sum up its upper triangle.
+        Tensor<1,dim,VA> sum_g;
+        Tensor<1,dim,VA> sum_g_anomaly;
+        VA sum_g_potential = VA(0.);
+        Tensor<2,dim,VA> sum_g_gradient;
+
+        Tensor<1,dim,VA> satellite;
+        for (unsigned int d=0; d<dim; ++d)
+          satellite[d] = VA(satellite_position[d]);
+
+        const double opening_angle_squared = opening_angle * opening_angle;
+        const unsigned int n_cells = sources.cell_center.size();
+
+        for (unsigned int c=0; c<n_cells; ++c)
+          {
+            if (opening_angle > 0)
+              {
+                const Tensor<1,dim> r_vector = satellite_position - sources.cell_center[c];
+                if (sources.cell_radius[c] * sources.cell_radius[c]
+                    < opening_angle_squared * r_vector.norm_square())
+                  {
+                    add_point_mass (r_vector,
+                                    sources.cell_mass[c],
+                                    sources.cell_mass_anomaly[c],
+                                    g, g_anomaly, g_potential, g_gradient);
+                    continue;
+                  }
+              }
+
+            for (unsigned int i=sources.cell_begin[c]; i<sources.cell_begin[c+1]; i+=n_lanes)
+              {
+                VA mass, mass_anomaly;
+                mass.load (&sources.mass[i]);
+                mass_anomaly.load (&sources.mass_anomaly[i]);
+
+                Tensor<1,dim,VA> r;
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    VA x;
+                    x.load (&sources.coordinates[d][i]);
+                    r[d] = satellite[d] - x;
+                  }
+
+                const VA r_squared = r.norm_square();
+                const VA one_over_r = VA(1.) / std::sqrt(r_squared);
+                const VA one_over_r_squared = one_over_r * one_over_r;
+                const VA one_over_r_cubed = one_over_r * one_over_r_squared;
+
+                const VA KK = mass * one_over_r_cubed;
+                const VA KK_anomaly = mass_anomaly * one_over_r_cubed;
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    sum_g[d] -= KK * r[d];
+                    sum_g_anomaly[d] -= KK_anomaly * r[d];
+                  }
+
+                sum_g_potential -= mass * one_over_r;
+
+                const VA grad_KK = KK * one_over_r_squared;
+                for (unsigned int e=0; e<dim; ++e)
+                  {
+                    sum_g_gradient[e][e] += grad_KK * (3. * r[e] * r[e] - r_squared);
+                    for (unsigned int f=e+1; f<dim; ++f)
+                      sum_g_gradient[e][f] += grad_KK * (3. * r[e] * r[f]);
+                  }
+              }
+          }
+
+        // finally add up the contributions of the individual SIMD lanes
+        for (unsigned int v=0; v<n_lanes; ++v)
+          {
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                g[d] += sum_g[d][v];
+                g_anomaly[d] += sum_g_anomaly[d][v];
+              }
+            g_potential += sum_g_potential[v];
+
+            for (unsigned int e=0; e<dim; ++e)
+              for (unsigned int f=e; f<dim; ++f)
+                g_gradient[e][f] += sum_g_gradient[e][f][v];
+          }
+      }
+    }
+
+
 
     template <int dim>
     GravityPointValues<dim>::GravityPointValues ()
@@ -246,15 +434,32 @@ namespace aspect
       std::vector<Tensor<1,dim>>          local_g_anomaly (n_satellites);
       std::vector<SymmetricTensor<2,dim>> local_g_gradient (n_satellites);
 
-      std::vector<double> G_times_density_times_JxW (n_quadrature_points_per_cell);
-      std::vector<double> G_times_density_anomaly_times_JxW (n_quadrature_points_per_cell);
-
       MaterialModel::MaterialModelInputs<dim> in(quadrature_formula.size(),
                                                  this->n_compositional_fields());
       MaterialModel::MaterialModelOutputs<dim> out(quadrature_formula.size(),
                                                    this->n_compositional_fields());
       in.requested_properties = MaterialModel::MaterialProperties::density;
 
+      // First collect the masses of all locally owned quadrature points.
+      // This is independent of the satellite positions, and because we may
+      // have a very large number of satellites, even just one multiplication
+      // that is unnecessarily repeated for each satellite can be expensive.
+      const unsigned int n_lanes = VectorizedArray<double>::size();
+      const unsigned int n_padded_points_per_cell
+        = (n_quadrature_points_per_cell + n_lanes - 1) / n_lanes * n_lanes;
+      const unsigned int n_local_cells = this->get_triangulation().n_locally_owned_active_cells();
+
+      internal::GravitySources<dim> sources;
+      for (unsigned int d=0; d<dim; ++d)
+        sources.coordinates[d].reserve (n_local_cells * n_padded_points_per_cell);
+      sources.mass.reserve (n_local_cells * n_padded_points_per_cell);
+      sources.mass_anomaly.reserve (n_local_cells * n_padded_points_per_cell);
+      sources.cell_begin.reserve (n_local_cells + 1);
+      sources.cell_center.reserve (n_local_cells);
+      sources.cell_radius.reserve (n_local_cells);
+      sources.cell_mass.reserve (n_local_cells);
+      sources.cell_mass_anomaly.reserve (n_local_cells);
+
       for (const auto &cell : this->get_dof_handler().active_cell_iterators())
         if (cell->is_locally_owned())
           {
@@ -264,57 +469,72 @@ namespace aspect
             in.reinit(fe_values, cell, this->introspection(), this->get_solution());
             this->get_material_model().evaluate(in, out);
 
-            // Pull some computations that are independent of the
-            // satellite position out of the following loop. This is
-            // because we may have a very large number of satellites,
-            // so even just one multiplication that is unnecessarily
-            // repeated can be expensive.
+            sources.cell_begin.push_back (sources.mass.size());
+
+            double cell_mass = 0;
+            double cell_mass_anomaly = 0;
+            Tensor<1,dim> first_moment;
             for (unsigned int q = 0; q < n_quadrature_points_per_cell; ++q)
               {
-                G_times_density_times_JxW[q]         = G * out.densities[q] *
-                                                       fe_values.JxW(q);
-                G_times_density_anomaly_times_JxW[q] = G * (out.densities[q]-reference_density) *
-                                                       fe_values.JxW(q);
+                const Point<dim> &position = fe_values.quadrature_point(q);
+                const double mass = G * out.densities[q] * fe_values.JxW(q);
+                const double mass_anomaly = G * (out.densities[q]-reference_density) * fe_values.JxW(q);
+
+                for (unsigned int d=0; d<dim; ++d)
+                  sources.coordinates[d].push_back (position[d]);
+                sources.mass.push_back (mass);
+                sources.mass_anomaly.push_back (mass_anomaly);
+
+                cell_mass += mass;
+                cell_mass_anomaly += mass_anomaly;
+                first_moment += mass * position;
               }
 
-
-            for (unsigned int p=0; p < n_satellites; ++p)
+            // Pad the points of this cell with points without mass. Put
+            // them on top of an existing point so that the distance to a
+            // satellite is never zero.
+            for (unsigned int q = n_quadrature_points_per_cell; q < n_padded_points_per_cell; ++q)
               {
-                const Point<dim> satellite_position = satellite_positions_cartesian[p];
-
-                for (unsigned int q = 0; q < n_quadrature_points_per_cell; ++q)
-                  {
-                    const Tensor<1,dim> r_vector = satellite_position - fe_values.quadrature_point(q);
-
-                    const double r_squared = r_vector.norm_square();
-                    const double r = std::sqrt(r_squared);
-                    const double r_cubed = r * r_squared;
-                    const double one_over_r_cubed = 1. / r_cubed;
-                    const double r_to_the_5 = r_squared * r_cubed;
-
-                    const double G_density_JxW = G_times_density_times_JxW[q];
-
-                    // For gravity acceleration:
-                    const double KK = - G_density_JxW * one_over_r_cubed;
-                    local_g[p] += KK * r_vector;
-
-                    // For gravity anomalies:
-                    const double KK_anomalies = - G_times_density_anomaly_times_JxW[q] * one_over_r_cubed;
-                    local_g_anomaly[p] += KK_anomalies * r_vector;
-
-                    // For gravity potential:
-                    local_g_potential[p] -= G_density_JxW / r;
-
-                    // For gravity gradient:
-                    const double grad_KK = G_density_JxW / r_to_the_5;
-                    for (unsigned int e=0; e<dim; ++e)
-                      for (unsigned int f=e; f<dim; ++f)
-                        local_g_gradient[p][e][f] += grad_KK * (3.0
-                                                                * r_vector[e] * r_vector[f]
-                                                                - (e==f ? r_squared : 0));
-                  }
+                for (unsigned int d=0; d<dim; ++d)
+                  sources.coordinates[d].push_back (fe_values.quadrature_point(0)[d]);
+                sources.mass.push_back (0.);
+                sources.mass_anomaly.push_back (0.);
               }
+
+            // Store what we need for the far field approximation. Densities
+            // are positive, so the center of mass lies inside the cell.
+            const Point<dim> center = (cell_mass > 0
+                                       ?
+                                       Point<dim>(first_moment / cell_mass)
+                                       :
+                                       cell->center());
+            double radius = 0;
+            for (unsigned int q = 0; q < n_quadrature_points_per_cell; ++q)
+              radius = std::max (radius, center.distance(fe_values.quadrature_point(q)));
+
+            sources.cell_center.push_back (center);
+            sources.cell_radius.push_back (radius);
+            sources.cell_mass.push_back (cell_mass);
+            sources.cell_mass_anomaly.push_back (cell_mass_anomaly);
           }
+      sources.cell_begin.push_back (sources.mass.size());
+
+      // Then compute gravity acceleration, potential and gradients at all
+      // satellites. The satellites are independent of each other, so we can
+      // work on them in parallel.
+      parallel::apply_to_subranges (0U, n_satellites,
+                                    [&](const unsigned int begin, const unsigned int end)
+      {
+        for (unsigned int p=begin; p<end; ++p)
+          internal::compute_gravity_at_point<dim> (sources,
+                                              satellite_positions_cartesian[p],
+                                              multipole_opening_angle,
+                                              local_g[p],
+                                              local_g_anomaly[p],
+                                              local_g_potential[p],
+                                              local_g_gradient[p]);
+      },
+      /* grainsize = */ 16);
 
       // Sum local gravity components over global domain and compute
       // some max and mins. We can directly call Utilities::MPI::sum()
@@ -601,6 +821,21 @@ namespace aspect
                              "the surface or inside the model. An increase in the "
                              "quadrature element adds accuracy to the gravity "
                              "solution from noise due to the model grid.");
+          prm.declare_entry ("Multipole opening angle", "0.",
+                             Patterns::Double (0.0, 1.0),
+                             "If this parameter is larger than zero, the masses of "
+                             "all quadrature points of a cell are replaced by a single "
+                             "point mass at their center of mass for all satellites whose "
+                             "distance to this center is larger than the radius of the "
+                             "cell divided by this parameter. This makes the computation "
+                             "for large numbers of satellites much cheaper. The relative "
+                             "error of the contribution of each such cell is bounded by a "
+                             "small multiple of the square of this parameter for the "
+                             "gravity acceleration, potential and gradients, and of the "
+                             "parameter itself for gravity anomalies. A value of zero, "
+                             "the default, disables the approximation and sums up the "
+                             "contributions of all quadrature points exactly. Values "
+                             "around 0.3 are a common choice otherwise.");
           prm.declare_entry ("Number points radius", "1",
                              Patterns::Integer (0),
                              "Parameter for the map sampling scheme: "
@@ -719,6 +954,11 @@ namespace aspect
           else
             AssertThrow (false, ExcMessage ("Not a valid sampling scheme."));
           quadrature_degree_increase = prm.get_integer ("Quadrature degree increase");
+          multipole_opening_angle = prm.get_double ("Multipole opening angle");
+          AssertThrow (multipole_opening_angle < 1.0,
+                       ExcMessage ("The multipole opening angle needs to be smaller than one, "
+                                   "otherwise satellites inside a cell could be treated as "
+                                   "being far away from it."));
           n_points_spiral     = prm.get_integer("Number points fibonacci spiral");
           n_points_radius     = prm.get_integer("Number points radius");
           n_points_longitude  = prm.get_integer("Number points longitude");
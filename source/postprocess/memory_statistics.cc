@@ -58,8 +58,7 @@ namespace aspect
 
       if (this->is_stokes_matrix_free())
         {
-          const double mg_transfer_mem = this->get_stokes_matrix_free().get_mg_transfer_A().memory_consumption()
-                                         + this->get_stokes_matrix_free().get_mg_transfer_S().memory_consumption();
+          const double mg_transfer_mem = this->get_stokes_matrix_free().get_mg_transfer_memory_consumption();
           statistics.add_value ("MGTransfer memory consumption (MB) ", mg_transfer_mem/mb);
 
           const double cell_data_mem = this->get_stokes_matrix_free().get_cell_data_memory_consumption();
@@ -24,7 +24,6 @@
 #include <aspect/geometry_model/sphere.h>
 #include <aspect/geometry_model/spherical_shell.h>
 #include <aspect/global.h>
-#include <deal.II/numerics/vector_tools.h>
 
 #include <cmath>
 
@@ -45,6 +44,28 @@ namespace aspect
       use_natural_coordinates (false)
     {}
 
+
+
+    template <int dim>
+    void
+    PointValues<dim>::initialize ()
+    {
+      // the cells around the evaluation points change if the mesh
+      // is refined or deformed
+      this->get_triangulation().signals.post_refinement.connect(
+        [&]()
+      {
+        point_value_evaluator.clear();
+      });
+
+      this->get_signals().post_mesh_deformation.connect(
+        [&](const SimulatorAccess<dim> &)
+      {
+        point_value_evaluator.clear();
+      });
+    }
+
+
     template <int dim>
     std::pair<std::string,std::string>
     PointValues<dim>::execute (TableHandler &)
@@ -64,52 +85,17 @@ namespace aspect
       current_point_values (evaluation_points_cartesian.size(),
                             Vector<double> (this->introspection().n_components));
 
-      for (unsigned int p=0; p<evaluation_points_cartesian.size(); ++p)
-        {
-          // try to evaluate the solution at this point. in parallel, the point
-          // will be on only one processor's owned cells, so the others are
-          // going to throw an exception. make sure at least one processor
-          // finds the given point
-          bool point_found = false;
-
-          try
-            {
-              VectorTools::point_value(this->get_mapping(),
-                                       this->get_dof_handler(),
-                                       this->get_solution(),
-                                       evaluation_points_cartesian[p],
-                                       current_point_values[p]);
-              point_found = true;
-            }
-          catch (const VectorTools::ExcPointNotAvailableHere &)
-            {
-              // ignore
-            }
-
-          // ensure that at least one processor found things
-          const int n_procs = Utilities::MPI::sum (point_found ? 1 : 0, this->get_mpi_communicator());
-          AssertThrow (n_procs > 0,
-                       ExcMessage ("While trying to evaluate the solution at point " +
-                                   Utilities::to_string(evaluation_points_cartesian[p][0]) + ", " +
-                                   Utilities::to_string(evaluation_points_cartesian[p][1]) +
-                                   (dim == 3
-                                    ?
-                                    ", " + Utilities::to_string(evaluation_points_cartesian[p][2])
-                                    :
-                                    "") + "), " +
-                                   "no processors reported that the point lies inside the " +
-                                   "set of cells they own. Are you trying to evaluate the " +
-                                   "solution at a point that lies outside of the domain?"
-                                  ));
-
-          // Reduce all collected values into local Vector
-          Utilities::MPI::sum (current_point_values[p], this->get_mpi_communicator(),
-                               current_point_values[p]);
-
-          // Normalize in cases where points are claimed by multiple processors
-          if (n_procs > 1)
-            current_point_values[p] /= n_procs;
-        }
+      // locate the evaluation points if the mesh has changed since the
+      // last time we got here, then evaluate the solution only on the
+      // processes that own the points
+      if (point_value_evaluator.is_initialized() == false)
+        point_value_evaluator.reinit (evaluation_points_cartesian,
+                                      this->get_mapping(),
+                                      this->get_dof_handler(),
+                                      this->get_mpi_communicator());
+
+      point_value_evaluator.evaluate (this->get_solution(),
+                                      current_point_values);
 
       // finally push these point values all onto the list we keep
       point_values.emplace_back (this->get_time(), current_point_values);
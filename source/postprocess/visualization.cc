@@ -262,6 +262,22 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      Interface<dim>::get_needed_material_properties () const
+      {
+        return MaterialModel::MaterialProperties::uninitialized;
+      }
+
+
+
+      template <int dim>
+      void
+      Interface<dim>::create_additional_material_model_outputs (MaterialModel::MaterialModelOutputs<dim> &) const
+      {}
+
+
+
       template <int dim>
       void
       Interface<dim>::save (std::map<std::string,std::string> &) const
@@ -280,6 +296,32 @@ namespace aspect
         :
         Interface<dim> (physical_units)
       {}
+
+
+
+      template <int dim>
+      MaterialModelEvaluation<dim>::MaterialModelEvaluation (const DataPostprocessorInputs::Vector<dim> &input_data,
+                                                             const Introspection<dim> &introspection)
+        :
+        cell (input_data.template get_cell<dim>()),
+        evaluation_points (input_data.evaluation_points),
+        solution_values (input_data.solution_values),
+        solution_gradients (input_data.solution_gradients),
+        inputs (input_data, introspection),
+        outputs (input_data.solution_values.size(), introspection.n_compositional_fields)
+      {}
+
+
+
+      template <int dim>
+      bool
+      MaterialModelEvaluation<dim>::matches (const DataPostprocessorInputs::Vector<dim> &input_data) const
+      {
+        return (cell == input_data.template get_cell<dim>()
+                && evaluation_points == input_data.evaluation_points
+                && solution_values == input_data.solution_values
+                && solution_gradients == input_data.solution_gradients);
+      }
     }
 
 
@@ -339,7 +381,8 @@ namespace aspect
       last_output_time (std::numeric_limits<double>::quiet_NaN()),
       maximum_timesteps_between_outputs (std::numeric_limits<int>::max()),
       last_output_timestep (numbers::invalid_unsigned_int),
-      output_file_number (numbers::invalid_unsigned_int)
+      output_file_number (numbers::invalid_unsigned_int),
+      material_model_properties (MaterialModel::MaterialProperties::uninitialized)
     {}
 
 
@@ -1026,6 +1069,10 @@ namespace aspect
                                 + face_solution_file_prefix);
         }
 
+      // The material model evaluations of the last cells are not needed
+      // any more, and would be out of date at the next output.
+      material_model_evaluations.clear();
+
       // Increment the next time we need output:
       set_last_output_time (this->get_time());
       last_output_timestep = this->get_timestep_number();
@@ -1501,6 +1548,9 @@ namespace aspect
 
           postprocessors.back()->parse_parameters (prm);
           postprocessors.back()->initialize ();
+
+          material_model_properties = material_model_properties
+                                      | postprocessors.back()->get_needed_material_properties();
         }
 
       // Finally also set up a listener to check when the mesh changes
@@ -1625,6 +1675,39 @@ namespace aspect
 
 
 
+    template <int dim>
+    const VisualizationPostprocessors::MaterialModelEvaluation<dim> &
+    Visualization<dim>::get_material_model_evaluation (const DataPostprocessorInputs::Vector<dim> &input_data) const
+    {
+      Assert (material_model_properties != MaterialModel::MaterialProperties::uninitialized,
+              ExcMessage ("A visualization postprocessor asked for the shared material model "
+                          "evaluation, but no active visualization postprocessor needs any "
+                          "material properties. The postprocessor needs to implement the "
+                          "get_needed_material_properties() function."));
+
+      // DataOut evaluates all postprocessors for one cell after each other on
+      // the same thread, so only the previous evaluation on this thread can
+      // be reused.
+      std::unique_ptr<VisualizationPostprocessors::MaterialModelEvaluation<dim>> &evaluation
+        = material_model_evaluations.get();
+
+      if (evaluation == nullptr || evaluation->matches(input_data) == false)
+        {
+          evaluation = std::make_unique<VisualizationPostprocessors::MaterialModelEvaluation<dim>>(input_data,
+                       this->introspection());
+          evaluation->inputs.requested_properties = material_model_properties;
+
+          for (const auto &p : postprocessors)
+            p->create_additional_material_model_outputs(evaluation->outputs);
+
+          this->get_material_model().evaluate(evaluation->inputs, evaluation->outputs);
+        }
+
+      return *evaluation;
+    }
+
+
+
     template <int dim>
     void
     Visualization<dim>::write_plugin_graph (std::ostream &out)
@@ -1654,7 +1737,8 @@ namespace aspect
     {
 #define INSTANTIATE(dim) \
   template class Interface<dim>; \
-  template class CellDataVectorCreator<dim>;
+  template class CellDataVectorCreator<dim>; \
+  template struct MaterialModelEvaluation<dim>;
 
       ASPECT_INSTANTIATE(INSTANTIATE)
 
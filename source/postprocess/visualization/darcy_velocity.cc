@@ -54,6 +54,24 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      DarcyVelocity<dim>::get_needed_material_properties () const
+      {
+        return MaterialModel::MaterialProperties::all_properties;
+      }
+
+
+
+      template <int dim>
+      void
+      DarcyVelocity<dim>::create_additional_material_model_outputs (MaterialModel::MaterialModelOutputs<dim> &outputs) const
+      {
+        MeltHandler<dim>::create_material_model_outputs(outputs);
+      }
+
+
+
       template <int dim>
       void
       DarcyVelocity<dim>::
@@ -69,11 +87,13 @@ namespace aspect
         const double velocity_scaling_factor =
           this->convert_output_to_years() ? year_in_seconds : 1.0;
 
-        MaterialModel::MaterialModelInputs<dim> in(input_data, this->introspection());
-        MaterialModel::MaterialModelOutputs<dim> out(in.n_evaluation_points(), this->n_compositional_fields());
-        MeltHandler<dim>::create_material_model_outputs(out);
-        this->get_material_model().evaluate(in, out);
-        MaterialModel::MeltOutputs<dim> *fluid_out = out.template get_additional_output<MaterialModel::MeltOutputs<dim>>();
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelInputs<dim> &in = material_model_evaluation.inputs;
+        const MaterialModel::MaterialModelOutputs<dim> &out = material_model_evaluation.outputs;
+        const MaterialModel::MeltOutputs<dim> *fluid_out = out.template get_additional_output<MaterialModel::MeltOutputs<dim>>();
         AssertThrow(std::isfinite(fluid_out->fluid_viscosities[0]),
                     ExcMessage("To compute the Darcy velocity the material model needs to provide the melt material model "
                                "outputs. At least the fluid viscosity was not computed, or is not a number."));
@@ -100,6 +100,44 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      MaterialProperties<dim>::get_needed_material_properties () const
+      {
+        MaterialModel::MaterialProperties::Property needed_properties = MaterialModel::MaterialProperties::none;
+
+        for (const auto &property_name : property_names)
+          {
+            if (property_name == "viscosity")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::viscosity;
+            else if (property_name == "density")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::density;
+            else if (property_name == "thermal expansivity")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::thermal_expansion_coefficient;
+            else if (property_name == "specific heat")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::specific_heat;
+            else if (property_name == "thermal conductivity")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::thermal_conductivity;
+            else if (property_name == "thermal diffusivity")
+              needed_properties = needed_properties
+                                  | MaterialModel::MaterialProperties::thermal_conductivity
+                                  | MaterialModel::MaterialProperties::density
+                                  | MaterialModel::MaterialProperties::specific_heat;
+            else if (property_name == "compressibility")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::compressibility;
+            else if (property_name == "entropy derivative pressure")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::entropy_derivative_pressure;
+            else if (property_name == "entropy derivative temperature")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::entropy_derivative_temperature;
+            else if (property_name == "reaction terms")
+              needed_properties = needed_properties | MaterialModel::MaterialProperties::reaction_terms;
+          }
+
+        return needed_properties;
+      }
+
+
+
       template <int dim>
       void
       MaterialProperties<dim>::
@@ -112,12 +150,25 @@ namespace aspect
         Assert (input_data.solution_values[0].size() == this->introspection().n_components,
                 ExcInternalError());
 
-        MaterialModel::MaterialModelInputs<dim> in(input_data,
-                                                   this->introspection());
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelInputs<dim> &in = material_model_evaluation.inputs;
+
+        // The averaging below modifies the outputs, so work on a copy of
+        // the shared ones
         MaterialModel::MaterialModelOutputs<dim> out(n_quadrature_points,
                                                      this->n_compositional_fields());
-
-        this->get_material_model().evaluate(in, out);
+        out.viscosities = material_model_evaluation.outputs.viscosities;
+        out.densities = material_model_evaluation.outputs.densities;
+        out.thermal_expansion_coefficients = material_model_evaluation.outputs.thermal_expansion_coefficients;
+        out.specific_heat = material_model_evaluation.outputs.specific_heat;
+        out.thermal_conductivities = material_model_evaluation.outputs.thermal_conductivities;
+        out.compressibilities = material_model_evaluation.outputs.compressibilities;
+        out.entropy_derivative_pressure = material_model_evaluation.outputs.entropy_derivative_pressure;
+        out.entropy_derivative_temperature = material_model_evaluation.outputs.entropy_derivative_temperature;
+        out.reaction_terms = material_model_evaluation.outputs.reaction_terms;
 
         // We want to output material properties as they are used in the
         // program during assembly. To do so, some of the material averaging
@@ -142,7 +193,7 @@ namespace aspect
                                                      input_data.template get_cell<dim>(),
                                                      Quadrature<dim>(),
                                                      this->get_mapping(),
-                                                     in.requested_properties,
+                                                     get_needed_material_properties(),
                                                      out);
 
         std::vector<double> melt_fractions(n_quadrature_points);
@@ -106,6 +106,24 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      MeltMaterialProperties<dim>::get_needed_material_properties () const
+      {
+        return MaterialModel::MaterialProperties::all_properties;
+      }
+
+
+
+      template <int dim>
+      void
+      MeltMaterialProperties<dim>::create_additional_material_model_outputs (MaterialModel::MaterialModelOutputs<dim> &outputs) const
+      {
+        MeltHandler<dim>::create_material_model_outputs(outputs);
+      }
+
+
+
       template <int dim>
       void
       MeltMaterialProperties<dim>::
@@ -119,14 +137,13 @@ namespace aspect
         Assert (computed_quantities.size() == n_quadrature_points,    ExcInternalError());
         Assert (input_data.solution_values[0].size() == this->introspection().n_components,   ExcInternalError());
 
-        // Set use_strain_rates to true since the compaction viscosity might also depend on the strain rate.
-        MaterialModel::MaterialModelInputs<dim> in(input_data,
-                                                   this->introspection());
-        MaterialModel::MaterialModelOutputs<dim> out(n_quadrature_points, this->n_compositional_fields());
-        MeltHandler<dim>::create_material_model_outputs(out);
-
-        this->get_material_model().evaluate(in, out);
-        MaterialModel::MeltOutputs<dim> *melt_outputs = out.template get_additional_output<MaterialModel::MeltOutputs<dim>>();
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelInputs<dim> &in = material_model_evaluation.inputs;
+        const MaterialModel::MaterialModelOutputs<dim> &out = material_model_evaluation.outputs;
+        const MaterialModel::MeltOutputs<dim> *melt_outputs = out.template get_additional_output<MaterialModel::MeltOutputs<dim>>();
         AssertThrow(melt_outputs != nullptr,
                     ExcMessage("Need MeltOutputs from the material model for computing the melt properties."));
 
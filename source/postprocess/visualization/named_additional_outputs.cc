@@ -24,6 +24,7 @@
 #include <aspect/utilities.h>
 
 #include <algorithm>
+#include <typeinfo>
 
 
 namespace aspect
@@ -111,6 +112,26 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      NamedAdditionalOutputs<dim>::get_needed_material_properties () const
+      {
+        // Material models may only compute some of their additional outputs
+        // together with the properties they depend on.
+        return MaterialModel::MaterialProperties::all_properties;
+      }
+
+
+
+      template <int dim>
+      void
+      NamedAdditionalOutputs<dim>::create_additional_material_model_outputs (MaterialModel::MaterialModelOutputs<dim> &outputs) const
+      {
+        this->get_material_model().create_additional_named_outputs(outputs);
+      }
+
+
+
       template <int dim>
       void
       NamedAdditionalOutputs<dim>::
@@ -123,32 +144,42 @@ namespace aspect
         Assert (input_data.solution_values[0].size() == this->introspection().n_components,
                 ExcInternalError());
 
-        MaterialModel::MaterialModelInputs<dim> in(input_data,
-                                                   this->introspection());
-        MaterialModel::MaterialModelOutputs<dim> out(n_quadrature_points,
-                                                     this->n_compositional_fields());
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelOutputs<dim> &out = material_model_evaluation.outputs;
 
-        this->get_material_model().create_additional_named_outputs(out);
-        this->get_material_model().evaluate(in, out);
+        // The shared evaluation can also contain additional outputs that
+        // other postprocessors requested. Only output the named outputs
+        // the material model creates, in the order it creates them.
+        MaterialModel::MaterialModelOutputs<dim> named_outputs(0,
+                                                               this->n_compositional_fields());
+        this->get_material_model().create_additional_named_outputs(named_outputs);
 
         unsigned int field_index = 0;
-        for (unsigned int k=0; k<out.additional_outputs.size(); ++k)
-          {
-            const MaterialModel::NamedAdditionalMaterialOutputs<dim> *result
-              = dynamic_cast<const MaterialModel::NamedAdditionalMaterialOutputs<dim> *> (out.additional_outputs[k].get());
-
-            if (result)
-              {
-                std::vector<double> outputs(n_quadrature_points);
-                for (unsigned int i=0; i<result->get_names().size(); ++i, ++field_index)
-                  {
-                    outputs = result->get_nth_output(i);
-
-                    for (unsigned int q=0; q<n_quadrature_points; ++q)
-                      computed_quantities[q][field_index] = outputs[q];
-                  }
-              }
-          }
+        for (const auto &named_output : named_outputs.additional_outputs)
+          for (const auto &additional_output : out.additional_outputs)
+            {
+              if (typeid(*additional_output) != typeid(*named_output))
+                continue;
+
+              const MaterialModel::NamedAdditionalMaterialOutputs<dim> *result
+                = dynamic_cast<const MaterialModel::NamedAdditionalMaterialOutputs<dim> *> (additional_output.get());
+
+              if (result)
+                {
+                  std::vector<double> outputs(n_quadrature_points);
+                  for (unsigned int i=0; i<result->get_names().size(); ++i, ++field_index)
+                    {
+                      outputs = result->get_nth_output(i);
+
+                      for (unsigned int q=0; q<n_quadrature_points; ++q)
+                        computed_quantities[q][field_index] = outputs[q];
+                    }
+                }
+              break;
+            }
       }
     }
   }
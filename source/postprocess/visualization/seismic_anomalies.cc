@@ -418,6 +418,10 @@ namespace aspect
           prm.leave_subsection();
         }
         prm.leave_subsection();
+
+        if (average_velocity_scheme == lateral_average)
+          this->get_lateral_averaging().register_lateral_averages(n_slices,
+                                                                  std::vector<std::string>(1,"Vs"));
       }
 
 
@@ -497,6 +501,10 @@ namespace aspect
           prm.leave_subsection();
         }
         prm.leave_subsection();
+
+        if (average_velocity_scheme == lateral_average)
+          this->get_lateral_averaging().register_lateral_averages(n_slices,
+                                                                  std::vector<std::string>(1,"Vp"));
       }
     }
   }
@@ -42,6 +42,26 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      SPD_Factor<dim>::get_needed_material_properties () const
+      {
+        return MaterialModel::MaterialProperties::viscosity | MaterialModel::MaterialProperties::additional_outputs;
+      }
+
+
+
+      template <int dim>
+      void
+      SPD_Factor<dim>::create_additional_material_model_outputs (MaterialModel::MaterialModelOutputs<dim> &outputs) const
+      {
+        if (outputs.template get_additional_output<MaterialModel::MaterialModelDerivatives<dim>>() == nullptr)
+          outputs.additional_outputs.push_back(
+            std::make_unique<MaterialModel::MaterialModelDerivatives<dim>> (outputs.n_evaluation_points()));
+      }
+
+
+
       template <int dim>
       void
       SPD_Factor<dim>::
@@ -54,16 +74,12 @@ namespace aspect
         Assert (input_data.solution_values[0].size() == this->introspection().n_components,    ExcInternalError());
         Assert (input_data.solution_gradients[0].size() == this->introspection().n_components, ExcInternalError());
 
-        MaterialModel::MaterialModelInputs<dim> in(input_data,
-                                                   this->introspection());
-        MaterialModel::MaterialModelOutputs<dim> out(n_quadrature_points,
-                                                     this->n_compositional_fields());
-        in.requested_properties = MaterialModel::MaterialProperties::viscosity | MaterialModel::MaterialProperties::additional_outputs;
-
-        out.additional_outputs.push_back(
-          std::make_unique<MaterialModel::MaterialModelDerivatives<dim>> (n_quadrature_points));
-
-        this->get_material_model().evaluate(in, out);
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelInputs<dim> &in = material_model_evaluation.inputs;
+        const MaterialModel::MaterialModelOutputs<dim> &out = material_model_evaluation.outputs;
 
         const MaterialModel::MaterialModelDerivatives<dim> *derivatives = out.template get_additional_output<MaterialModel::MaterialModelDerivatives<dim>>();
 
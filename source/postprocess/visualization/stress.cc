@@ -40,6 +40,15 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      Stress<dim>::get_needed_material_properties () const
+      {
+        return MaterialModel::MaterialProperties::viscosity;
+      }
+
+
+
       template <int dim>
       void
       Stress<dim>::
@@ -53,16 +62,14 @@ namespace aspect
         Assert (input_data.solution_values[0].size() == this->introspection().n_components,   ExcInternalError());
         Assert (input_data.solution_gradients[0].size() == this->introspection().n_components,  ExcInternalError());
 
-        MaterialModel::MaterialModelInputs<dim> in(input_data,
-                                                   this->introspection());
-        MaterialModel::MaterialModelOutputs<dim> out(n_quadrature_points,
-                                                     this->n_compositional_fields());
-
-        // We do not need to compute anything but the viscosity
-        in.requested_properties = MaterialModel::MaterialProperties::viscosity;
-
-        // Compute the viscosity...
-        this->get_material_model().evaluate(in, out);
+        // Get the viscosity from the material model evaluation that all
+        // visualization postprocessors share...
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelInputs<dim> &in = material_model_evaluation.inputs;
+        const MaterialModel::MaterialModelOutputs<dim> &out = material_model_evaluation.outputs;
 
         // ...and use it to compute the stresses
         for (unsigned int q=0; q<n_quadrature_points; ++q)
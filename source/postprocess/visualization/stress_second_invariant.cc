@@ -41,6 +41,15 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      StressSecondInvariant<dim>::get_needed_material_properties () const
+      {
+        return MaterialModel::MaterialProperties::viscosity;
+      }
+
+
+
       template <int dim>
       void
       StressSecondInvariant<dim>::
@@ -55,15 +64,14 @@ namespace aspect
 
         // Create the material model inputs and outputs to
         // retrieve the current viscosity.
-        MaterialModel::MaterialModelInputs<dim> in(input_data,
-                                                   this->introspection());
-
-        in.requested_properties = MaterialModel::MaterialProperties::viscosity;
-
-        MaterialModel::MaterialModelOutputs<dim> out(n_quadrature_points,
-                                                     this->n_compositional_fields());
-
-        this->get_material_model().evaluate(in, out);
+        // Get the viscosity from the material model evaluation that all
+        // visualization postprocessors share.
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelInputs<dim> &in = material_model_evaluation.inputs;
+        const MaterialModel::MaterialModelOutputs<dim> &out = material_model_evaluation.outputs;
 
         for (unsigned int q = 0; q < n_quadrature_points; ++q)
           {
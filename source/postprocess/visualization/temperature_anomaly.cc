@@ -165,6 +165,9 @@ namespace aspect
           prm.leave_subsection();
         }
         prm.leave_subsection();
+
+        this->get_lateral_averaging().register_lateral_averages(n_slices,
+                                                                std::vector<std::string>(1,"temperature"));
       }
     }
   }
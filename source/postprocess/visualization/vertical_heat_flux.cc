@@ -40,6 +40,17 @@ namespace aspect
 
 
 
+      template <int dim>
+      MaterialModel::MaterialProperties::Property
+      VerticalHeatFlux<dim>::get_needed_material_properties () const
+      {
+        return MaterialModel::MaterialProperties::density |
+               MaterialModel::MaterialProperties::specific_heat |
+               MaterialModel::MaterialProperties::thermal_conductivity;
+      }
+
+
+
       template <int dim>
       void
       VerticalHeatFlux<dim>::
@@ -59,15 +70,12 @@ namespace aspect
             temperature_gradient[q][d] = input_data.solution_gradients[q][this->introspection().component_indices.temperature][d];
 
 
-        MaterialModel::MaterialModelInputs<dim> in(input_data,
-                                                   this->introspection());
-        MaterialModel::MaterialModelOutputs<dim> out(n_quadrature_points,
-                                                     this->n_compositional_fields());
-        in.requested_properties = MaterialModel::MaterialProperties::density |
-                                  MaterialModel::MaterialProperties::specific_heat |
-                                  MaterialModel::MaterialProperties::thermal_conductivity;
-
-        this->get_material_model().evaluate(in, out);
+        const Postprocess::Visualization<dim> &visualization
+          = this->get_postprocess_manager().template get_matching_active_plugin<Postprocess::Visualization<dim>>();
+        const MaterialModelEvaluation<dim> &material_model_evaluation
+          = visualization.get_material_model_evaluation(input_data);
+        const MaterialModel::MaterialModelInputs<dim> &in = material_model_evaluation.inputs;
+        const MaterialModel::MaterialModelOutputs<dim> &out = material_model_evaluation.outputs;
 
         for (unsigned int q=0; q<n_quadrature_points; ++q)
           {
@@ -50,10 +50,14 @@ namespace aspect
     AsciiData<dim>::
     stokes_solution (const Point<dim> &position, Vector<double> &value) const
     {
-      value(0) = Utilities::AsciiDataInitial<dim>::get_data_component(position,0);
-      value(1) = Utilities::AsciiDataInitial<dim>::get_data_component(position,1);
-      if (dim == 3)
-        value(2) = Utilities::AsciiDataInitial<dim>::get_data_component(position,2);
+      std::vector<unsigned int> components(dim);
+      std::vector<double> velocity_values;
+      for (unsigned int d=0; d<dim; ++d)
+        components[d] = d;
+      Utilities::AsciiDataInitial<dim>::get_data_components(position, components, velocity_values);
+
+      for (unsigned int d=0; d<dim; ++d)
+        value(d) = velocity_values[d];
       value(dim) = 0;  // makes pressure 0, must set pressure
     }
 
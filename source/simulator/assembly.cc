@@ -875,48 +875,11 @@ namespace aspect
 
   template <int dim>
   void Simulator<dim>::
-  local_assemble_advection_system (const AdvectionField     &advection_field,
-                                   const Vector<double>           &viscosity_per_cell,
-                                   const typename DoFHandler<dim>::active_cell_iterator &cell,
-                                   internal::Assembly::Scratch::AdvectionSystem<dim> &scratch,
-                                   internal::Assembly::CopyData::AdvectionSystem<dim> &data)
+  local_prepare_advection_system (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                  internal::Assembly::Scratch::AdvectionSystem<dim> &scratch)
   {
-    // also have the number of dofs that correspond just to the element for
-    // the system we are currently trying to assemble
-    const unsigned int advection_dofs_per_cell = data.local_dof_indices.size();
-
-    Assert (advection_dofs_per_cell < scratch.finite_element_values.get_fe().dofs_per_cell, ExcInternalError());
-    Assert (scratch.grad_phi_field.size() == advection_dofs_per_cell, ExcInternalError());
-    Assert (scratch.phi_field.size() == advection_dofs_per_cell, ExcInternalError());
-
-    const FEValuesExtractors::Scalar solution_field = advection_field.scalar_extractor(introspection);
-
-    const unsigned int solution_component = advection_field.component_index(introspection);
-
     scratch.reinit(cell);
 
-    // get all dof indices on the current cell, then extract those
-    // that correspond to the solution_field we are interested in
-    cell->get_dof_indices (scratch.local_dof_indices);
-    for (unsigned int i=0, i_advection=0; i_advection<advection_dofs_per_cell; /*increment at end of loop*/)
-      {
-        if (finite_element.system_to_component_index(i).first == solution_component)
-          {
-            data.local_dof_indices[i_advection] = scratch.local_dof_indices[i];
-            ++i_advection;
-          }
-        ++i;
-      }
-
-    data.local_matrix = 0;
-    data.local_rhs = 0;
-
-    scratch.finite_element_values[solution_field].get_function_values (old_solution,
-                                                                       scratch.old_field_values);
-    scratch.finite_element_values[solution_field].get_function_values (old_old_solution,
-                                                                       scratch.old_old_field_values);
-
-
     scratch.finite_element_values[introspection.extractors.velocities].get_function_values(current_linearization_point,
         scratch.current_velocity_values);
 
@@ -988,6 +951,66 @@ namespace aspect
     heating_model_manager.evaluate(scratch.material_model_inputs,
                                    scratch.material_model_outputs,
                                    scratch.heating_model_outputs);
+  }
+
+
+
+  template <int dim>
+  void Simulator<dim>::
+  local_assemble_advection_system (const AdvectionField     &advection_field,
+                                   const Vector<double>           &viscosity_per_cell,
+                                   const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                   internal::Assembly::Scratch::AdvectionSystem<dim> &scratch,
+                                   internal::Assembly::CopyData::AdvectionSystem<dim> &data)
+  {
+    local_prepare_advection_system (cell, scratch);
+    local_assemble_advection_field (advection_field, viscosity_per_cell, cell, scratch, data);
+  }
+
+
+
+  template <int dim>
+  void Simulator<dim>::
+  local_assemble_advection_field (const AdvectionField     &advection_field,
+                                  const Vector<double>           &viscosity_per_cell,
+                                  const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                  internal::Assembly::Scratch::AdvectionSystem<dim> &scratch,
+                                  internal::Assembly::CopyData::AdvectionSystem<dim> &data)
+  {
+    // also have the number of dofs that correspond just to the element for
+    // the system we are currently trying to assemble
+    const unsigned int advection_dofs_per_cell = data.local_dof_indices.size();
+
+    Assert (advection_dofs_per_cell < scratch.finite_element_values.get_fe().dofs_per_cell, ExcInternalError());
+    Assert (scratch.grad_phi_field.size() == advection_dofs_per_cell, ExcInternalError());
+    Assert (scratch.phi_field.size() == advection_dofs_per_cell, ExcInternalError());
+
+    const FEValuesExtractors::Scalar solution_field = advection_field.scalar_extractor(introspection);
+
+    const unsigned int solution_component = advection_field.component_index(introspection);
+
+    scratch.advection_field = &advection_field;
+
+    // get all dof indices on the current cell, then extract those
+    // that correspond to the solution_field we are interested in
+    cell->get_dof_indices (scratch.local_dof_indices);
+    for (unsigned int i=0, i_advection=0; i_advection<advection_dofs_per_cell; /*increment at end of loop*/)
+      {
+        if (finite_element.system_to_component_index(i).first == solution_component)
+          {
+            data.local_dof_indices[i_advection] = scratch.local_dof_indices[i];
+            ++i_advection;
+          }
+        ++i;
+      }
+
+    data.local_matrix = 0;
+    data.local_rhs = 0;
+
+    scratch.finite_element_values[solution_field].get_function_values (old_solution,
+                                                                       scratch.old_field_values);
+    scratch.finite_element_values[solution_field].get_function_values (old_old_solution,
+                                                                       scratch.old_old_field_values);
 
     // TODO: Compute artificial viscosity once per timestep instead of each time
     // temperature system is assembled (as this might happen more than once per
@@ -1256,6 +1279,108 @@ namespace aspect
     system_matrix.compress(VectorOperation::add);
     system_rhs.compress(VectorOperation::add);
   }
+
+
+
+  template <int dim>
+  void Simulator<dim>::assemble_advection_systems (const std::vector<AdvectionField> &advection_fields)
+  {
+    Assert (advection_fields.size() > 0, ExcInternalError());
+
+    TimerOutput::Scope timer (computing_timer, (advection_fields[0].is_temperature() ?
+                                                "Assemble temperature system" :
+                                                "Assemble composition system"));
+
+    const unsigned int n_fields = advection_fields.size();
+    std::vector<Vector<double>> viscosity_per_cell (n_fields);
+
+    for (unsigned int f=0; f<n_fields; ++f)
+      {
+        const AdvectionField &advection_field = advection_fields[f];
+
+        Assert (advection_field.base_element(introspection) == advection_fields[0].base_element(introspection),
+                ExcMessage ("All advection fields that are assembled together need to use the same finite element."));
+        Assert (!assemblers->advection_system_assembler_on_face_properties[advection_field.field_index()].need_face_finite_element_evaluation,
+                ExcMessage ("Advection fields with face terms can not be assembled together with other fields."));
+
+        const unsigned int block_idx = advection_field.block_index(introspection);
+        const unsigned int sparsity_block_idx = advection_field.sparsity_pattern_block_index(introspection);
+
+        // As in assemble_advection_system(), allocate the matrix blocks that
+        // share their sparsity pattern with another block. Here, all of them
+        // are allocated at the same time, and they are freed again after
+        // the corresponding field has been solved.
+        if (!advection_field.is_temperature() && sparsity_block_idx != block_idx)
+          system_matrix.block(block_idx, block_idx).reinit(system_matrix.block(sparsity_block_idx, sparsity_block_idx));
+
+        system_matrix.block(block_idx, block_idx) = 0;
+        system_rhs.block(block_idx) = 0;
+
+        viscosity_per_cell[f].reinit(triangulation.n_active_cells());
+        get_artificial_viscosity(viscosity_per_cell[f], advection_field);
+      }
+
+    using CellFilter = FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+
+    // See assemble_advection_system() for the choice of quadrature formula.
+    const unsigned int advection_quadrature_degree = advection_fields[0].polynomial_degree(introspection)
+                                                     +
+                                                     (parameters.stokes_velocity_degree+1)/2;
+
+    const bool use_supg = (parameters.advection_stabilization_method
+                           == Parameters<dim>::AdvectionStabilizationMethod::supg);
+
+    const UpdateFlags update_flags = update_values |
+                                     update_gradients |
+                                     update_quadrature_points |
+                                     update_JxW_values |
+                                     ((use_supg) ? update_hessians : UpdateFlags(0));
+
+    // Evaluate the material model and the heating models once per cell,
+    // then assemble the cell terms of every field from these values
+    auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                      internal::Assembly::Scratch::AdvectionSystem<dim> &scratch,
+                      std::vector<internal::Assembly::CopyData::AdvectionSystem<dim>> &data)
+    {
+      this->local_prepare_advection_system(cell, scratch);
+
+      for (unsigned int f=0; f<n_fields; ++f)
+        this->local_assemble_advection_field(advection_fields[f], viscosity_per_cell[f], cell, scratch, data[f]);
+    };
+
+    auto copier = [&](const std::vector<internal::Assembly::CopyData::AdvectionSystem<dim>> &data)
+    {
+      for (unsigned int f=0; f<n_fields; ++f)
+        this->copy_local_to_global_advection_system(advection_fields[f], data[f]);
+    };
+
+    const FiniteElement<dim> &advection_element = finite_element.base_element(advection_fields[0].base_element(introspection));
+
+    WorkStream::
+    run (CellFilter (IteratorFilters::LocallyOwnedCell(),
+                     dof_handler.begin_active()),
+         CellFilter (IteratorFilters::LocallyOwnedCell(),
+                     dof_handler.end()),
+         worker,
+         copier,
+         internal::Assembly::Scratch::
+         AdvectionSystem<dim> (finite_element,
+                               advection_element,
+                               *mapping,
+                               QGauss<dim>(advection_quadrature_degree),
+                               Quadrature<dim-1> (),
+                               update_flags,
+                               update_default,
+                               introspection.n_compositional_fields,
+                               advection_fields[0]),
+         std::vector<internal::Assembly::CopyData::AdvectionSystem<dim>>
+         (n_fields,
+          internal::Assembly::CopyData::AdvectionSystem<dim> (advection_element,
+                                                              false)));
+
+    system_matrix.compress(VectorOperation::add);
+    system_rhs.compress(VectorOperation::add);
+  }
 }
 
 
@@ -1283,6 +1408,15 @@ namespace aspect
   template void Simulator<dim>::build_advection_preconditioner (const AdvectionField &, \
                                                                 aspect::LinearAlgebra::PreconditionILU &preconditioner, \
                                                                 const double diagonal_strengthening); \
+  template void Simulator<dim>::local_prepare_advection_system ( \
+                                                                 const DoFHandler<dim>::active_cell_iterator &cell, \
+                                                                 internal::Assembly::Scratch::AdvectionSystem<dim>  &scratch); \
+  template void Simulator<dim>::local_assemble_advection_field ( \
+                                                                 const AdvectionField          &advection_field, \
+                                                                 const Vector<double>           &viscosity_per_cell, \
+                                                                 const DoFHandler<dim>::active_cell_iterator &cell, \
+                                                                 internal::Assembly::Scratch::AdvectionSystem<dim>  &scratch, \
+                                                                 internal::Assembly::CopyData::AdvectionSystem<dim> &data); \
   template void Simulator<dim>::local_assemble_advection_system ( \
                                                                   const AdvectionField          &advection_field, \
                                                                   const Vector<double>           &viscosity_per_cell, \
@@ -1292,7 +1426,8 @@ namespace aspect
   template void Simulator<dim>::copy_local_to_global_advection_system ( \
                                                                         const AdvectionField          &advection_field, \
                                                                         const internal::Assembly::CopyData::AdvectionSystem<dim> &data); \
-  template void Simulator<dim>::assemble_advection_system (const AdvectionField     &advection_field);
+  template void Simulator<dim>::assemble_advection_system (const AdvectionField     &advection_field); \
+  template void Simulator<dim>::assemble_advection_systems (const std::vector<AdvectionField> &advection_fields);
 
 
   ASPECT_INSTANTIATE(INSTANTIATE)
@@ -25,10 +25,21 @@
 #include <aspect/melt.h>
 
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/distributed/solution_transfer.h>
 #include <deal.II/fe/mapping_q_cache.h>
 
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
 #ifdef DEAL_II_WITH_ZLIB
 #  include <zlib.h>
 #endif
@@ -67,7 +78,303 @@ namespace aspect
                                               + Utilities::to_string(error) + "."));
         }
     }
+
+
+
+    /**
+     * Copy a file from the given old to the given new name.
+     */
+    void copy_file (const std::string &old_name,
+                    const std::string &new_name)
+    {
+      std::ifstream in (old_name, std::ios::binary);
+      std::ofstream out (new_name, std::ios::binary);
+      out << in.rdbuf();
+      out.close();
+
+      AssertThrow (in && out, ExcMessage (std::string ("Unable to copy file: ")
+                                          +
+                                          old_name + " -> " + new_name + "."));
+    }
+
+
+
+    /**
+     * The number of vector entries that incremental snapshots store
+     * together in one block.
+     */
+    constexpr std::size_t incremental_snapshot_chunk_size = 1 << 15;
+
+
+
+    /**
+     * The information an incremental snapshot stores about the vector data
+     * of one process.
+     */
+    struct IncrementalSnapshotManifest
+    {
+      /**
+       * The locally owned elements of each vector.
+       */
+      std::vector<IndexSet> locally_owned_elements;
+
+      /**
+       * The names of the blocks the locally owned values of each vector
+       * are stored in.
+       */
+      std::vector<std::vector<std::string>> chunks;
+
+      /**
+       * The names of blocks that are not used by this snapshot, but by
+       * the previous snapshots that may still be needed.
+       */
+      std::vector<std::string> older_chunks;
+
+      template <class Archive>
+      void serialize (Archive &ar, const unsigned int)
+      {
+        ar &locally_owned_elements;
+        ar &chunks;
+        ar &older_chunks;
+      }
+    };
+
+
+
+    /**
+     * Return the name of the file in which the current process stores a
+     * block of vector data with the given content. The name consists of
+     * the rank of the process and the FNV-1a hash and size of the content,
+     * so that blocks with the same content are only stored once.
+     */
+    std::string chunk_name (const unsigned int my_id,
+                            const char *data,
+                            const std::size_t n_bytes)
+    {
+      std::uint64_t hash = 14695981039346656037ULL;
+      for (std::size_t i=0; i<n_bytes; ++i)
+        {
+          hash ^= static_cast<unsigned char>(data[i]);
+          hash *= 1099511628211ULL;
+        }
+
+      std::ostringstream name;
+      name << my_id << '-'
+           << std::hex << std::setw(16) << std::setfill('0') << hash
+           << std::dec << '-' << n_bytes;
+      return name.str();
+    }
+
+
+
+    /**
+     * Write the locally owned values of @p vector in blocks of
+     * incremental_snapshot_chunk_size values into @p chunk_directory and
+     * return the names of the blocks. Blocks that are listed in
+     * @p chunks_on_disk are already stored and are not written again.
+     */
+    template <typename VectorType>
+    std::vector<std::string>
+    write_vector_chunks (const VectorType &vector,
+                         const std::string &chunk_directory,
+                         const unsigned int my_id,
+                         std::set<std::string> &chunks_on_disk)
+    {
+      std::vector<double> values;
+      values.reserve (vector.locally_owned_elements().n_elements());
+      for (const auto index : vector.locally_owned_elements())
+        values.push_back (vector(index));
+
+      std::vector<std::string> chunks;
+      for (std::size_t begin=0; begin<values.size(); begin+=incremental_snapshot_chunk_size)
+        {
+          const std::size_t n_bytes = std::min (incremental_snapshot_chunk_size, values.size()-begin) * sizeof(double);
+          const char *data = reinterpret_cast<const char *>(values.data() + begin);
+          const std::string name = chunk_name (my_id, data, n_bytes);
+
+          if (chunks_on_disk.find(name) == chunks_on_disk.end())
+            {
+              std::ofstream f (chunk_directory + name, std::ios::binary);
+              f.write (data, n_bytes);
+              f.close();
+
+              AssertThrow (f, ExcMessage ("Writing of the checkpoint file '" + chunk_directory + name
+                                          + "' failed on processor " + Utilities::to_string(my_id) + "."));
+              chunks_on_disk.insert (name);
+            }
+
+          chunks.push_back (name);
+        }
+
+      return chunks;
+    }
+
+
+
+    /**
+     * Read the locally owned values of @p vector from the blocks with the
+     * given names in @p chunk_directory, and check that their content
+     * matches the hash in their names.
+     */
+    template <typename VectorType>
+    void read_vector_chunks (const std::vector<std::string> &chunks,
+                             const std::string &chunk_directory,
+                             const unsigned int my_id,
+                             VectorType &vector)
+    {
+      std::vector<double> values (vector.locally_owned_elements().n_elements());
+
+      std::size_t begin = 0;
+      for (const std::string &name : chunks)
+        {
+          AssertThrow (begin < values.size(),
+                       ExcMessage ("The snapshot contains more vector data than expected."));
+
+          const std::size_t n_bytes = std::min (incremental_snapshot_chunk_size, values.size()-begin) * sizeof(double);
+          char *data = reinterpret_cast<char *>(values.data() + begin);
+
+          std::ifstream f (chunk_directory + name, std::ios::binary);
+          f.read (data, n_bytes);
+          AssertThrow (f && chunk_name (my_id, data, n_bytes) == name,
+                       ExcMessage ("The checkpoint file '" + chunk_directory + name
+                                   + "' does not exist or is damaged."));
+
+          begin += incremental_snapshot_chunk_size;
+        }
+      AssertThrow (begin >= values.size(),
+                   ExcMessage ("The snapshot contains less vector data than expected."));
+
+      std::size_t i = 0;
+      for (const auto index : vector.locally_owned_elements())
+        vector(index) = values[i++];
+      vector.compress (VectorOperation::insert);
+    }
+  }
+
+
+#ifdef DEAL_II_WITH_ZLIB
+  namespace
+  {
+    /**
+     * The size of the blocks in which the general information of a snapshot
+     * is compressed independently of each other.
+     */
+    constexpr std::size_t snapshot_compression_block_size = 1 << 20;
+
+
+
+    /**
+     * Compress @p data with zlib. The data is split into blocks of
+     * snapshot_compression_block_size bytes that are compressed in parallel.
+     * The result starts with a header of 32-bit integers that contains the
+     * number of blocks, the size of a block, the size of the last block and
+     * the compressed sizes of all blocks, followed by the compressed
+     * blocks. This is the same format that deal.II uses for compressed
+     * data in VTU files.
+     */
+    std::string compress_in_blocks (const std::string &data)
+    {
+      const std::size_t n_blocks = std::max<std::size_t> ((data.size() + snapshot_compression_block_size - 1)
+                                                          / snapshot_compression_block_size,
+                                                          1);
+      const std::size_t last_block_size = data.size() - (n_blocks-1) * snapshot_compression_block_size;
+
+      std::vector<std::vector<Bytef>> compressed_blocks (n_blocks);
+      parallel::apply_to_subranges (std::size_t(0), n_blocks,
+                                    [&](const std::size_t begin, const std::size_t end)
+      {
+        for (std::size_t b=begin; b<end; ++b)
+          {
+            const std::size_t block_size = (b == n_blocks-1
+                                            ?
+                                            last_block_size
+                                            :
+                                            snapshot_compression_block_size);
+
+            uLongf compressed_block_size = compressBound (block_size);
+            compressed_blocks[b].resize (compressed_block_size);
+            const int err = compress2 (compressed_blocks[b].data(),
+                                       &compressed_block_size,
+                                       reinterpret_cast<const Bytef *>(data.data() + b * snapshot_compression_block_size),
+                                       block_size,
+                                       Z_BEST_COMPRESSION);
+            (void)err;
+            Assert (err == Z_OK, ExcInternalError());
+            compressed_blocks[b].resize (compressed_block_size);
+          }
+      },
+      /* grainsize = */ 1);
+
+      std::vector<uint32_t> compression_header;
+      compression_header.push_back (static_cast<uint32_t>(n_blocks));
+      compression_header.push_back (static_cast<uint32_t>(n_blocks > 1 ? snapshot_compression_block_size : last_block_size));
+      compression_header.push_back (static_cast<uint32_t>(last_block_size));
+      for (const auto &block : compressed_blocks)
+        compression_header.push_back (static_cast<uint32_t>(block.size()));
+
+      std::string compressed_data (reinterpret_cast<const char *>(compression_header.data()),
+                                   compression_header.size() * sizeof(compression_header[0]));
+      for (const auto &block : compressed_blocks)
+        compressed_data.append (reinterpret_cast<const char *>(block.data()), block.size());
+
+      return compressed_data;
+    }
+
+
+
+    /**
+     * Uncompress data that was compressed by compress_in_blocks(). This also
+     * reads snapshots that were written as a single block.
+     */
+    std::string uncompress_blocks (const std::string &compressed_data)
+    {
+      std::istringstream ifs (compressed_data);
+
+      uint32_t header_start[3];
+      ifs.read (reinterpret_cast<char *>(header_start), 3 * sizeof(header_start[0]));
+      const std::size_t n_blocks = header_start[0];
+      const std::size_t block_size = header_start[1];
+      const std::size_t last_block_size = header_start[2];
+      AssertThrow (ifs && n_blocks > 0,
+                   ExcMessage ("The header of the compressed snapshot data is invalid."));
+
+      std::vector<uint32_t> compressed_block_sizes (n_blocks);
+      ifs.read (reinterpret_cast<char *>(compressed_block_sizes.data()), n_blocks * sizeof(compressed_block_sizes[0]));
+
+      // find where each compressed block starts
+      std::vector<std::size_t> compressed_block_offsets (n_blocks+1, (3 + n_blocks) * sizeof(uint32_t));
+      for (std::size_t b=0; b<n_blocks; ++b)
+        compressed_block_offsets[b+1] = compressed_block_offsets[b] + compressed_block_sizes[b];
+      AssertThrow (ifs && compressed_block_offsets[n_blocks] <= compressed_data.size(),
+                   ExcMessage ("The compressed snapshot data is shorter than its header says."));
+
+      std::string data ((n_blocks-1) * block_size + last_block_size, '\0');
+      std::vector<int> errors (n_blocks, Z_OK);
+      parallel::apply_to_subranges (std::size_t(0), n_blocks,
+                                    [&](const std::size_t begin, const std::size_t end)
+      {
+        for (std::size_t b=begin; b<end; ++b)
+          {
+            uLongf uncompressed_size = (b == n_blocks-1 ? last_block_size : block_size);
+            errors[b] = uncompress (reinterpret_cast<Bytef *>(&data[b * block_size]),
+                                    &uncompressed_size,
+                                    reinterpret_cast<const Bytef *>(compressed_data.data() + compressed_block_offsets[b]),
+                                    compressed_block_sizes[b]);
+          }
+      },
+      /* grainsize = */ 1);
+
+      for (const int err : errors)
+        AssertThrow (err == Z_OK,
+                     ExcMessage (std::string("Uncompressing the data buffer resulted in an error with code <")
+                                 +
+                                 Utilities::int_to_string(err)));
+
+      return data;
+    }
   }
+#endif
+
 
 
   namespace
@@ -278,12 +585,29 @@ namespace aspect
   {
     TimerOutput::Scope timer (computing_timer, "Create snapshot");
 
+    // The previous snapshot may still be written in the background. Wait
+    // for it, since we are about to write files with the same names.
+    wait_for_snapshot_writing();
+
     // Take elapsed time from timer so that we can serialize it:
     total_walltime_until_last_snapshot += wall_timer.wall_time();
     wall_timer.restart();
 
     const unsigned int my_id = Utilities::MPI::this_mpi_process (mpi_communicator);
 
+    // Incremental snapshots store the solution vectors separately from the
+    // mesh, so the mesh only has to be written if it has changed since the
+    // last snapshot. Particles are stored together with the mesh, and the
+    // partition of the mesh depends on them, so models with particles
+    // always write complete snapshots.
+    const bool incremental_snapshot = parameters.incremental_checkpoints
+                                      && particle_worlds.empty();
+    const bool write_mesh = !incremental_snapshot
+                            || mesh_changed_since_last_snapshot;
+    const std::string chunk_directory = parameters.output_directory + "restart.vectors/";
+
+    std::vector<IncrementalSnapshotManifest> incremental_snapshot_manifests;
+
     // save Triangulation and Solution vectors:
     {
       std::vector<const LinearAlgebra::BlockVector *> x_system
@@ -293,36 +617,85 @@ namespace aspect
       if (parameters.mesh_deformation_enabled)
         x_system.push_back( &mesh_deformation->mesh_velocity );
 
-      parallel::distributed::SolutionTransfer<dim, LinearAlgebra::BlockVector>
-      system_trans (dof_handler);
-
-      system_trans.prepare_for_serialization (x_system);
-
-
       // If we are deforming the mesh, also serialize the mesh vertices vector, which
       // uses its own dof handler
       std::vector<const LinearAlgebra::Vector *> x_fs_system;
-      std::unique_ptr<parallel::distributed::SolutionTransfer<dim,LinearAlgebra::Vector>> mesh_deformation_trans;
       if (parameters.mesh_deformation_enabled)
         {
           x_fs_system.push_back (&mesh_deformation->mesh_displacements);
           x_fs_system.push_back (&mesh_deformation->initial_topography);
+        }
+
+      std::unique_ptr<parallel::distributed::SolutionTransfer<dim,LinearAlgebra::BlockVector>> system_trans;
+      std::unique_ptr<parallel::distributed::SolutionTransfer<dim,LinearAlgebra::Vector>> mesh_deformation_trans;
+      if (!incremental_snapshot)
+        {
+          system_trans
+            = std::make_unique<parallel::distributed::SolutionTransfer<dim,LinearAlgebra::BlockVector>>
+              (dof_handler);
+
+          system_trans->prepare_for_serialization (x_system);
 
-          mesh_deformation_trans
-            = std::make_unique<parallel::distributed::SolutionTransfer<dim,LinearAlgebra::Vector>>
-              (mesh_deformation->mesh_deformation_dof_handler);
+          if (parameters.mesh_deformation_enabled)
+            {
+              mesh_deformation_trans
+                = std::make_unique<parallel::distributed::SolutionTransfer<dim,LinearAlgebra::Vector>>
+                  (mesh_deformation->mesh_deformation_dof_handler);
 
-          mesh_deformation_trans->prepare_for_serialization(x_fs_system);
+              mesh_deformation_trans->prepare_for_serialization(x_fs_system);
+            }
         }
+      else
+        {
+          // Write the blocks of all vectors that are not already stored for
+          // one of the snapshots that may still be needed. The root process
+          // collects the list of blocks of all processes and stores it with
+          // the general information below.
+          Utilities::create_directory (chunk_directory, mpi_communicator, true);
+
+          std::set<std::string> chunks_on_disk;
+          for (const auto &chunks : incremental_snapshot_chunks)
+            chunks_on_disk.insert (chunks.begin(), chunks.end());
+
+          // Of the blocks already on disk, the previous two snapshots may
+          // still be needed after this one has been written.
+          std::set<std::string> older_chunks;
+          for (std::size_t i=(incremental_snapshot_chunks.size() > 2 ? incremental_snapshot_chunks.size()-2 : 0);
+               i<incremental_snapshot_chunks.size(); ++i)
+            older_chunks.insert (incremental_snapshot_chunks[i].begin(), incremental_snapshot_chunks[i].end());
+
+          IncrementalSnapshotManifest manifest;
+          manifest.older_chunks.assign (older_chunks.begin(), older_chunks.end());
+
+          std::set<std::string> current_chunks;
+          const auto write_vector = [&](const auto &vector)
+          {
+            manifest.locally_owned_elements.push_back (vector.locally_owned_elements());
+            manifest.chunks.push_back (write_vector_chunks (vector, chunk_directory, my_id, chunks_on_disk));
+            current_chunks.insert (manifest.chunks.back().begin(), manifest.chunks.back().end());
+          };
+          for (const LinearAlgebra::BlockVector *vector : x_system)
+            write_vector (*vector);
+          for (const LinearAlgebra::Vector *vector : x_fs_system)
+            write_vector (*vector);
 
-      signals.pre_checkpoint_store_user_data(triangulation);
+          incremental_snapshot_chunks.push_back (current_chunks);
+          incremental_snapshot_manifests = Utilities::MPI::gather (mpi_communicator, manifest, 0);
+        }
 
-      triangulation.save (parameters.output_directory + "restart.mesh.new");
+      if (write_mesh)
+        {
+          signals.pre_checkpoint_store_user_data(triangulation);
+
+          triangulation.save (parameters.output_directory + "restart.mesh.new");
+          mesh_changed_since_last_snapshot = false;
+        }
     }
 
     // save general information This calls the serialization functions on all
     // processes (so that they can take additional action, if necessary, see
     // the manual) but only writes to the restart file on process 0
+    std::string serialized_data;
     {
       std::ostringstream oss;
 
@@ -330,114 +703,168 @@ namespace aspect
       aspect::oarchive oa (oss);
       save_critical_parameters (this->parameters, oa);
       oa << (*this);
+      oa << incremental_snapshot_manifests;
 
-      // compress with zlib and write to file on the root processor
-#ifdef DEAL_II_WITH_ZLIB
-      if (my_id == 0)
-        {
-          uLongf compressed_data_length = compressBound (oss.str().length());
-          std::vector<char *> compressed_data (compressed_data_length);
-          int err = compress2 (reinterpret_cast<Bytef *>(&compressed_data[0]),
-                               &compressed_data_length,
-                               reinterpret_cast<const Bytef *>(oss.str().data()),
-                               oss.str().length(),
-                               Z_BEST_COMPRESSION);
-          (void)err;
-          Assert (err == Z_OK, ExcInternalError());
-
-          // build compression header
-          const uint32_t compression_header[4]
-            = { 1,                                   /* number of blocks */
-                static_cast<uint32_t>(oss.str().length()), /* size of block */
-                static_cast<uint32_t>(oss.str().length()), /* size of last block */
-                static_cast<uint32_t>(compressed_data_length)
-              }; /* list of compressed sizes of blocks */
-
-          std::ofstream f ((parameters.output_directory + "restart.resume.z.new"));
-          f.write(reinterpret_cast<const char *>(compression_header), 4 * sizeof(compression_header[0]));
-          f.write(reinterpret_cast<char *>(&compressed_data[0]), compressed_data_length);
-          f.close();
-
-          // We check the fail state of the stream _after_ closing the file to
-          // make sure the writes were completed correctly. This also catches
-          // the cases where the file could not be opened in the first place
-          // or one of the write() commands fails, as the fail state is
-          // "sticky".
-          if (!f)
-            AssertThrow(false, ExcMessage ("Writing of the checkpoint file '" + parameters.output_directory
-                                           + "restart.resume.z.new' with size "
-                                           + Utilities::to_string(4 * sizeof(compression_header[0])+compressed_data_length)
-                                           + " failed on processor 0."));
-        }
-#else
-      AssertThrow (false,
-                   ExcMessage ("You need to have deal.II configured with the `libz' "
-                               "option to support checkpoint/restart, but deal.II "
-                               "did not detect its presence when you called `cmake'."));
-#endif
-
+      serialized_data = oss.str();
     }
 
-    // Wait for everyone to finish writing
+#ifndef DEAL_II_WITH_ZLIB
+    AssertThrow (false,
+                 ExcMessage ("You need to have deal.II configured with the `libz' "
+                             "option to support checkpoint/restart, but deal.II "
+                             "did not detect its presence when you called `cmake'."));
+#endif
+
+    // Wait for everyone to finish writing the mesh and the solution vectors
     const int ierr = MPI_Barrier(mpi_communicator);
     AssertThrowMPI(ierr);
 
-    // Now rename the snapshots to put the new one in place of the old one.
-    // Do this after writing the new one, because writing large checkpoints
-    // can be slow, and the model might be cancelled during writing.
-    // This way restart remains usable even if restart.new is not completely
-    // written.
+    // All processes only get here after the root process has moved the
+    // previous snapshot into place (see wait_for_snapshot_writing() above).
+    // From now on, only this snapshot, the previous one, and the one before
+    // it (as the fallback until this snapshot is in place) are needed, so
+    // the blocks of vector data that only older snapshots use can be
+    // deleted.
+    if (incremental_snapshot)
+      while (incremental_snapshot_chunks.size() > 3)
+        {
+          for (const std::string &name : incremental_snapshot_chunks.front())
+            {
+              bool chunk_still_used = false;
+              for (std::size_t i=1; i<incremental_snapshot_chunks.size(); ++i)
+                if (incremental_snapshot_chunks[i].find(name) != incremental_snapshot_chunks[i].end())
+                  chunk_still_used = true;
+
+              if (chunk_still_used == false)
+                std::remove ((chunk_directory + name).c_str());
+            }
+
+          incremental_snapshot_chunks.pop_front();
+        }
+
+    // Compress and write the general information on the root processor,
+    // then rename the snapshots to put the new one in place of the old one.
+    // None of this needs the other processes or the current state of the
+    // simulation anymore, so it happens in the background while the
+    // simulation continues.
+    //
+    // The renaming happens after writing the new snapshot, because writing
+    // large checkpoints can be slow, and the model might be cancelled during
+    // writing. This way restart remains usable even if restart.new is not
+    // completely written.
     if (my_id == 0)
+      snapshot_writing_thread = std::thread (
+                                  [serialized_data = std::move(serialized_data),
+                                   output_directory = parameters.output_directory,
+                                   resume_computation = parameters.resume_computation,
+                                   write_mesh,
+                                   this]()
       {
-        // if we have previously written a snapshot, then keep the last
-        // snapshot in case this one fails to save. Note: static variables
-        // will only be initialized once per model run.
-        static bool previous_snapshot_exists = (parameters.resume_computation == true);
-
-        if (previous_snapshot_exists == true)
+        try
           {
-            move_file (parameters.output_directory + "restart.mesh",
-                       parameters.output_directory + "restart.mesh.old");
-            move_file (parameters.output_directory + "restart.mesh.info",
-                       parameters.output_directory + "restart.mesh.info.old");
-            move_file (parameters.output_directory + "restart.resume.z",
-                       parameters.output_directory + "restart.resume.z.old");
+#ifdef DEAL_II_WITH_ZLIB
+            const std::string compressed_data = compress_in_blocks (serialized_data);
+
+            std::ofstream f ((output_directory + "restart.resume.z.new"));
+            f.write(compressed_data.data(), compressed_data.size());
+            f.close();
+
+            // We check the fail state of the stream _after_ closing the file to
+            // make sure the writes were completed correctly. This also catches
+            // the cases where the file could not be opened in the first place
+            // or one of the write() commands fails, as the fail state is
+            // "sticky".
+            if (!f)
+              AssertThrow(false, ExcMessage ("Writing of the checkpoint file '" + output_directory
+                                             + "restart.resume.z.new' with size "
+                                             + Utilities::to_string(compressed_data.size())
+                                             + " failed on processor 0."));
+#endif
 
-            move_file (parameters.output_directory + "restart.mesh_fixed.data",
-                       parameters.output_directory + "restart.mesh_fixed.data.old");
+            // if we have previously written a snapshot, then keep the last
+            // snapshot in case this one fails to save. Note: static variables
+            // will only be initialized once per model run.
+            static bool previous_snapshot_exists = (resume_computation == true);
+
+            // Incremental snapshots do not write the mesh if it has not
+            // changed since the previous snapshot. The mesh files of the
+            // previous snapshot then also belong to the new one, and they
+            // have to be copied to the files of the previous snapshot unless
+            // the previous snapshot already shared them with the one before.
+            static bool previous_snapshot_wrote_mesh = true;
+
+            const std::vector<std::string> mesh_files = {"restart.mesh",
+                                                         "restart.mesh.info",
+                                                         "restart.mesh_fixed.data",
+                                                         "restart.mesh_variable.data"
+                                                        };
+            const std::vector<std::string> new_mesh_files = {"restart.mesh.new",
+                                                             "restart.mesh.new.info",
+                                                             "restart.mesh.new_fixed.data",
+                                                             "restart.mesh.new_variable.data"
+                                                            };
+
+            if (previous_snapshot_exists == true)
+              {
+                if (write_mesh)
+                  {
+                    for (const std::string &file : mesh_files)
+                      if (Utilities::fexists(output_directory + file))
+                        move_file (output_directory + file,
+                                   output_directory + file + ".old");
+                  }
+                else if (previous_snapshot_wrote_mesh)
+                  {
+                    for (const std::string &file : mesh_files)
+                      if (Utilities::fexists(output_directory + file))
+                        copy_file (output_directory + file,
+                                   output_directory + file + ".old");
+                  }
+
+                move_file (output_directory + "restart.resume.z",
+                           output_directory + "restart.resume.z.old");
+              }
 
-            if (Utilities::fexists(parameters.output_directory + "restart.mesh_variable.data"))
+            if (write_mesh)
               {
-                move_file (parameters.output_directory + "restart.mesh_variable.data",
-                           parameters.output_directory + "restart.mesh_variable.data.old");
+                for (unsigned int i=0; i<mesh_files.size(); ++i)
+                  if (Utilities::fexists(output_directory + new_mesh_files[i]))
+                    move_file (output_directory + new_mesh_files[i],
+                               output_directory + mesh_files[i]);
               }
+            previous_snapshot_wrote_mesh = write_mesh;
 
+            move_file (output_directory + "restart.resume.z.new",
+                       output_directory + "restart.resume.z");
+
+            // from now on, we know that if we get into this
+            // function again that a snapshot has previously
+            // been written
+            previous_snapshot_exists = true;
+          }
+        catch (...)
+          {
+            snapshot_writing_exception = std::current_exception();
           }
+      });
 
-        move_file (parameters.output_directory + "restart.mesh.new",
-                   parameters.output_directory + "restart.mesh");
-        move_file (parameters.output_directory + "restart.mesh.new.info",
-                   parameters.output_directory + "restart.mesh.info");
-        move_file (parameters.output_directory + "restart.resume.z.new",
-                   parameters.output_directory + "restart.resume.z");
+    pcout << "*** Snapshot created!" << std::endl << std::endl;
+  }
 
-        move_file (parameters.output_directory + "restart.mesh.new_fixed.data",
-                   parameters.output_directory + "restart.mesh_fixed.data");
 
-        if (Utilities::fexists(parameters.output_directory + "restart.mesh.new_variable.data"))
-          {
-            move_file (parameters.output_directory + "restart.mesh.new_variable.data",
-                       parameters.output_directory + "restart.mesh_variable.data");
-          }
 
+  template <int dim>
+  void Simulator<dim>::wait_for_snapshot_writing()
+  {
+    if (snapshot_writing_thread.joinable())
+      snapshot_writing_thread.join();
 
-        // from now on, we know that if we get into this
-        // function again that a snapshot has previously
-        // been written
-        previous_snapshot_exists = true;
+    if (snapshot_writing_exception)
+      {
+        std::exception_ptr exception = snapshot_writing_exception;
+        snapshot_writing_exception = nullptr;
+        std::rethrow_exception (exception);
       }
-
-    pcout << "*** Snapshot created!" << std::endl << std::endl;
   }
 
 
@@ -478,6 +905,10 @@ namespace aspect
 
     pcout << "*** Resuming from snapshot!" << std::endl << std::endl;
 
+    // Incremental snapshots store where the vector data of each process is
+    // stored. For complete snapshots, this list is empty.
+    std::vector<IncrementalSnapshotManifest> incremental_snapshot_manifests;
+
     // Read resume.z to set up the state of the model
     try
       {
@@ -486,31 +917,16 @@ namespace aspect
           = Utilities::read_and_distribute_file_content (parameters.output_directory + "restart.resume.z",
                                                          mpi_communicator);
 
-        std::istringstream ifs (restart_data);
-
-        uint32_t compression_header[4];
-        ifs.read(reinterpret_cast<char *>(compression_header), 4 * sizeof(compression_header[0]));
-        Assert(compression_header[0]==1, ExcInternalError());
-
-        std::vector<char> compressed(compression_header[3]);
-        std::vector<char> uncompressed(compression_header[1]);
-        ifs.read(&compressed[0],compression_header[3]);
-        uLongf uncompressed_size = compression_header[1];
-
-        const int err = uncompress(reinterpret_cast<Bytef *>(&uncompressed[0]), &uncompressed_size,
-                                   reinterpret_cast<Bytef *>(&compressed[0]), compression_header[3]);
-        AssertThrow (err == Z_OK,
-                     ExcMessage (std::string("Uncompressing the data buffer resulted in an error with code <")
-                                 +
-                                 Utilities::int_to_string(err)));
+        const std::string uncompressed_data = uncompress_blocks (restart_data);
 
         {
           std::istringstream ss;
-          ss.str(std::string (&uncompressed[0], uncompressed_size));
+          ss.str(uncompressed_data);
 
           aspect::iarchive ia (ss);
           load_and_check_critical_parameters(this->parameters, ia);
           ia >> (*this);
+          ia >> incremental_snapshot_manifests;
         }
 #else
         AssertThrow (false,
@@ -559,10 +975,78 @@ namespace aspect
     if (parameters.mesh_deformation_enabled)
       x_system.push_back(&distributed_mesh_velocity);
 
-    parallel::distributed::SolutionTransfer<dim, LinearAlgebra::BlockVector>
-    system_trans (dof_handler);
+    // The vectors using the mesh deformation dof handler
+    std::unique_ptr<LinearAlgebra::Vector> distributed_mesh_displacements;
+    std::unique_ptr<LinearAlgebra::Vector> distributed_initial_topography;
+    std::vector<LinearAlgebra::Vector *> fs_system;
+    if (parameters.mesh_deformation_enabled)
+      {
+        distributed_mesh_displacements = std::make_unique<LinearAlgebra::Vector>(mesh_deformation->mesh_locally_owned,
+                                                                                  mpi_communicator);
+        distributed_initial_topography = std::make_unique<LinearAlgebra::Vector>(mesh_deformation->mesh_locally_owned,
+                                                                                  mpi_communicator);
+        fs_system = { distributed_mesh_displacements.get(),
+                      distributed_initial_topography.get()
+                    };
+      }
 
-    system_trans.deserialize (x_system);
+    if (incremental_snapshot_manifests.empty())
+      {
+        parallel::distributed::SolutionTransfer<dim, LinearAlgebra::BlockVector>
+        system_trans (dof_handler);
+
+        system_trans.deserialize (x_system);
+
+        if (parameters.mesh_deformation_enabled)
+          {
+            parallel::distributed::SolutionTransfer<dim, LinearAlgebra::Vector> mesh_deformation_trans( mesh_deformation->mesh_deformation_dof_handler );
+            mesh_deformation_trans.deserialize (fs_system);
+          }
+      }
+    else
+      {
+        // The vector data of incremental snapshots is stored separately for
+        // each process, so it can only be read if the mesh is partitioned
+        // in the same way as when the snapshot was written.
+        const unsigned int my_id = Utilities::MPI::this_mpi_process (mpi_communicator);
+        AssertThrow (incremental_snapshot_manifests.size() == Utilities::MPI::n_mpi_processes (mpi_communicator),
+                     ExcMessage ("The incremental snapshot you are trying to resume from was written by "
+                                 + Utilities::to_string(incremental_snapshot_manifests.size())
+                                 + " processes, but the model is now running on "
+                                 + Utilities::to_string(Utilities::MPI::n_mpi_processes (mpi_communicator))
+                                 + " processes. Incremental snapshots can only be resumed "
+                                 "with the same number of processes."));
+
+        const IncrementalSnapshotManifest &manifest = incremental_snapshot_manifests[my_id];
+        AssertThrow (manifest.chunks.size() == x_system.size() + fs_system.size(),
+                     ExcMessage ("The number of vectors stored in the snapshot does not match "
+                                 "the current model."));
+
+        const std::string chunk_directory = parameters.output_directory + "restart.vectors/";
+        unsigned int vector_index = 0;
+        const auto read_vector = [&](auto &vector)
+        {
+          AssertThrow (vector.locally_owned_elements() == manifest.locally_owned_elements[vector_index],
+                       ExcMessage ("The partition of the mesh is not the same as when the "
+                                   "incremental snapshot was written."));
+          read_vector_chunks (manifest.chunks[vector_index], chunk_directory, my_id, vector);
+          ++vector_index;
+        };
+        for (LinearAlgebra::BlockVector *vector : x_system)
+          read_vector (*vector);
+        for (LinearAlgebra::Vector *vector : fs_system)
+          read_vector (*vector);
+
+        // Remember the blocks that this snapshot and the previous ones use,
+        // so that the next snapshots can reuse and eventually delete them.
+        std::set<std::string> current_chunks;
+        for (const auto &chunks : manifest.chunks)
+          current_chunks.insert (chunks.begin(), chunks.end());
+
+        incremental_snapshot_chunks.clear();
+        incremental_snapshot_chunks.emplace_back (manifest.older_chunks.begin(), manifest.older_chunks.end());
+        incremental_snapshot_chunks.push_back (current_chunks);
+      }
 
     solution = distributed_system;
     old_solution = old_distributed_system;
@@ -573,20 +1057,9 @@ namespace aspect
         // copy the mesh velocity which uses the system dof handler
         mesh_deformation->mesh_velocity = distributed_mesh_velocity;
 
-        // deserialize and copy the vectors using the mesh deformation dof handler
-        parallel::distributed::SolutionTransfer<dim, LinearAlgebra::Vector> mesh_deformation_trans( mesh_deformation->mesh_deformation_dof_handler );
-        LinearAlgebra::Vector distributed_mesh_displacements( mesh_deformation->mesh_locally_owned,
-                                                              mpi_communicator );
-        LinearAlgebra::Vector distributed_initial_topography( mesh_deformation->mesh_locally_owned,
-                                                              mpi_communicator );
-        std::vector<LinearAlgebra::Vector *> fs_system
-        = { &distributed_mesh_displacements,
-            &distributed_initial_topography
-          };
-
-        mesh_deformation_trans.deserialize (fs_system);
-        mesh_deformation->mesh_displacements = distributed_mesh_displacements;
-        mesh_deformation->initial_topography = distributed_initial_topography;
+        // copy the vectors using the mesh deformation dof handler
+        mesh_deformation->mesh_displacements = *distributed_mesh_displacements;
+        mesh_deformation->initial_topography = *distributed_initial_topography;
       }
 
     signals.post_resume_load_user_data(triangulation);
@@ -651,6 +1124,7 @@ namespace aspect
 {
 #define INSTANTIATE(dim) \
   template void Simulator<dim>::create_snapshot(); \
+  template void Simulator<dim>::wait_for_snapshot_writing(); \
   template void Simulator<dim>::resume_from_snapshot();
 
   ASPECT_INSTANTIATE(INSTANTIATE)
@@ -171,6 +171,7 @@ namespace aspect
                      TimerOutput::never,
                      TimerOutput::wall_times),
     total_walltime_until_last_snapshot(0.),
+    mesh_changed_since_last_snapshot(true),
     initial_topography_model(InitialTopographyModel::create_initial_topography_model<dim>(prm)),
     geometry_model (GeometryModel::create_geometry_model<dim>(prm)),
     // make sure the parameters object gets a chance to
@@ -430,13 +431,27 @@ namespace aspect
 
     if (parameters.stokes_solver_type == Parameters<dim>::StokesSolverType::block_gmg)
       {
+        // The number type of the multigrid levels is a template argument
+        // of the implementation, so we need to know it before creating it
+        prm.enter_subsection ("Solver parameters");
+        prm.enter_subsection ("Matrix Free");
+        const bool use_float_multigrid = (prm.get ("Multigrid number type") == "float");
+        prm.leave_subsection ();
+        prm.leave_subsection ();
+
         switch (parameters.stokes_velocity_degree)
           {
             case 2:
-              stokes_matrix_free = std::make_unique<StokesMatrixFreeHandlerImplementation<dim,2>>(*this, prm);
+              if (use_float_multigrid)
+                stokes_matrix_free = std::make_unique<StokesMatrixFreeHandlerImplementation<dim,2,float>>(*this, prm);
+              else
+                stokes_matrix_free = std::make_unique<StokesMatrixFreeHandlerImplementation<dim,2,double>>(*this, prm);
               break;
             case 3:
-              stokes_matrix_free = std::make_unique<StokesMatrixFreeHandlerImplementation<dim,3>>(*this, prm);
+              if (use_float_multigrid)
+                stokes_matrix_free = std::make_unique<StokesMatrixFreeHandlerImplementation<dim,3,float>>(*this, prm);
+              else
+                stokes_matrix_free = std::make_unique<StokesMatrixFreeHandlerImplementation<dim,3,double>>(*this, prm);
               break;
             default:
               AssertThrow(false, ExcMessage("The finite element degree for the Stokes system you selected is not supported yet."));
@@ -482,6 +497,14 @@ namespace aspect
 
     lateral_averaging.initialize_simulator (*this);
 
+    // Incremental snapshots only write the mesh if it has changed since
+    // the last snapshot, so keep track of all changes of the mesh.
+    triangulation.signals.any_change.connect(
+      [&]()
+    {
+      mesh_changed_since_last_snapshot = true;
+    });
+
     geometry_model->create_coarse_mesh (triangulation);
     Assert (triangulation.all_reference_cells_are_hyper_cube(),
             ExcMessage ("ASPECT only supports meshes that are composed of quadrilateral "
@@ -586,6 +609,10 @@ namespace aspect
     if (output_statistics_thread.joinable())
       output_statistics_thread.join();
 
+    // the same is true for the thread that writes the last snapshot
+    if (snapshot_writing_thread.joinable())
+      snapshot_writing_thread.join();
+
     // If an exception is being thrown (for example due to AssertThrow()), we
     // might end up here with currently active timing sections. The destructor
     // of TimerOutput does MPI communication, which can lead to deadlocks,
@@ -952,13 +979,18 @@ namespace aspect
     // matrix based algebraic multigrid.
     if (solver_scheme_solves_stokes_equations(parameters))
       {
-        // The matrix-free solver does not work with melt transport
-        Assert(!(parameters.include_melt_transport && stokes_matrix_free),
-               ExcNotImplemented());
-
         if (stokes_matrix_free)
           {
-            // nothing couples in the matrix free solver
+            // nothing in the Stokes system couples in the matrix free solver,
+            // but with melt transport we still need the fluid velocity block
+            // to compute the melt variables after the solve
+            if (parameters.include_melt_transport)
+              {
+                const unsigned int first_fluid_c_i = introspection.variable("fluid velocity").first_component_index;
+                for (unsigned int c=0; c<dim; ++c)
+                  for (unsigned int d=0; d<dim; ++d)
+                    coupling[first_fluid_c_i+c][first_fluid_c_i+d] = DoFTools::always;
+              }
           }
         else if (parameters.include_melt_transport)
           {
@@ -2210,6 +2242,9 @@ namespace aspect
       }
     while (true);
 
+    // make sure the last snapshot is completely written before we finish
+    wait_for_snapshot_writing();
+
     // we disable automatic summary printing so that it won't happen when
     // throwing an exception. Therefore, we have to do this manually here:
     computing_timer.print_summary ();
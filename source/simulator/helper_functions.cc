@@ -41,6 +41,7 @@
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/signaling_nan.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/lac/block_sparsity_pattern.h>
 #include <deal.II/grid/grid_tools.h>
 
@@ -1664,6 +1665,104 @@ namespace aspect
 
 
 
+  namespace internal
+  {
+    namespace Reactions
+    {
+      /**
+       * A work item for the computation of reactions in
+       * Simulator::compute_reactions(): A locally owned cell, the support
+       * points on this cell at which we need to solve the reaction ODEs,
+       * and the DoFs of the temperature and compositional fields whose new
+       * values are computed on this cell. Each locally owned DoF is
+       * computed on exactly one cell.
+       */
+      template <int dim>
+      struct CellWorkItem
+      {
+        typename DoFHandler<dim>::active_cell_iterator cell;
+
+        /**
+         * The indices of the support points (within the combined list of
+         * support points of all fields) at which the ODEs are solved.
+         */
+        std::vector<unsigned int> points_to_compute;
+
+        /**
+         * Pairs of the index of a DoF within the cell and the index of the
+         * corresponding support point within @p points_to_compute.
+         */
+        std::vector<std::pair<unsigned int, unsigned int>> dofs_to_compute;
+      };
+
+
+
+      template <int dim>
+      struct Scratch
+      {
+        Scratch (const Mapping<dim>       &mapping,
+                 const FiniteElement<dim> &finite_element,
+                 const Quadrature<dim>    &quadrature,
+                 const SUNDIALS::ARKode<Vector<double>>::AdditionalData &arkode_data)
+          :
+          fe_values (mapping, finite_element, quadrature,
+                     update_quadrature_points | update_values | update_gradients),
+          local_dof_indices (finite_element.dofs_per_cell),
+          arkode_data (arkode_data),
+          ode (arkode_data)
+        {}
+
+        Scratch (const Scratch &scratch)
+          :
+          fe_values (scratch.fe_values.get_mapping(),
+                     scratch.fe_values.get_fe(),
+                     scratch.fe_values.get_quadrature(),
+                     scratch.fe_values.get_update_flags()),
+          local_dof_indices (scratch.local_dof_indices),
+          arkode_data (scratch.arkode_data),
+          ode (scratch.arkode_data)
+        {}
+
+        FEValues<dim> fe_values;
+        std::vector<types::global_dof_index> local_dof_indices;
+
+        /**
+         * The ODE solver used for the reactions. It is created once per
+         * thread and reinitialized by every call to solve_ode(), so the
+         * same object can be used for all cells a thread works on.
+         */
+        const SUNDIALS::ARKode<Vector<double>>::AdditionalData arkode_data;
+        SUNDIALS::ARKode<Vector<double>> ode;
+
+        /**
+         * The temperature and compositional field values at all points of
+         * a cell, stored in one long vector as required by ARKode.
+         */
+        Vector<double> fields;
+
+        /**
+         * Material model inputs at all support points of a cell, from which
+         * the inputs at the points that actually need to be computed are
+         * copied. Created on first use.
+         */
+        std::unique_ptr<MaterialModel::MaterialModelInputs<dim>> cell_inputs;
+      };
+
+
+
+      struct CopyData
+      {
+        std::vector<types::global_dof_index> dof_indices;
+        std::vector<double> values;
+        std::vector<double> reactions;
+        unsigned int iteration_count;
+        unsigned int number_of_solves;
+      };
+    }
+  }
+
+
+
   template <int dim>
   void Simulator<dim>::compute_reactions ()
   {
@@ -1745,234 +1844,333 @@ namespace aspect
     }
 
     const Quadrature<dim> combined_support_points(unique_support_points);
-    FEValues<dim> fe_values (*mapping,
-                             dof_handler.get_fe(),
-                             combined_support_points,
-                             update_quadrature_points | update_values | update_gradients);
-
     const unsigned int n_q_points = combined_support_points.size();
-    std::vector<types::global_dof_index> local_dof_indices (dof_handler.get_fe().dofs_per_cell);
-    MaterialModel::MaterialModelInputs<dim> in(n_q_points, introspection.n_compositional_fields);
-    MaterialModel::MaterialModelOutputs<dim> out(n_q_points, introspection.n_compositional_fields);
-    HeatingModel::HeatingModelOutputs heating_model_outputs(n_q_points, introspection.n_compositional_fields);
 
-    // add reaction rate outputs
-    material_model->create_additional_named_outputs(out);
+    // Check that the material model supports operator splitting, and whether
+    // the heating models need additional material model inputs. These can only
+    // be filled using an FEValues object for all support points of a cell,
+    // so in that case we always solve the ODEs at all support points of a cell
+    // (see below).
+    bool use_all_support_points = false;
+    {
+      MaterialModel::MaterialModelInputs<dim> in(1, introspection.n_compositional_fields);
+      MaterialModel::MaterialModelOutputs<dim> out(1, introspection.n_compositional_fields);
+      material_model->create_additional_named_outputs(out);
+
+      AssertThrow(out.template get_additional_output<MaterialModel::ReactionRateOutputs<dim>>() != nullptr,
+                  ExcMessage("You are trying to use the operator splitting solver scheme, "
+                             "but the material model you use does not support operator splitting "
+                             "(it does not create ReactionRateOutputs, which are required for this "
+                             "solver scheme)."));
+
+      heating_model_manager.create_additional_material_model_inputs_and_outputs(in, out);
+      use_all_support_points = (in.additional_inputs.empty() == false);
+    }
+
+    // Decide on which cell each locally owned temperature and composition DoF is computed.
+    // Because the reactions only depend on the temperature and composition values at a given
+    // support point (and are independent of the solution in other points), it does not matter
+    // on which of the cells that share a DoF we compute it, so we simply take the first
+    // locally owned one. On each cell, we then only have to solve the reaction ODEs at the
+    // support points of the DoFs assigned to this cell, and every locally owned DoF is
+    // computed exactly once.
+    std::vector<internal::Reactions::CellWorkItem<dim>> work_items;
+    {
+      const IndexSet &locally_owned_dofs = dof_handler.locally_owned_dofs();
+      std::vector<bool> dof_is_assigned (locally_owned_dofs.n_elements(), false);
+
+      std::vector<types::global_dof_index> local_dof_indices (dof_handler.get_fe().dofs_per_cell);
+      std::vector<unsigned int> index_within_points_to_compute (n_q_points);
+      const unsigned int component_idx_T = introspection.component_indices.temperature;
+
+      for (const auto &cell : dof_handler.active_cell_iterators())
+        if (cell->is_locally_owned())
+          {
+            cell->get_dof_indices (local_dof_indices);
+
+            internal::Reactions::CellWorkItem<dim> work_item;
+            work_item.cell = cell;
+            std::fill(index_within_points_to_compute.begin(), index_within_points_to_compute.end(),
+                      numbers::invalid_unsigned_int);
 
-    MaterialModel::ReactionRateOutputs<dim> *reaction_rate_outputs
-      = out.template get_additional_output<MaterialModel::ReactionRateOutputs<dim>>();
+            for (unsigned int dof_idx = 0; dof_idx < local_dof_indices.size(); ++dof_idx)
+              {
+                const auto comp_pair = dof_handler.get_fe().system_to_component_index(dof_idx);
+                const unsigned int component_idx = comp_pair.first;
+
+                // ignore velocity, pressure, etc., and DoFs we do not own
+                if (component_idx < component_idx_T
+                    ||
+                    locally_owned_dofs.is_element(local_dof_indices[dof_idx]) == false)
+                  continue;
+
+                const types::global_dof_index index_within_set = locally_owned_dofs.index_within_set(local_dof_indices[dof_idx]);
+                if (dof_is_assigned[index_within_set])
+                  continue;
+                dof_is_assigned[index_within_set] = true;
+
+                // These two variables tell us the how-manyth shape function of which field
+                // this DoF is. Then we can look up in the support_point_index_by_field data
+                // structure where this support point is in the list of unique_support_points
+                // (and in the Quadrature):
+                const unsigned int index_within = comp_pair.second;
+                const unsigned int field_index = component_idx-component_idx_T;
+                const unsigned int point_idx = support_point_index_by_field[field_index][index_within];
+
+                if (index_within_points_to_compute[point_idx] == numbers::invalid_unsigned_int)
+                  {
+                    index_within_points_to_compute[point_idx] = work_item.points_to_compute.size();
+                    work_item.points_to_compute.push_back(point_idx);
+                  }
+
+                work_item.dofs_to_compute.emplace_back(dof_idx, index_within_points_to_compute[point_idx]);
+              }
+
+            if (work_item.dofs_to_compute.empty())
+              continue;
 
-    AssertThrow(reaction_rate_outputs != nullptr,
-                ExcMessage("You are trying to use the operator splitting solver scheme, "
-                           "but the material model you use does not support operator splitting "
-                           "(it does not create ReactionRateOutputs, which are required for this "
-                           "solver scheme)."));
+            // If we need all support points anyway, store them in their natural order
+            // so that we can fill the material model inputs directly from FEValues.
+            if (use_all_support_points || work_item.points_to_compute.size() == n_q_points)
+              {
+                for (auto &dof_and_point : work_item.dofs_to_compute)
+                  dof_and_point.second = work_item.points_to_compute[dof_and_point.second];
 
-    // some heating models require the additional outputs
-    heating_model_manager.create_additional_material_model_inputs_and_outputs(in, out);
+                work_item.points_to_compute.resize(n_q_points);
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  work_item.points_to_compute[q] = q;
+              }
+
+            work_items.emplace_back(std::move(work_item));
+          }
+    }
 
     // We use SUNDIALs ARKode to compute the reactions. Set up the required parameters.
     // TODO: Should we change some of these based on the Reaction time step input parameter?
     using VectorType = Vector<double>;
-    SUNDIALS::ARKode<VectorType>::AdditionalData data;
-    data.initial_time = time;
-    data.final_time = time + time_step;
-    data.initial_step_size = 0.001 * time_step;
-    data.output_period = time_step;
-    data.minimum_step_size = 1.e-6 * time_step;
+    SUNDIALS::ARKode<VectorType>::AdditionalData arkode_data;
+    arkode_data.initial_time = time;
+    arkode_data.final_time = time + time_step;
+    arkode_data.initial_step_size = 0.001 * time_step;
+    arkode_data.output_period = time_step;
+    arkode_data.minimum_step_size = 1.e-6 * time_step;
 
     // Both tolerances are added, but the composition might become 0.
     // We therefore set the absolute tolerance to a very small value.
-    data.relative_tolerance = 1e-6;
-    data.absolute_tolerance = 1e-10;
+    arkode_data.relative_tolerance = 1e-6;
+    arkode_data.absolute_tolerance = 1e-10;
+
+    // Now solve the reactions on all cells in parallel. On each cell, the ODEs at all
+    // support points that need to be computed are solved together, which allows us to
+    // evaluate the material and heating models for all of these points at once.
+    auto worker = [&](const typename std::vector<internal::Reactions::CellWorkItem<dim>>::const_iterator &work_item,
+                      internal::Reactions::Scratch<dim> &scratch,
+                      internal::Reactions::CopyData &data)
+    {
+      const typename DoFHandler<dim>::active_cell_iterator &cell = work_item->cell;
+      const std::vector<unsigned int> &points_to_compute = work_item->points_to_compute;
+      const unsigned int n_points = points_to_compute.size();
 
-    SUNDIALS::ARKode<VectorType> ode(data);
+      MaterialModel::MaterialModelInputs<dim> in(n_points, introspection.n_compositional_fields);
+      MaterialModel::MaterialModelOutputs<dim> out(n_points, introspection.n_compositional_fields);
+      HeatingModel::HeatingModelOutputs heating_model_outputs(n_points, introspection.n_compositional_fields);
 
-    std::vector<std::vector<double>> initial_values_C (n_q_points, std::vector<double> (introspection.n_compositional_fields));
-    std::vector<double> initial_values_T (n_q_points);
+      // add reaction rate outputs
+      material_model->create_additional_named_outputs(out);
 
-    // We have to store all values of the temperature and composition fields in one long vector.
-    // Create the vector and functions for transferring values between this vector and the material model inputs object.
-    VectorType fields (n_q_points * n_fields);
+      // some heating models require the additional outputs
+      heating_model_manager.create_additional_material_model_inputs_and_outputs(in, out);
 
-    auto copy_fields_into_one_vector = [n_q_points,n_fields](const MaterialModel::MaterialModelInputs<dim> &in,
-                                                             VectorType &fields)
-    {
-      for (unsigned int j=0; j<n_q_points; ++j)
-        for (unsigned int f=0; f<n_fields; ++f)
-          if (f==0)
-            fields[j*n_fields+f] = in.temperature[j];
-          else
-            fields[j*n_fields+f] = in.composition[j][f-1];
-      return;
-    };
+      const MaterialModel::ReactionRateOutputs<dim> *reaction_rate_outputs
+        = out.template get_additional_output<MaterialModel::ReactionRateOutputs<dim>>();
 
-    auto copy_fields_into_material_model_inputs = [n_q_points,n_fields](const VectorType &fields,
-                                                                        MaterialModel::MaterialModelInputs<dim> &in)
-    {
-      for (unsigned int j=0; j<n_q_points; ++j)
-        for (unsigned int f=0; f<n_fields; ++f)
-          if (f==0)
-            in.temperature[j]      = fields[j*n_fields+f];
-          else
-            in.composition[j][f-1] = fields[j*n_fields+f];
-      return;
-    };
+      scratch.fe_values.reinit (cell);
 
-    auto copy_rates_into_one_vector = [n_q_points,n_fields](const MaterialModel::ReactionRateOutputs<dim> *reaction_out,
-                                                            const HeatingModel::HeatingModelOutputs &heating_out,
-                                                            VectorType &rates)
-    {
-      for (unsigned int j=0; j<n_q_points; ++j)
-        for (unsigned int f=0; f<n_fields; ++f)
-          if (f==0)
-            rates[j*n_fields+f] = heating_out.rates_of_temperature_change[j];
-          else
-            rates[j*n_fields+f] = reaction_out->reaction_rates[j][f-1];
-      return;
-    };
+      if (n_points == n_q_points)
+        {
+          in.reinit(scratch.fe_values, cell, introspection, solution);
 
-    unsigned int total_iteration_count = 0;
-    unsigned int number_of_solves = 0;
+          // The additional inputs only depend on the solution, not on the temperature
+          // and composition values we change during the reaction time stepping, so
+          // we only need to fill them once.
+          material_model->fill_additional_material_model_inputs(in, solution, scratch.fe_values, introspection);
+        }
+      else
+        {
+          Assert (in.additional_inputs.empty(), ExcInternalError());
 
-    // Make a loop first over all cells, than over all reaction time steps, and then over
-    // all degrees of freedom in each element to compute the reactions. This is possible
-    // because the reactions only depend on the temperature and composition values at a given
-    // degree of freedom (and are independent of the solution in other points).
+          if (scratch.cell_inputs == nullptr)
+            scratch.cell_inputs = std::make_unique<MaterialModel::MaterialModelInputs<dim>>(n_q_points, introspection.n_compositional_fields);
 
-    // Note that the values for some degrees of freedom are set more than once in the loop
-    // below where we assign the new values to distributed_vector (if they are located on the
-    // interface between cells), as we loop over all cells, and then over all degrees of freedom
-    // on each cell. Although this means we do some additional work, the results are still
-    // correct, as we never read from distributed_vector inside the loop over all cells.
-    // We initialize the material model inputs object in using the solution vector
-    // on every cell, compute the update, and then on every cell put the result into the
-    // distributed_vector vector. Only after the loop over all cells do we copy distributed_vector
-    // back onto the solution vector.
-    // So even though we touch some DoF more than once, we always start from the same value, compute the
-    // same value, and then overwrite the same value in distributed_vector.
-    // TODO: make this even more efficient.
-    for (const auto &cell : dof_handler.active_cell_iterators())
-      if (cell->is_locally_owned())
-        {
-          fe_values.reinit (cell);
-          in.reinit(fe_values, cell, introspection, solution);
+          const MaterialModel::MaterialModelInputs<dim> &cell_inputs = *scratch.cell_inputs;
+          scratch.cell_inputs->reinit(scratch.fe_values, cell, introspection, solution);
 
-          std::vector<std::vector<double>> accumulated_reactions_C (n_q_points, std::vector<double> (introspection.n_compositional_fields));
-          std::vector<double> accumulated_reactions_T (n_q_points);
+          for (unsigned int j=0; j<n_points; ++j)
+            {
+              const unsigned int q = points_to_compute[j];
+              in.position[j]          = cell_inputs.position[q];
+              in.temperature[j]       = cell_inputs.temperature[q];
+              in.pressure[j]          = cell_inputs.pressure[q];
+              in.pressure_gradient[j] = cell_inputs.pressure_gradient[q];
+              in.velocity[j]          = cell_inputs.velocity[q];
+              in.composition[j]       = cell_inputs.composition[q];
+              in.strain_rate[j]       = cell_inputs.strain_rate[q];
+            }
+          in.current_cell = cell_inputs.current_cell;
+          in.requested_properties = cell_inputs.requested_properties;
+        }
 
-          copy_fields_into_one_vector (in, fields);
+      const std::vector<std::vector<double>> initial_values_C = in.composition;
+      const std::vector<double> initial_values_T = in.temperature;
 
-          initial_values_C = in.composition;
-          initial_values_T = in.temperature;
+      std::vector<std::vector<double>> accumulated_reactions_C (n_points, std::vector<double> (introspection.n_compositional_fields));
+      std::vector<double> accumulated_reactions_T (n_points);
 
-          if (parameters.reaction_solver_type == Parameters<dim>::ReactionSolverType::ARKode)
-            {
+      data.iteration_count = 0;
+      data.number_of_solves = 0;
 
-              ode.explicit_function = [&] (const double /*time*/,
-                                           const VectorType &y,
-                                           VectorType &ydot)
+      if (parameters.reaction_solver_type == Parameters<dim>::ReactionSolverType::ARKode)
+        {
+          // We have to store all values of the temperature and composition fields in one long vector.
+          VectorType &fields = scratch.fields;
+          fields.reinit (n_points * n_fields);
+          for (unsigned int j=0; j<n_points; ++j)
+            for (unsigned int f=0; f<n_fields; ++f)
+              if (f==0)
+                fields[j*n_fields+f] = in.temperature[j];
+              else
+                fields[j*n_fields+f] = in.composition[j][f-1];
+
+          // The right hand side refers to the inputs and outputs of the current cell,
+          // so we have to set it anew for every cell.
+          SUNDIALS::ARKode<VectorType> &ode = scratch.ode;
+          ode.explicit_function = [&] (const double /*time*/,
+                                       const VectorType &y,
+                                       VectorType &ydot)
+          {
+            for (unsigned int j=0; j<n_points; ++j)
+              for (unsigned int f=0; f<n_fields; ++f)
+                if (f==0)
+                  in.temperature[j]      = y[j*n_fields+f];
+                else
+                  in.composition[j][f-1] = y[j*n_fields+f];
+
+            material_model->evaluate(in, out);
+            heating_model_manager.evaluate(in, out, heating_model_outputs);
+
+            for (unsigned int j=0; j<n_points; ++j)
+              for (unsigned int f=0; f<n_fields; ++f)
+                if (f==0)
+                  ydot[j*n_fields+f] = heating_model_outputs.rates_of_temperature_change[j];
+                else
+                  ydot[j*n_fields+f] = reaction_rate_outputs->reaction_rates[j][f-1];
+          };
+
+          // Make the reaction time steps: We have to update the values of compositional fields and the temperature.
+          // We can reuse the same material model inputs and outputs structure for each reaction time step.
+          // We store the computed updates to temperature and composition in a separate (accumulated_reactions) vector,
+          // so that we can later copy it over to the solution vector.
+          data.iteration_count = ode.solve_ode(fields);
+          data.number_of_solves = 1;
+
+          for (unsigned int j=0; j<n_points; ++j)
+            for (unsigned int f=0; f<n_fields; ++f)
               {
-                copy_fields_into_material_model_inputs (y, in);
-                material_model->fill_additional_material_model_inputs(in, solution, fe_values, introspection);
-                material_model->evaluate(in, out);
-                heating_model_manager.evaluate(in, out, heating_model_outputs);
-                copy_rates_into_one_vector (reaction_rate_outputs, heating_model_outputs, ydot);
-              };
-
-              // Make the reaction time steps: We have to update the values of compositional fields and the temperature.
-              // We can reuse the same material model inputs and outputs structure for each reaction time step.
-              // We store the computed updates to temperature and composition in a separate (accumulated_reactions) vector,
-              // so that we can later copy it over to the solution vector.
-              const unsigned int iteration_count = ode.solve_ode(fields);
-
-              total_iteration_count += iteration_count;
-              number_of_solves += 1;
-
-              for (unsigned int j=0; j<n_q_points; ++j)
-                for (unsigned int f=0; f<n_fields; ++f)
+                if (f==0)
                   {
-                    if (f==0)
-                      {
-                        in.temperature[j]          = fields[j*n_fields+f];
-                        accumulated_reactions_T[j] = in.temperature[j] - initial_values_T[j];
-                      }
-                    else
-                      {
-                        in.composition[j][f-1]          = fields[j*n_fields+f];
-                        accumulated_reactions_C[j][f-1] = in.composition[j][f-1] - initial_values_C[j][f-1];
-                      }
+                    in.temperature[j]          = fields[j*n_fields+f];
+                    accumulated_reactions_T[j] = in.temperature[j] - initial_values_T[j];
                   }
-            }
-
-          else if (parameters.reaction_solver_type == Parameters<dim>::ReactionSolverType::fixed_step)
+                else
+                  {
+                    in.composition[j][f-1]          = fields[j*n_fields+f];
+                    accumulated_reactions_C[j][f-1] = in.composition[j][f-1] - initial_values_C[j][f-1];
+                  }
+              }
+        }
+      else if (parameters.reaction_solver_type == Parameters<dim>::ReactionSolverType::fixed_step)
+        {
+          for (unsigned int i=0; i<number_of_reaction_steps; ++i)
             {
-              for (unsigned int i=0; i<number_of_reaction_steps; ++i)
-                {
-                  // Loop over composition element
-                  material_model->fill_additional_material_model_inputs(in, solution, fe_values, introspection);
-
-                  material_model->evaluate(in, out);
-                  heating_model_manager.evaluate(in, out, heating_model_outputs);
+              material_model->evaluate(in, out);
+              heating_model_manager.evaluate(in, out, heating_model_outputs);
 
-                  for (unsigned int j=0; j<n_q_points; ++j)
+              for (unsigned int j=0; j<n_points; ++j)
+                {
+                  for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
                     {
-                      for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
-                        {
-                          // simple forward euler
-                          in.composition[j][c] = in.composition[j][c]
-                                                 + reaction_time_step_size * reaction_rate_outputs->reaction_rates[j][c];
-                          accumulated_reactions_C[j][c] += reaction_time_step_size * reaction_rate_outputs->reaction_rates[j][c];
-                        }
-                      in.temperature[j] = in.temperature[j]
-                                          + reaction_time_step_size * heating_model_outputs.rates_of_temperature_change[j];
-                      accumulated_reactions_T[j] += reaction_time_step_size * heating_model_outputs.rates_of_temperature_change[j];
+                      // simple forward euler
+                      in.composition[j][c] = in.composition[j][c]
+                                             + reaction_time_step_size * reaction_rate_outputs->reaction_rates[j][c];
+                      accumulated_reactions_C[j][c] += reaction_time_step_size * reaction_rate_outputs->reaction_rates[j][c];
                     }
+                  in.temperature[j] = in.temperature[j]
+                                      + reaction_time_step_size * heating_model_outputs.rates_of_temperature_change[j];
+                  accumulated_reactions_T[j] += reaction_time_step_size * heating_model_outputs.rates_of_temperature_change[j];
                 }
             }
+        }
 
-          cell->get_dof_indices (local_dof_indices);
-          const unsigned int component_idx_T = introspection.component_indices.temperature;
+      // Finally collect the values of the DoFs that are computed on this cell.
+      cell->get_dof_indices (scratch.local_dof_indices);
+      const unsigned int component_idx_T = introspection.component_indices.temperature;
 
-          for (unsigned int dof_idx = 0; dof_idx < local_dof_indices.size(); ++dof_idx)
+      const unsigned int n_dofs_to_compute = work_item->dofs_to_compute.size();
+      data.dof_indices.resize(n_dofs_to_compute);
+      data.values.resize(n_dofs_to_compute);
+      data.reactions.resize(n_dofs_to_compute);
+
+      for (unsigned int i=0; i<n_dofs_to_compute; ++i)
+        {
+          const unsigned int dof_idx = work_item->dofs_to_compute[i].first;
+          const unsigned int point_idx = work_item->dofs_to_compute[i].second;
+          const unsigned int component_idx = dof_handler.get_fe().system_to_component_index(dof_idx).first;
+
+          data.dof_indices[i] = scratch.local_dof_indices[dof_idx];
+
+          // temperatures and compositions are stored differently:
+          if (component_idx == component_idx_T)
             {
-              const auto comp_pair = dof_handler.get_fe().system_to_component_index(dof_idx);
-              const unsigned int component_idx = comp_pair.first;
-              if (component_idx>=component_idx_T) // ignore velocity, pressure, etc.
-                {
-                  // We found a DoF that belongs to component component_idx, which is a temperature or compositional
-                  // field. That means we want to find where this DoF in the computed reactions above to copy it
-                  // back into the global solution vector.
-
-                  // These two variables tell us the how-manyth shape function of which field (and therefore
-                  // field) this DoF is:
-                  const unsigned int index_within = comp_pair.second;
-                  const unsigned int field_index = component_idx-component_idx_T;
-                  // Now we can look up in the support_point_index_by_field data structure where this support
-                  // point is in the list of unique_support_points (and in the Quadrature):
-                  const unsigned int point_idx = support_point_index_by_field[field_index][index_within];
-
-                  // The final step is grabbing the value from the reaction computation and write it into
-                  // the global vector (if we own it, of course):
-                  if (dof_handler.locally_owned_dofs().is_element(local_dof_indices[dof_idx]))
-                    {
-                      // temperatures and compositions are stored differently:
-                      if (component_idx == component_idx_T)
-                        {
-                          distributed_vector(local_dof_indices[dof_idx]) = in.temperature[point_idx];
-                          distributed_reaction_vector(local_dof_indices[dof_idx]) = accumulated_reactions_T[point_idx];
-                        }
-                      else
-                        {
-                          const unsigned int composition = field_index-1; // 0 is temperature...
-                          distributed_vector(local_dof_indices[dof_idx]) = in.composition[point_idx][composition];
-                          distributed_reaction_vector(local_dof_indices[dof_idx]) = accumulated_reactions_C[point_idx][composition];
-                        }
-                    }
-                }
+              data.values[i] = in.temperature[point_idx];
+              data.reactions[i] = accumulated_reactions_T[point_idx];
             }
+          else
+            {
+              const unsigned int composition = component_idx-component_idx_T-1; // 0 is temperature...
+              data.values[i] = in.composition[point_idx][composition];
+              data.reactions[i] = accumulated_reactions_C[point_idx][composition];
+            }
+        }
+    };
+
+    unsigned int total_iteration_count = 0;
+    unsigned int number_of_solves = 0;
+
+    // Since every DoF is computed on exactly one cell, the copier never
+    // writes the same entry twice.
+    auto copier = [&](const internal::Reactions::CopyData &data)
+    {
+      for (unsigned int i=0; i<data.dof_indices.size(); ++i)
+        {
+          distributed_vector(data.dof_indices[i]) = data.values[i];
+          distributed_reaction_vector(data.dof_indices[i]) = data.reactions[i];
         }
 
+      total_iteration_count += data.iteration_count;
+      number_of_solves += data.number_of_solves;
+    };
+
+    WorkStream::
+    run (work_items.cbegin(),
+         work_items.cend(),
+         worker,
+         copier,
+         internal::Reactions::Scratch<dim> (*mapping,
+                                            dof_handler.get_fe(),
+                                            combined_support_points,
+                                            arkode_data),
+         internal::Reactions::CopyData ());
+
     distributed_vector.compress(VectorOperation::insert);
     distributed_reaction_vector.compress(VectorOperation::insert);
 
@@ -2674,15 +2872,13 @@ namespace aspect
         //   - Implicit reference density profile
         //   - Periodic boundaries
         //   - Stokes velocity degree not 2 or 3
-        //   - Material averaging explicitly disabled
         if (parameters.include_melt_transport == true ||
             dynamic_cast<const GeometryModel::EllipsoidalChunk<dim>*>(geometry_model.get()) != nullptr ||
             parameters.use_locally_conservative_discretization == true ||
             (material_model->is_compressible() == true && parameters.formulation_mass_conservation ==
              Parameters<dim>::Formulation::MassConservation::implicit_reference_density_profile) ||
             (geometry_model->get_periodic_boundary_pairs().size()) > 0 ||
-            (parameters.stokes_velocity_degree < 2 || parameters.stokes_velocity_degree > 3) ||
-            parameters.material_averaging == MaterialModel::MaterialAveraging::none)
+            (parameters.stokes_velocity_degree < 2 || parameters.stokes_velocity_degree > 3))
           {
             // GMG is not supported (yet), by default fall back to AMG.
             parameters.stokes_solver_type = Parameters<dim>::StokesSolverType::block_amg;
@@ -37,6 +37,56 @@
 
 namespace aspect
 {
+  namespace
+  {
+    /**
+     * A function object that returns the initial composition of all
+     * compositional fields in the components of the solution vector
+     * that correspond to them. Evaluating all fields (and all
+     * interpolation points of a cell) in one call allows the initial
+     * composition plugins to share work between fields and points.
+     */
+    template <int dim>
+    class InitialCompositionFunction : public Function<dim>
+    {
+      public:
+        InitialCompositionFunction (const InitialComposition::Manager<dim> &manager,
+                                    const Introspection<dim> &introspection)
+          :
+          Function<dim>(introspection.n_components),
+          manager (manager),
+          introspection (introspection)
+        {}
+
+        void
+        vector_value (const Point<dim> &p,
+                      Vector<double> &values) const override
+        {
+          std::vector<Vector<double>> value_list (1, values);
+          vector_value_list (std::vector<Point<dim>>(1, p), value_list);
+          values = value_list[0];
+        }
+
+        void
+        vector_value_list (const std::vector<Point<dim>> &points,
+                           std::vector<Vector<double>> &value_list) const override
+        {
+          std::vector<std::vector<double>> compositions (points.size(),
+                                                         std::vector<double>(introspection.n_compositional_fields));
+          manager.initial_compositions (points, compositions);
+
+          for (unsigned int q=0; q<points.size(); ++q)
+            for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
+              value_list[q][introspection.component_indices.compositional_fields[c]] = compositions[q][c];
+        }
+
+      private:
+        const InitialComposition::Manager<dim> &manager;
+        const Introspection<dim> &introspection;
+    };
+  }
+
+
 
   template <int dim>
   void Simulator<dim>::set_initial_temperature_and_compositional_fields ()
@@ -68,6 +118,10 @@ namespace aspect
     // a (simplified) copy of the code in VectorTools::interpolate
     // that only works on the temperature component
     //
+    // All compositional fields are interpolated together in the n==1 iteration,
+    // so that the initial composition plugins can evaluate all fields at a
+    // point at once. The remaining iterations only deal with normalization.
+    //
     // TODO: it would be great if we had a cleaner way than iterating to 1+n_fields.
     // Additionally, the n==1 logic for normalization at the bottom is not pretty.
     for (unsigned int n=0; n<1+introspection.n_compositional_fields; ++n)
@@ -90,40 +144,38 @@ namespace aspect
 
         std::vector<types::global_dof_index> local_dof_indices (finite_element.dofs_per_cell);
 
-        const VectorFunctionFromScalarFunctionObject<dim, double> &advf_init_function
-          =
-            (advf.is_temperature()
-             ?
-             VectorFunctionFromScalarFunctionObject<dim, double>(
-               [&](const Point<dim> &p) -> double
+        const VectorFunctionFromScalarFunctionObject<dim, double> temperature_init_function
+        (
+          [&](const Point<dim> &p) -> double
         {
           return initial_temperature_manager->initial_temperature(p);
         },
         introspection.component_indices.temperature,
-        introspection.n_components)
-        :
-        VectorFunctionFromScalarFunctionObject<dim, double>(
-          [&](const Point<dim> &p) -> double
-        {
-          return initial_composition_manager->initial_composition(p, n-1);
-        },
-        introspection.component_indices.compositional_fields[n-1],
-        introspection.n_components));
+        introspection.n_components);
 
-        const ComponentMask advf_mask =
-          (advf.is_temperature()
-           ?
-           introspection.component_masks.temperature
-           :
-           introspection.component_masks.compositional_fields[n-1]);
+        const InitialCompositionFunction<dim> composition_init_function (*initial_composition_manager,
+                                                                          introspection);
 
         try
           {
-            VectorTools::interpolate(*mapping,
-                                     dof_handler,
-                                     advf_init_function,
-                                     initial_solution,
-                                     advf_mask);
+            if (advf.is_temperature())
+              VectorTools::interpolate(*mapping,
+                                       dof_handler,
+                                       temperature_init_function,
+                                       initial_solution,
+                                       introspection.component_masks.temperature);
+            else if (n == 1)
+              {
+                ComponentMask composition_mask (introspection.n_components, false);
+                for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
+                  composition_mask = composition_mask | introspection.component_masks.compositional_fields[c];
+
+                VectorTools::interpolate(*mapping,
+                                         dof_handler,
+                                         composition_init_function,
+                                         initial_solution,
+                                         composition_mask);
+              }
           }
         // initial conditions that throw exceptions usually do not result in
         // anything good because they result in an unwinding of the stack
@@ -137,7 +189,7 @@ namespace aspect
                                             ?
                                             "temperature"
                                             :
-                                            introspection.name_for_compositional_index(n-1));
+                                            "compositional fields");
 
             std::cerr << std::endl << std::endl
                       << "----------------------------------------------------"
@@ -161,7 +213,7 @@ namespace aspect
                                             ?
                                             "temperature"
                                             :
-                                            introspection.name_for_compositional_index(n-1));
+                                            "compositional fields");
 
             std::cerr << std::endl << std::endl
                       << "----------------------------------------------------"
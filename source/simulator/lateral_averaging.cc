@@ -31,6 +31,9 @@
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/base/quadrature_lib.h>
 
+#include <algorithm>
+#include <functional>
+
 
 
 namespace aspect
@@ -823,6 +826,15 @@ namespace aspect
   std::vector<std::vector<double>>
   LateralAveraging<dim>::compute_lateral_averages(const unsigned int n_slices,
                                                   const std::vector<std::string> &property_names) const
+  {
+    return compute_lateral_averages(compute_equidistant_depth_bounds(n_slices), property_names);
+  }
+
+
+
+  template <int dim>
+  std::vector<double>
+  LateralAveraging<dim>::compute_equidistant_depth_bounds(const unsigned int n_slices) const
   {
     const double maximal_depth = this->get_geometry_model().maximal_depth();
     std::vector<double> depth_bounds(n_slices+1, 0.0);
@@ -831,7 +843,78 @@ namespace aspect
     for (unsigned int i=1; i<depth_bounds.size(); ++i)
       depth_bounds[i] = depth_bounds[i-1] + maximal_depth / n_slices;
 
-    return compute_lateral_averages(depth_bounds, property_names);
+    return depth_bounds;
+  }
+
+
+
+  template <int dim>
+  void
+  LateralAveraging<dim>::register_lateral_averages(const unsigned int n_slices,
+                                                   const std::vector<std::string> &property_names) const
+  {
+    registered_properties_by_n_slices[n_slices].insert(property_names.begin(),
+                                                        property_names.end());
+  }
+
+
+
+  template <int dim>
+  void
+  LateralAveraging<dim>::register_lateral_averages(const std::vector<double> &depth_bounds,
+                                                   const std::vector<std::string> &property_names) const
+  {
+    registered_properties_by_depth_bounds[depth_bounds].insert(property_names.begin(),
+                                                                property_names.end());
+  }
+
+
+
+  template <int dim>
+  std::set<std::string>
+  LateralAveraging<dim>::get_registered_properties(const std::vector<double> &depth_bounds) const
+  {
+    std::set<std::string> property_names;
+
+    const auto by_depth_bounds = registered_properties_by_depth_bounds.find(depth_bounds);
+    if (by_depth_bounds != registered_properties_by_depth_bounds.end())
+      property_names = by_depth_bounds->second;
+
+    const auto by_n_slices = registered_properties_by_n_slices.find(depth_bounds.size()-1);
+    if (by_n_slices != registered_properties_by_n_slices.end() &&
+        compute_equidistant_depth_bounds(by_n_slices->first) == depth_bounds)
+      property_names.insert(by_n_slices->second.begin(), by_n_slices->second.end());
+
+    return property_names;
+  }
+
+
+
+  template <int dim>
+  void
+  LateralAveraging<dim>::invalidate_outdated_averages() const
+  {
+    // Hashing the solution is much cheaper than a pass over the mesh with
+    // the high-resolution quadrature used for the averages. Every process
+    // compares its own part of the solution, and the stored averages are
+    // deleted on all processes if any of them has seen a change.
+    std::size_t solution_hash = 0;
+    const LinearAlgebra::BlockVector &solution = this->get_solution();
+    for (unsigned int b=0; b<solution.n_blocks(); ++b)
+      for (const auto index : solution.block(b).locally_owned_elements())
+        solution_hash ^= std::hash<double>()(solution.block(b)(index))
+                         + 0x9e3779b9 + (solution_hash << 6) + (solution_hash >> 2);
+
+    const bool locally_changed = (solution_hash != cached_solution_hash
+                                  || this->get_time() != cached_time
+                                  || this->get_timestep_number() != cached_timestep_number);
+
+    cached_solution_hash = solution_hash;
+    cached_time = this->get_time();
+    cached_timestep_number = this->get_timestep_number();
+
+    if (Utilities::MPI::max(locally_changed ? 1U : 0U, this->get_mpi_communicator()) == 1U)
+      cached_averages.clear();
   }
 
 
@@ -841,115 +924,172 @@ namespace aspect
   LateralAveraging<dim>::compute_lateral_averages(const std::vector<double> &depth_thresholds,
                                                   const std::vector<std::string> &property_names) const
   {
-    std::vector<std::unique_ptr<internal::FunctorBase<dim>>> functors;
+    invalidate_outdated_averages();
+
+    std::map<std::string, std::vector<double>> &stored_values = cached_averages[depth_thresholds];
+
+    // Collect the properties that have not yet been computed for the
+    // current solution in these depth slices.
+    std::vector<std::string> missing_property_names;
     for (const auto &property_name : property_names)
+      if (stored_values.find(property_name) == stored_values.end() &&
+          std::find(missing_property_names.begin(), missing_property_names.end(), property_name)
+          == missing_property_names.end())
+        missing_property_names.push_back(property_name);
+
+    if (missing_property_names.size() > 0)
       {
-        if (property_name == "temperature")
+        std::vector<std::unique_ptr<internal::FunctorBase<dim>>> functors;
+        bool functors_need_material_output = false;
+        for (const auto &property_name : missing_property_names)
           {
-            functors.push_back(std::make_unique<FunctorDepthAverageField<dim>>
-                               (this->introspection().extractors.temperature));
+            functors.push_back(create_functor(property_name));
+            if (functors.back()->need_material_properties())
+              functors_need_material_output = true;
           }
-        else if (this->introspection().compositional_name_exists(property_name))
-          {
-            const unsigned int c =
-              this->introspection().compositional_index_for_name(property_name);
 
-            functors.push_back(std::make_unique<FunctorDepthAverageField<dim>> (
-                                 this->introspection().extractors.compositional_fields[c]));
-          }
-        else if (property_name == "velocity_magnitude")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageVelocityMagnitude<dim>>
-                               (this->introspection().extractors.velocities,
-                                this->convert_output_to_years()));
-          }
-        else if (property_name == "sinking_velocity")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageSinkingVelocity<dim>>
-                               (this->introspection().extractors.velocities,
-                                &this->get_gravity_model(),
-                                this->convert_output_to_years()));
-          }
-        else if (property_name == "rising_velocity")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageRisingVelocity<dim>>
-                               (this->introspection().extractors.velocities,
-                                &this->get_gravity_model(),
-                                this->convert_output_to_years()));
-          }
-        else if (property_name == "Vs")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageVsVp<dim>> (true /* Vs */));
-          }
-        else if (property_name == "Vp")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageVsVp<dim>> (false /* Vp */));
-          }
-        else if (property_name == "viscosity")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageViscosity<dim>>());
-          }
-        else if (property_name == "log_viscosity")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageLogViscosity<dim>>());
-          }
-        else if (property_name == "vertical_heat_flux")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageVerticalHeatFlux<dim>>
-                               (this->introspection().extractors.velocities,
-                                this->introspection().extractors.temperature,
-                                &this->get_gravity_model()));
-          }
-        else if (property_name == "vertical_mass_flux")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageVerticalMassFlux<dim>>
-                               (this->introspection().extractors.velocities,
-                                &this->get_gravity_model()));
-          }
-        else if (this->introspection().compositional_name_exists(property_name.substr(0, property_name.size()-5)) &&
-                 property_name.substr(property_name.size()-5) == "_mass")
-          {
-            const unsigned int c =
-              this->introspection().compositional_index_for_name(property_name.substr(0, property_name.size()-5));
+        // Also compute the properties other plugins have registered for
+        // these depth slices, so that they do not need their own pass
+        // over the mesh later on. Do not evaluate the material model only
+        // for the registered properties though, because that would make
+        // this pass much more expensive.
+        for (const auto &property_name : get_registered_properties(depth_thresholds))
+          if (stored_values.find(property_name) == stored_values.end() &&
+              std::find(missing_property_names.begin(), missing_property_names.end(), property_name)
+              == missing_property_names.end())
+            {
+              std::unique_ptr<internal::FunctorBase<dim>> functor = create_functor(property_name);
+              if (functors_need_material_output || functor->need_material_properties() == false)
+                {
+                  missing_property_names.push_back(property_name);
+                  functors.push_back(std::move(functor));
+                }
+            }
 
-            functors.push_back(std::make_unique<FunctorDepthAverageFieldMass<dim>> (
-                                 this->introspection().extractors.compositional_fields[c]));
-          }
-        else if (property_name == "adiabatic_temperature")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageAdiabat<dim>>
-                               (FunctorDepthAverageAdiabat<dim>::temperature,
-                                this->get_adiabatic_conditions()));
-          }
-        else if (property_name == "adiabatic_pressure")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageAdiabat<dim>>
-                               (FunctorDepthAverageAdiabat<dim>::pressure,
-                                this->get_adiabatic_conditions()));
-          }
-        else if (property_name == "adiabatic_density")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageAdiabat<dim>>
-                               (FunctorDepthAverageAdiabat<dim>::density,
-                                this->get_adiabatic_conditions()));
-          }
-        else if (property_name == "adiabatic_density_derivative")
-          {
-            functors.push_back(std::make_unique<FunctorDepthAverageAdiabat<dim>>
-                               (FunctorDepthAverageAdiabat<dim>::density_derivative,
-                                this->get_adiabatic_conditions()));
-          }
-        else
-          {
-            AssertThrow(false,
-                        ExcMessage("The lateral averaging scheme was asked to average the property "
-                                   "named <" + property_name + ">, but it does not know how "
-                                   "to do that. There is no functor implemented that computes this property."));
-          }
+        // Now compute values for all selected properties.
+        std::vector<std::vector<double>> values = compute_lateral_averages(depth_thresholds, functors);
+        for (unsigned int i=0; i<missing_property_names.size(); ++i)
+          stored_values[missing_property_names[i]] = std::move(values[i]);
+      }
+
+    std::vector<std::vector<double>> values;
+    values.reserve(property_names.size());
+    for (const auto &property_name : property_names)
+      values.push_back(stored_values[property_name]);
+
+    return values;
+  }
+
+
+
+  template <int dim>
+  std::unique_ptr<internal::FunctorBase<dim>>
+  LateralAveraging<dim>::create_functor(const std::string &property_name) const
+  {
+    if (property_name == "temperature")
+      {
+        return std::make_unique<FunctorDepthAverageField<dim>>
+               (this->introspection().extractors.temperature);
+      }
+    else if (this->introspection().compositional_name_exists(property_name))
+      {
+        const unsigned int c =
+          this->introspection().compositional_index_for_name(property_name);
+
+        return std::make_unique<FunctorDepthAverageField<dim>> (
+                 this->introspection().extractors.compositional_fields[c]);
+      }
+    else if (property_name == "velocity_magnitude")
+      {
+        return std::make_unique<FunctorDepthAverageVelocityMagnitude<dim>>
+               (this->introspection().extractors.velocities,
+                this->convert_output_to_years());
+      }
+    else if (property_name == "sinking_velocity")
+      {
+        return std::make_unique<FunctorDepthAverageSinkingVelocity<dim>>
+               (this->introspection().extractors.velocities,
+                &this->get_gravity_model(),
+                this->convert_output_to_years());
+      }
+    else if (property_name == "rising_velocity")
+      {
+        return std::make_unique<FunctorDepthAverageRisingVelocity<dim>>
+               (this->introspection().extractors.velocities,
+                &this->get_gravity_model(),
+                this->convert_output_to_years());
+      }
+    else if (property_name == "Vs")
+      {
+        return std::make_unique<FunctorDepthAverageVsVp<dim>> (true /* Vs */);
+      }
+    else if (property_name == "Vp")
+      {
+        return std::make_unique<FunctorDepthAverageVsVp<dim>> (false /* Vp */);
+      }
+    else if (property_name == "viscosity")
+      {
+        return std::make_unique<FunctorDepthAverageViscosity<dim>>();
+      }
+    else if (property_name == "log_viscosity")
+      {
+        return std::make_unique<FunctorDepthAverageLogViscosity<dim>>();
+      }
+    else if (property_name == "vertical_heat_flux")
+      {
+        return std::make_unique<FunctorDepthAverageVerticalHeatFlux<dim>>
+               (this->introspection().extractors.velocities,
+                this->introspection().extractors.temperature,
+                &this->get_gravity_model());
+      }
+    else if (property_name == "vertical_mass_flux")
+      {
+        return std::make_unique<FunctorDepthAverageVerticalMassFlux<dim>>
+               (this->introspection().extractors.velocities,
+                &this->get_gravity_model());
+      }
+    else if (this->introspection().compositional_name_exists(property_name.substr(0, property_name.size()-5)) &&
+             property_name.substr(property_name.size()-5) == "_mass")
+      {
+        const unsigned int c =
+          this->introspection().compositional_index_for_name(property_name.substr(0, property_name.size()-5));
+
+        return std::make_unique<FunctorDepthAverageFieldMass<dim>> (
+                 this->introspection().extractors.compositional_fields[c]);
+      }
+    else if (property_name == "adiabatic_temperature")
+      {
+        return std::make_unique<FunctorDepthAverageAdiabat<dim>>
+               (FunctorDepthAverageAdiabat<dim>::temperature,
+                this->get_adiabatic_conditions());
+      }
+    else if (property_name == "adiabatic_pressure")
+      {
+        return std::make_unique<FunctorDepthAverageAdiabat<dim>>
+               (FunctorDepthAverageAdiabat<dim>::pressure,
+                this->get_adiabatic_conditions());
+      }
+    else if (property_name == "adiabatic_density")
+      {
+        return std::make_unique<FunctorDepthAverageAdiabat<dim>>
+               (FunctorDepthAverageAdiabat<dim>::density,
+                this->get_adiabatic_conditions());
+      }
+    else if (property_name == "adiabatic_density_derivative")
+      {
+        return std::make_unique<FunctorDepthAverageAdiabat<dim>>
+               (FunctorDepthAverageAdiabat<dim>::density_derivative,
+                this->get_adiabatic_conditions());
+      }
+    else
+      {
+        AssertThrow(false,
+                    ExcMessage("The lateral averaging scheme was asked to average the property "
+                               "named <" + property_name + ">, but it does not know how "
+                               "to do that. There is no functor implemented that computes this property."));
       }
 
-    // Now compute values for all selected properties.
-    return compute_lateral_averages(depth_thresholds, functors);
+    return nullptr;
   }
 }
 
@@ -388,6 +388,20 @@ namespace aspect
                            "increasing this number increases the memory usage "
                            "of the advection solver, and makes individual "
                            "iterations more expensive.");
+        prm.declare_entry ("Assemble compositional fields together", "false",
+                           Patterns::Bool(),
+                           "If set to true, the linear systems of all compositional "
+                           "fields that are solved with a finite element method and use "
+                           "the same finite element are assembled in a single loop over "
+                           "all cells, rather than one loop per field. The material model "
+                           "and the heating models are then evaluated only once per cell "
+                           "for all of these fields, which makes the assembly much faster "
+                           "for models with many compositional fields. On the other hand, "
+                           "the matrices of all of these fields need to be stored at the "
+                           "same time, which increases the memory usage. Fields that "
+                           "use discontinuous elements with face terms, or whose method "
+                           "is 'prescribed field with diffusion', are always assembled "
+                           "separately.");
       }
       prm.leave_subsection();
 
@@ -399,8 +413,15 @@ namespace aspect
                            "This is the type of solver used on the Stokes system. The block geometric "
                            "multigrid solver currently has a limited implementation and therefore "
                            "may trigger Asserts in the code when used. If this is the case, "
-                           "please switch to 'block AMG'. Additionally, the block GMG solver requires "
-                           "using material model averaging. The 'default solver' chooses "
+                           "please switch to 'block AMG'. If material model averaging is disabled, "
+                           "the block GMG solver uses the viscosity at the quadrature points on the "
+                           "active mesh and its projection to Q1 on the coarser multigrid levels. "
+                           "With melt transport, only the velocity block uses the multigrid "
+                           "hierarchy. The pressure block, which contains the Laplacian of the "
+                           "Darcy coefficient $K_D$, is assembled into a sparse matrix on the "
+                           "active mesh and preconditioned with one V-cycle of algebraic "
+                           "multigrid, like in the 'block AMG' solver. "
+                           "The 'default solver' chooses "
                            "the geometric multigrid solver if supported, otherwise the AMG solver.");
 
         prm.declare_entry ("Use direct solver for Stokes system", "false",
@@ -930,6 +951,25 @@ namespace aspect
                          "If 0 and time between checkpoint is not specified, "
                          "checkpointing will not be performed. "
                          "Units: None.");
+      prm.declare_entry ("Incremental checkpoints", "false",
+                         Patterns::Bool (),
+                         "Whether checkpoints should only write the data that has changed "
+                         "since the previous checkpoint. If true, the mesh and its partition "
+                         "are only written if the mesh has changed since the previous "
+                         "checkpoint, and the solution vectors are stored separately "
+                         "from the mesh, split into blocks of values that are saved in the "
+                         "directory `restart.vectors/' of the output directory under the hash "
+                         "of their content. Each checkpoint only writes the blocks that are "
+                         "not already stored for one of the previous checkpoints, for example "
+                         "because the old solution of the current time step is the solution "
+                         "that was stored in the previous checkpoint, and blocks that are no "
+                         "longer used are deleted. A model can only be resumed from an "
+                         "incremental checkpoint with the same number of processes that "
+                         "wrote it. Models with particles always write complete checkpoints, "
+                         "because the particles are stored together with the mesh and its "
+                         "partition depends on them. Models can be resumed from incremental "
+                         "and from complete checkpoints independently of the value of this "
+                         "parameter.");
     }
     prm.leave_subsection ();
 
@@ -1502,6 +1542,7 @@ namespace aspect
       prm.enter_subsection ("Advection solver parameters");
       {
         advection_gmres_restart_length     = prm.get_integer("GMRES solver restart length");
+        assemble_compositional_fields_together = prm.get_bool("Assemble compositional fields together");
       }
       prm.leave_subsection ();
 
@@ -1754,6 +1795,7 @@ namespace aspect
     {
       checkpoint_time_secs = prm.get_integer ("Time between checkpoint");
       checkpoint_steps     = prm.get_integer ("Steps between checkpoint");
+      incremental_checkpoints = prm.get_bool ("Incremental checkpoints");
 
 #ifndef DEAL_II_WITH_ZLIB
       AssertThrow ((checkpoint_time_secs == 0)
@@ -246,6 +246,38 @@ namespace aspect
 
     std::vector<AdvectionField> fields_advected_by_particles;
 
+    // If requested, assemble the systems of all fields that use the same
+    // finite element in one loop over all cells, before solving them one
+    // after the other below. All fields are assembled at the same
+    // linearization point anyway. Fields whose assembly needs face terms
+    // or that first need to be interpolated from the material model are
+    // assembled separately.
+    std::vector<bool> field_is_assembled (introspection.n_compositional_fields, false);
+    if (parameters.assemble_compositional_fields_together)
+      {
+        std::map<unsigned int, std::vector<AdvectionField>> fields_by_base_element;
+        for (unsigned int c=0; c < introspection.n_compositional_fields; ++c)
+          {
+            const AdvectionField adv_field (AdvectionField::composition(c));
+            const typename Parameters<dim>::AdvectionFieldMethod::Kind method = adv_field.advection_method(introspection);
+
+            if ((method == Parameters<dim>::AdvectionFieldMethod::fem_field ||
+                 method == Parameters<dim>::AdvectionFieldMethod::fem_melt_field ||
+                 method == Parameters<dim>::AdvectionFieldMethod::fem_darcy_field)
+                &&
+                !assemblers->advection_system_assembler_on_face_properties[adv_field.field_index()].need_face_finite_element_evaluation)
+              fields_by_base_element[adv_field.base_element(introspection)].push_back(adv_field);
+          }
+
+        for (const auto &fields : fields_by_base_element)
+          if (fields.second.size() > 1)
+            {
+              assemble_advection_systems (fields.second);
+              for (const AdvectionField &adv_field : fields.second)
+                field_is_assembled[adv_field.compositional_variable] = true;
+            }
+      }
+
     for (unsigned int c=0; c < introspection.n_compositional_fields; ++c)
       {
         const AdvectionField adv_field (AdvectionField::composition(c));
@@ -271,7 +303,8 @@ namespace aspect
                   old_solution.block(adv_field.block_index(introspection)) = solution.block(adv_field.block_index(introspection));
                 }
 
-              assemble_advection_system (adv_field);
+              if (!field_is_assembled[c])
+                assemble_advection_system (adv_field);
 
               if (residual)
                 (*residual)[c] = system_rhs.block(introspection.block_indices.compositional_fields[c]).l2_norm();
@@ -26,7 +26,9 @@
 #include <aspect/melt.h>
 #include <aspect/newton.h>
 
+#include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/signaling_nan.h>
+#include <deal.II/base/work_stream.h>
 
 #include <deal.II/dofs/dof_renumbering.h>
 #include <deal.II/dofs/dof_accessor.h>
@@ -38,6 +40,8 @@
 #include <deal.II/fe/fe_dgq.h>
 #include <deal.II/fe/fe_values.h>
 
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/trilinos_sparsity_pattern.h>
 #include <deal.II/lac/solver_gmres.h>
 #include <deal.II/lac/read_write_vector.templates.h>
 #include <deal.II/lac/solver_idr.h>
@@ -332,9 +336,194 @@ namespace aspect
           n_iterations_A_ += 1;
         }
     }
+
+
+
+    /**
+     * The preconditioner for the Schur complement approximation. For a
+     * continuous pressure element, this is one V-cycle of the geometric
+     * multigrid method. For a discontinuous pressure element, the Schur
+     * complement approximation (the pressure mass matrix weighted by the
+     * inverse of the viscosity) is block diagonal with one block per cell,
+     * and we can apply its exact inverse instead. In models with melt
+     * transport, the approximation contains a Darcy term for the fluid
+     * pressure and we apply an AMG V-cycle on the assembled matrix.
+     */
+    template <class GMGPreconditionerType, class MassMatrixType, class AMGPreconditionerType>
+    class SchurComplementPreconditioner : public Subscriptor
+    {
+      public:
+        /**
+         * Constructor. Exactly one of @p gmg_preconditioner and
+         * @p amg_preconditioner is used if it is not a nullptr. If
+         * both are a nullptr, the inverse of the block diagonal of
+         * @p mass_matrix is applied, see
+         * MassMatrixOperator::apply_inverse_block_diagonal().
+         */
+        SchurComplementPreconditioner (const GMGPreconditionerType *gmg_preconditioner,
+                                       const AMGPreconditionerType *amg_preconditioner,
+                                       const MassMatrixType        &mass_matrix)
+          :
+          gmg_preconditioner (gmg_preconditioner),
+          amg_preconditioner (amg_preconditioner),
+          mass_matrix (mass_matrix)
+        {
+          Assert (gmg_preconditioner == nullptr || amg_preconditioner == nullptr,
+                  ExcInternalError());
+        }
+
+        void vmult (dealii::LinearAlgebra::distributed::Vector<double>       &dst,
+                    const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+        {
+          if (gmg_preconditioner != nullptr)
+            gmg_preconditioner->vmult (dst, src);
+          else if (amg_preconditioner != nullptr)
+            amg_preconditioner->vmult (dst, src);
+          else
+            mass_matrix.apply_inverse_block_diagonal (dst, src);
+        }
+
+      private:
+        const GMGPreconditionerType *gmg_preconditioner;
+        const AMGPreconditionerType *amg_preconditioner;
+        const MassMatrixType        &mass_matrix;
+    };
+  }
+
+
+  namespace internal
+  {
+    /**
+     * Scratch and copy data objects used to evaluate the material model
+     * on the active mesh of the matrix-free Stokes solver in parallel using
+     * WorkStream. See StokesMatrixFreeHandlerImplementation::evaluate_material_model().
+     */
+    namespace MaterialModelEvaluation
+    {
+      template <int dim>
+      struct Scratch
+      {
+        Scratch (const Mapping<dim>       &mapping,
+                 const FiniteElement<dim> &finite_element,
+                 const FiniteElement<dim> &projection_finite_element,
+                 const Quadrature<dim>    &quadrature,
+                 const unsigned int        n_compositional_fields,
+                 const bool                include_melt_transport)
+          :
+          fe_values (mapping, finite_element, quadrature,
+                     update_values   |
+                     update_gradients |
+                     update_quadrature_points |
+                     update_JxW_values),
+          fe_values_projection (mapping, projection_finite_element, quadrature,
+                                update_values |
+                                update_JxW_values),
+          material_model_inputs (quadrature.size(), n_compositional_fields),
+          material_model_outputs (quadrature.size(), n_compositional_fields),
+          local_mass_matrix (projection_finite_element.dofs_per_cell,
+                             projection_finite_element.dofs_per_cell),
+          local_rhs (projection_finite_element.dofs_per_cell)
+        {
+          // Models with melt transport also need the additional melt outputs
+          // and the properties that p_c_scale() depends on.
+          material_model_inputs.requested_properties = (include_melt_transport
+                                                        ?
+                                                        MaterialModel::MaterialProperties::all_properties
+                                                        :
+                                                        MaterialModel::MaterialProperties::viscosity);
+        }
+
+        Scratch (const Scratch &scratch)
+          :
+          fe_values (scratch.fe_values.get_mapping(),
+                     scratch.fe_values.get_fe(),
+                     scratch.fe_values.get_quadrature(),
+                     scratch.fe_values.get_update_flags()),
+          fe_values_projection (scratch.fe_values_projection.get_mapping(),
+                                scratch.fe_values_projection.get_fe(),
+                                scratch.fe_values_projection.get_quadrature(),
+                                scratch.fe_values_projection.get_update_flags()),
+          material_model_inputs (scratch.material_model_inputs),
+          material_model_outputs (scratch.material_model_outputs),
+          local_mass_matrix (scratch.local_mass_matrix),
+          local_rhs (scratch.local_rhs)
+        {}
+
+        FEValues<dim> fe_values;
+        FEValues<dim> fe_values_projection;
+
+        MaterialModel::MaterialModelInputs<dim> material_model_inputs;
+        MaterialModel::MaterialModelOutputs<dim> material_model_outputs;
+
+        FullMatrix<double> local_mass_matrix;
+        Vector<double> local_rhs;
+      };
+
+
+
+      template <int dim>
+      struct CopyData
+      {
+        CopyData (const unsigned int projection_dofs_per_cell,
+                  const unsigned int n_q_points,
+                  const bool         include_melt_transport)
+          :
+          cell_batch (numbers::invalid_unsigned_int),
+          lane (numbers::invalid_unsigned_int),
+          local_dof_indices (projection_dofs_per_cell),
+          local_projection (projection_dofs_per_cell),
+          values_on_quad (n_q_points),
+          minimum_viscosity (std::numeric_limits<double>::max()),
+          maximum_viscosity (std::numeric_limits<double>::lowest()),
+          darcy_coefficients (include_melt_transport ? n_q_points : 0),
+          compaction_viscosities (include_melt_transport ? n_q_points : 0),
+          fluid_density_gradients (include_melt_transport ? n_q_points : 0),
+          p_c_scale (numbers::signaling_nan<double>())
+        {}
+
+        /**
+         * The cell batch and the lane within the batch of the MatrixFree
+         * object that the current cell corresponds to.
+         */
+        unsigned int cell_batch;
+        unsigned int lane;
+
+        /**
+         * The DoF indices and the values of the cellwise projection of
+         * the viscosity on the DoFHandler used for the projection.
+         */
+        std::vector<types::global_dof_index> local_dof_indices;
+        Vector<double> local_projection;
+
+        /**
+         * The projected viscosity evaluated at the quadrature points. For
+         * a DGQ0 projection only the first entry is used.
+         */
+        std::vector<double> values_on_quad;
+
+        /**
+         * The extreme values of the viscosity evaluated on this cell.
+         */
+        double minimum_viscosity;
+        double maximum_viscosity;
+
+        /**
+         * The coefficients of the melt transport terms evaluated at the
+         * quadrature points, and the scaling factor of the compaction
+         * pressure on this cell. These are only used in models with melt
+         * transport. The fluid density gradients are already multiplied by
+         * the Darcy coefficient and divided by the fluid density.
+         */
+        std::vector<double> darcy_coefficients;
+        std::vector<double> compaction_viscosities;
+        std::vector<Tensor<1,dim>> fluid_density_gradients;
+        double p_c_scale;
+      };
+    }
   }
 
 
+
   namespace MatrixFreeStokesOperators
   {
     template <int dim, typename number>
@@ -344,7 +533,12 @@ namespace aspect
       return viscosity.memory_consumption()
              + newton_factor_wrt_pressure_table.memory_consumption()
              + strain_rate_table.memory_consumption()
-             + newton_factor_wrt_strain_rate_table.memory_consumption();
+             + newton_factor_wrt_strain_rate_table.memory_consumption()
+             + darcy_coefficient_table.memory_consumption()
+             + inverse_compaction_viscosity_table.memory_consumption()
+             + fluid_density_gradient_table.memory_consumption()
+             + compaction_pressure_scaling_table.memory_consumption()
+             + MemoryConsumption::memory_consumption(constrained_compaction_pressure_dofs);
     }
 
 
@@ -358,6 +552,96 @@ namespace aspect
       newton_factor_wrt_pressure_table.clear();
       strain_rate_table.clear();
       newton_factor_wrt_strain_rate_table.clear();
+      include_melt_transport = false;
+      darcy_coefficient_table.clear();
+      inverse_compaction_viscosity_table.clear();
+      fluid_density_gradient_table.clear();
+      compaction_pressure_scaling_table.clear();
+      constrained_compaction_pressure_dofs.clear();
+    }
+
+
+
+    /**
+     * The Newton derivative terms of the Stokes operator at a quadrature
+     * point q contain sums over all quadrature points r of the cell, e.g.
+     * $\sum_r \frac{\partial\eta}{\partial\varepsilon}(r) : \varepsilon(u)(r)$,
+     * because the derivatives stored in OperatorCellData include the
+     * weights of the material averaging. These sums do not depend on q, so
+     * we compute them once per cell batch with this function before the
+     * loop over quadrature points, and then add the Newton terms with
+     * add_newton_velocity_terms() below.
+     */
+    template <int dim, typename number>
+    struct NewtonCellSums
+    {
+      NewtonCellSums ()
+        :
+        deta_deps_times_sym_grad_u (0.),
+        eps_times_sym_grad_u (0.),
+        deta_dp_times_p (0.)
+      {}
+
+      VectorizedArray<number> deta_deps_times_sym_grad_u;
+      VectorizedArray<number> eps_times_sym_grad_u;
+      VectorizedArray<number> deta_dp_times_p;
+    };
+
+
+
+    /**
+     * Compute the sums described above for one cell batch. The pressure is
+     * only needed for the full Stokes operator. If @p pressure is a nullptr,
+     * the pressure contribution is not computed, which allows us to use the
+     * same kernel for the StokesOperator and the ABlockOperator.
+     */
+    template <int dim, int degree_v, typename number>
+    NewtonCellSums<dim,number>
+    compute_newton_cell_sums (const OperatorCellData<dim,number>                        &cell_data,
+                              const unsigned int                                          cell,
+                              const FEEvaluation<dim,degree_v,degree_v+1,dim,number>     &velocity,
+                              const FEEvaluation<dim,degree_v-1,degree_v+1,1,number>     *pressure)
+    {
+      NewtonCellSums<dim,number> sums;
+
+      for (const unsigned int r : velocity.quadrature_point_indices())
+        {
+          const SymmetricTensor<2,dim,VectorizedArray<number>> sym_grad_u_r = velocity.get_symmetric_gradient(r);
+
+          sums.deta_deps_times_sym_grad_u += cell_data.newton_factor_wrt_strain_rate_table(cell,r)
+                                             * sym_grad_u_r;
+          if (cell_data.symmetrize_newton_system)
+            sums.eps_times_sym_grad_u += cell_data.strain_rate_table(cell,r) * sym_grad_u_r;
+          if (pressure != nullptr)
+            sums.deta_dp_times_p += cell_data.newton_factor_wrt_pressure_table(cell,r) * pressure->get_value(r);
+        }
+
+      return sums;
+    }
+
+
+
+    /**
+     * Add the Newton derivative terms at quadrature point @p q to the terms
+     * that are tested by the symmetric gradients of the velocity shape
+     * functions.
+     */
+    template <int dim, typename number>
+    inline
+    void
+    add_newton_velocity_terms (const OperatorCellData<dim,number>             &cell_data,
+                               const unsigned int                               cell,
+                               const unsigned int                               q,
+                               const NewtonCellSums<dim,number>                &sums,
+                               SymmetricTensor<2,dim,VectorizedArray<number>>  &velocity_terms)
+    {
+      velocity_terms +=
+        ( cell_data.symmetrize_newton_system ?
+          ( cell_data.strain_rate_table(cell,q) * sums.deta_deps_times_sym_grad_u +
+            cell_data.newton_factor_wrt_strain_rate_table(cell,q) * sums.eps_times_sym_grad_u ) :
+          2. * cell_data.strain_rate_table(cell,q) * sums.deta_deps_times_sym_grad_u )
+        +
+        2. * cell_data.strain_rate_table(cell,q) * sums.deta_dp_times_p;
     }
   }
 
@@ -428,20 +712,14 @@ namespace aspect
         p_eval.reinit(cell);
         p_eval.gather_evaluate(src.block(1), EvaluationFlags::values);
 
-        // Store the symmetric gradients of the velocity field and the
-        // values of the pressure field
-        AlignedVector<SymmetricTensor<2,dim,VectorizedArray<number>>> sym_grad_u;
-        AlignedVector<VectorizedArray<number>> val_p;
-        if (cell_data->enable_newton_derivatives)
-          {
-            sym_grad_u.resize(u_eval.n_q_points);
-            val_p.resize(u_eval.n_q_points);
-            for (const unsigned int r : u_eval.quadrature_point_indices())
-              {
-                sym_grad_u[r] = u_eval.get_symmetric_gradient(r);
-                val_p[r]      = p_eval.get_value(r);
-              }
-          }
+        // Compute the sums over all quadrature points that appear in the
+        // Newton derivative terms once per cell batch.
+        const NewtonCellSums<dim,number> newton_sums =
+          (cell_data->enable_newton_derivatives
+           ?
+           compute_newton_cell_sums(*cell_data, cell, u_eval, &p_eval)
+           :
+           NewtonCellSums<dim,number>());
 
         for (const unsigned int q : u_eval.quadrature_point_indices())
           {
@@ -471,27 +749,7 @@ namespace aspect
 
             // Add the Newton derivatives if required.
             if (cell_data->enable_newton_derivatives)
-              {
-                VectorizedArray<number> deta_deps_times_sym_grad_u(0.);
-                VectorizedArray<number> eps_times_sym_grad_u(0.);
-                VectorizedArray<number> deta_dp_times_p(0.);
-                for (const unsigned int r : u_eval.quadrature_point_indices())
-                  {
-                    deta_deps_times_sym_grad_u += cell_data->newton_factor_wrt_strain_rate_table(cell,r)
-                                                  * sym_grad_u[r];
-                    deta_dp_times_p += cell_data->newton_factor_wrt_pressure_table(cell,r) * val_p[r];
-                    if (cell_data->symmetrize_newton_system)
-                      eps_times_sym_grad_u += cell_data->strain_rate_table(cell,r) * sym_grad_u[r];
-                  }
-
-                velocity_terms +=
-                  ( cell_data->symmetrize_newton_system ?
-                    ( cell_data->strain_rate_table(cell,q) * deta_deps_times_sym_grad_u +
-                      cell_data->newton_factor_wrt_strain_rate_table(cell,q) * eps_times_sym_grad_u ) :
-                    2. * cell_data->strain_rate_table(cell,q) * deta_deps_times_sym_grad_u )
-                  +
-                  2. * cell_data->strain_rate_table(cell,q) * deta_dp_times_p;
-              }
+              add_newton_velocity_terms(*cell_data, cell, q, newton_sums, velocity_terms);
 
             u_eval.submit_symmetric_gradient(velocity_terms, q);
             p_eval.submit_value(pressure_terms, q);
@@ -504,6 +762,105 @@ namespace aspect
 
 
 
+  template <int dim, int degree_v, typename number>
+  void
+  MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>
+  ::local_apply_melt (const dealii::MatrixFree<dim, number>                         &data,
+                      dealii::LinearAlgebra::distributed::BlockVector<number>       &dst,
+                      const dealii::LinearAlgebra::distributed::BlockVector<number> &src,
+                      const std::pair<unsigned int, unsigned int>                   &cell_range) const
+  {
+    // The pressure DoFHandler contains the fluid pressure as its first and
+    // the compaction pressure as its second component. The operator is the
+    // one assembled by Assemblers::MeltStokesSystem.
+    FEEvaluation<dim,degree_v,degree_v+1,dim,number> u_eval(data, 0);
+    FEEvaluation<dim,degree_v-1,degree_v+1,1,number> p_f_eval(data, /*dofh*/1, /*quad*/0, /*component*/0);
+    FEEvaluation<dim,degree_v-1,degree_v+1,1,number> p_c_eval(data, /*dofh*/1, /*quad*/0, /*component*/1);
+
+    const bool use_viscosity_at_quadrature_points
+      = (cell_data->viscosity.size(1) == u_eval.n_q_points);
+    const bool use_fluid_density_gradient
+      = (cell_data->fluid_density_gradient_table.size(0) > 0);
+
+    const number pressure_scaling = cell_data->pressure_scaling;
+
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        VectorizedArray<number> viscosity_x_2 = 2. * cell_data->viscosity(cell,0);
+        const VectorizedArray<number> p_c_scale = cell_data->compaction_pressure_scaling_table(cell,0);
+
+        u_eval.reinit(cell);
+        u_eval.gather_evaluate(src.block(0), EvaluationFlags::gradients);
+
+        p_f_eval.reinit(cell);
+        p_f_eval.gather_evaluate(src.block(1), EvaluationFlags::values | EvaluationFlags::gradients);
+
+        p_c_eval.reinit(cell);
+        p_c_eval.gather_evaluate(src.block(1), EvaluationFlags::values);
+
+        const NewtonCellSums<dim,number> newton_sums =
+          (cell_data->enable_newton_derivatives
+           ?
+           compute_newton_cell_sums(*cell_data, cell, u_eval, &p_f_eval)
+           :
+           NewtonCellSums<dim,number>());
+
+        for (const unsigned int q : u_eval.quadrature_point_indices())
+          {
+            if (use_viscosity_at_quadrature_points)
+              viscosity_x_2 = 2. * cell_data->viscosity(cell,q);
+
+            const SymmetricTensor<2,dim,VectorizedArray<number>>
+            sym_grad_u_q = u_eval.get_symmetric_gradient(q);
+            const VectorizedArray<number> div_u_q = trace(sym_grad_u_q);
+            const VectorizedArray<number> val_p_f_q = p_f_eval.get_value(q);
+            const Tensor<1,dim,VectorizedArray<number>> grad_p_f_q = p_f_eval.get_gradient(q);
+            const VectorizedArray<number> val_p_c_q = p_c_eval.get_value(q);
+
+            // Terms to be tested by the symmetric gradients of phi_u. The
+            // formulation with melt transport always contains the
+            // compressible term of the solid velocity:
+            SymmetricTensor<2,dim,VectorizedArray<number>>
+            velocity_terms = viscosity_x_2 * sym_grad_u_q;
+
+            const VectorizedArray<number> diagonal_terms
+              = viscosity_x_2 / 3. * div_u_q
+                + pressure_scaling * (val_p_f_q + p_c_scale * val_p_c_q);
+            for (unsigned int d=0; d<dim; ++d)
+              velocity_terms[d][d] -= diagonal_terms;
+
+            if (cell_data->enable_newton_derivatives)
+              add_newton_velocity_terms(*cell_data, cell, q, newton_sums, velocity_terms);
+
+            // Terms to be tested by the values and gradients of phi_p_f:
+            VectorizedArray<number> fluid_pressure_terms = -pressure_scaling * div_u_q;
+            if (use_fluid_density_gradient)
+              fluid_pressure_terms += pressure_scaling * pressure_scaling
+                                      * (cell_data->fluid_density_gradient_table(cell,q) * grad_p_f_q);
+
+            const Tensor<1,dim,VectorizedArray<number>> fluid_pressure_gradient_terms
+              = -pressure_scaling * pressure_scaling * cell_data->darcy_coefficient_table(cell,q) * grad_p_f_q;
+
+            // Terms to be tested by phi_p_c:
+            const VectorizedArray<number> compaction_pressure_terms
+              = -pressure_scaling * p_c_scale * div_u_q
+                - pressure_scaling * pressure_scaling * p_c_scale * p_c_scale
+                * cell_data->inverse_compaction_viscosity_table(cell,q) * val_p_c_q;
+
+            u_eval.submit_symmetric_gradient(velocity_terms, q);
+            p_f_eval.submit_value(fluid_pressure_terms, q);
+            p_f_eval.submit_gradient(fluid_pressure_gradient_terms, q);
+            p_c_eval.submit_value(compaction_pressure_terms, q);
+          }
+
+        u_eval.integrate_scatter(EvaluationFlags::gradients, dst.block(0));
+        p_f_eval.integrate_scatter(EvaluationFlags::values | EvaluationFlags::gradients, dst.block(1));
+        p_c_eval.integrate_scatter(EvaluationFlags::values, dst.block(1));
+      }
+  }
+
+
+
   template <int dim, int degree_v, typename number>
   void
   MatrixFreeStokesOperators::StokesOperator<dim, degree_v, number>
@@ -561,9 +918,15 @@ namespace aspect
   ::apply_add (dealii::LinearAlgebra::distributed::BlockVector<number> &dst,
                const dealii::LinearAlgebra::distributed::BlockVector<number> &src) const
   {
+    const auto cell_operation = (cell_data->include_melt_transport
+                                 ?
+                                 &StokesOperator::local_apply_melt
+                                 :
+                                 &StokesOperator::local_apply);
+
     if (cell_data->apply_stabilization_free_surface_faces)
       MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::BlockVector<number>>::
-      data->loop(&StokesOperator::local_apply,
+      data->loop(cell_operation,
                  &StokesOperator::local_apply_face,
                  &StokesOperator::local_apply_boundary_face,
                  this,
@@ -575,7 +938,14 @@ namespace aspect
 
     else
       MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::BlockVector<number>>::
-      data->cell_loop(&StokesOperator::local_apply, this, dst, src);
+      data->cell_loop(cell_operation, this, dst, src);
+
+    // The compaction pressure outside of melt cells is constrained to zero
+    // by the Simulator. We do not store these constraints in the MatrixFree
+    // object (they change whenever the melt cells change), so the operator
+    // acts as the identity on these DoFs instead.
+    for (const unsigned int i : cell_data->constrained_compaction_pressure_dofs)
+      dst.block(1).local_element(i) += src.block(1).local_element(i);
   }
 
   /**
@@ -594,6 +964,7 @@ namespace aspect
   MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>::clear ()
   {
     this->cell_data = nullptr;
+    inverse_cell_matrices.clear();
     MatrixFreeOperators::Base<dim,dealii::LinearAlgebra::distributed::Vector<number>>::clear();
   }
 
@@ -660,14 +1031,87 @@ namespace aspect
 
 
 
+  template <int dim, int degree_p, typename number>
+  void
+  MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>
+  ::local_apply_melt (const dealii::MatrixFree<dim, number>                    &data,
+                      dealii::LinearAlgebra::distributed::Vector<number>       &dst,
+                      const dealii::LinearAlgebra::distributed::Vector<number> &src,
+                      const std::pair<unsigned int, unsigned int>              &cell_range) const
+  {
+    // This is the operator assembled by Assemblers::MeltStokesPreconditioner,
+    // i.e., the fluid pressure (first component) and the compaction
+    // pressure (second component) are coupled by mass matrices weighted by
+    // the inverse of the viscosity, and the fluid pressure block contains
+    // an additional Darcy term.
+    FEEvaluation<dim,degree_p,degree_p+2,1,number> p_f_eval (data, /*dofh*/1, /*quad*/0, /*component*/0);
+    FEEvaluation<dim,degree_p,degree_p+2,1,number> p_c_eval (data, /*dofh*/1, /*quad*/0, /*component*/1);
+
+    const bool use_viscosity_at_quadrature_points
+      = (cell_data->viscosity.size(1) == p_f_eval.n_q_points);
+
+    const number pressure_scaling_squared = cell_data->pressure_scaling*cell_data->pressure_scaling;
+
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        const unsigned int n_components_filled = this->get_matrix_free()->n_active_entries_per_cell_batch(cell);
+        const VectorizedArray<number> p_c_scale = cell_data->compaction_pressure_scaling_table(cell,0);
+
+        p_f_eval.reinit (cell);
+        p_f_eval.gather_evaluate (src, EvaluationFlags::values | EvaluationFlags::gradients);
+
+        p_c_eval.reinit (cell);
+        p_c_eval.gather_evaluate (src, EvaluationFlags::values);
+
+        for (const unsigned int q : p_f_eval.quadrature_point_indices())
+          {
+            const VectorizedArray<number> viscosity
+              = cell_data->viscosity(cell, use_viscosity_at_quadrature_points ? q : 0);
+
+            // Divide each entry manually, see local_apply().
+            VectorizedArray<number> one_over_viscosity = VectorizedArray<number>();
+            for (unsigned int c=0; c<n_components_filled; ++c)
+              one_over_viscosity[c] = pressure_scaling_squared/viscosity[c];
+
+            const VectorizedArray<number> val_p_f_q = p_f_eval.get_value(q);
+            const VectorizedArray<number> val_p_c_q = p_c_eval.get_value(q);
+
+            p_f_eval.submit_value(one_over_viscosity * (val_p_f_q + p_c_scale * val_p_c_q), q);
+            p_f_eval.submit_gradient(pressure_scaling_squared * cell_data->darcy_coefficient_table(cell,q)
+                                     * p_f_eval.get_gradient(q), q);
+            p_c_eval.submit_value(p_c_scale * one_over_viscosity * val_p_f_q
+                                  + p_c_scale * p_c_scale
+                                  * (one_over_viscosity
+                                     + pressure_scaling_squared * cell_data->inverse_compaction_viscosity_table(cell,q))
+                                  * val_p_c_q, q);
+          }
+
+        p_f_eval.integrate_scatter (EvaluationFlags::values | EvaluationFlags::gradients, dst);
+        p_c_eval.integrate_scatter (EvaluationFlags::values, dst);
+      }
+  }
+
+
+
   template <int dim, int degree_p, typename number>
   void
   MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>
   ::apply_add (dealii::LinearAlgebra::distributed::Vector<number> &dst,
                const dealii::LinearAlgebra::distributed::Vector<number> &src) const
   {
-    MatrixFreeOperators::Base<dim,dealii::LinearAlgebra::distributed::Vector<number>>::
-    data->cell_loop(&MassMatrixOperator::local_apply, this, dst, src);
+    if (cell_data->include_melt_transport)
+      {
+        MatrixFreeOperators::Base<dim,dealii::LinearAlgebra::distributed::Vector<number>>::
+        data->cell_loop(&MassMatrixOperator::local_apply_melt, this, dst, src);
+
+        // Act as the identity on the constrained compaction pressure DoFs,
+        // see StokesOperator::apply_add().
+        for (const unsigned int i : cell_data->constrained_compaction_pressure_dofs)
+          dst.local_element(i) += src.local_element(i);
+      }
+    else
+      MatrixFreeOperators::Base<dim,dealii::LinearAlgebra::distributed::Vector<number>>::
+      data->cell_loop(&MassMatrixOperator::local_apply, this, dst, src);
   }
 
 
@@ -691,8 +1135,17 @@ namespace aspect
     this->data->initialize_dof_vector(inverse_diagonal, /*dofh*/1);
     this->data->initialize_dof_vector(diagonal, /*dofh*/1);
 
-    this->data->cell_loop (&MassMatrixOperator::local_compute_diagonal, this,
-                           diagonal, dummy);
+    if (cell_data->include_melt_transport)
+      {
+        this->data->cell_loop (&MassMatrixOperator::local_compute_diagonal_melt, this,
+                               diagonal, dummy);
+
+        for (const unsigned int i : cell_data->constrained_compaction_pressure_dofs)
+          diagonal.local_element(i) = 1.;
+      }
+    else
+      this->data->cell_loop (&MassMatrixOperator::local_compute_diagonal, this,
+                             diagonal, dummy);
 
     this->set_constrained_entries_to_one(diagonal);
     inverse_diagonal = diagonal;
@@ -778,6 +1231,283 @@ namespace aspect
 
 
 
+  template <int dim, int degree_p, typename number>
+  void
+  MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>
+  ::local_compute_diagonal_melt (const MatrixFree<dim,number>                       &data,
+                                 dealii::LinearAlgebra::distributed::Vector<number> &dst,
+                                 const unsigned int &,
+                                 const std::pair<unsigned int,unsigned int>         &cell_range) const
+  {
+    // The diagonal entries of the fluid and the compaction pressure DoFs
+    // only depend on the diagonal blocks of the operator in
+    // local_apply_melt(), so we can compute them separately.
+    FEEvaluation<dim,degree_p,degree_p+2,1,number> p_f_eval (data, /*dofh*/1, /*quad*/0, /*component*/0);
+    FEEvaluation<dim,degree_p,degree_p+2,1,number> p_c_eval (data, /*dofh*/1, /*quad*/0, /*component*/1);
+
+    AlignedVector<VectorizedArray<number>> diagonal_p_f(p_f_eval.dofs_per_cell);
+    AlignedVector<VectorizedArray<number>> diagonal_p_c(p_c_eval.dofs_per_cell);
+
+    const bool use_viscosity_at_quadrature_points
+      = (cell_data->viscosity.size(1) == p_f_eval.n_q_points);
+
+    const number pressure_scaling_squared = cell_data->pressure_scaling*cell_data->pressure_scaling;
+
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        const unsigned int n_components_filled = this->get_matrix_free()->n_active_entries_per_cell_batch(cell);
+        const VectorizedArray<number> p_c_scale = cell_data->compaction_pressure_scaling_table(cell,0);
+
+        const auto one_over_viscosity = [&](const unsigned int q)
+        {
+          const VectorizedArray<number> viscosity
+            = cell_data->viscosity(cell, use_viscosity_at_quadrature_points ? q : 0);
+
+          VectorizedArray<number> result = VectorizedArray<number>();
+          for (unsigned int c=0; c<n_components_filled; ++c)
+            result[c] = pressure_scaling_squared/viscosity[c];
+          return result;
+        };
+
+        p_f_eval.reinit (cell);
+        for (unsigned int i=0; i<p_f_eval.dofs_per_cell; ++i)
+          {
+            for (unsigned int j=0; j<p_f_eval.dofs_per_cell; ++j)
+              p_f_eval.begin_dof_values()[j] = VectorizedArray<number>();
+            p_f_eval.begin_dof_values()[i] = make_vectorized_array<number> (1.);
+
+            p_f_eval.evaluate (EvaluationFlags::values | EvaluationFlags::gradients);
+
+            for (const unsigned int q : p_f_eval.quadrature_point_indices())
+              {
+                p_f_eval.submit_value(one_over_viscosity(q) * p_f_eval.get_value(q), q);
+                p_f_eval.submit_gradient(pressure_scaling_squared * cell_data->darcy_coefficient_table(cell,q)
+                                         * p_f_eval.get_gradient(q), q);
+              }
+
+            p_f_eval.integrate (EvaluationFlags::values | EvaluationFlags::gradients);
+
+            diagonal_p_f[i] = p_f_eval.begin_dof_values()[i];
+          }
+
+        p_c_eval.reinit (cell);
+        for (unsigned int i=0; i<p_c_eval.dofs_per_cell; ++i)
+          {
+            for (unsigned int j=0; j<p_c_eval.dofs_per_cell; ++j)
+              p_c_eval.begin_dof_values()[j] = VectorizedArray<number>();
+            p_c_eval.begin_dof_values()[i] = make_vectorized_array<number> (1.);
+
+            p_c_eval.evaluate (EvaluationFlags::values);
+
+            for (const unsigned int q : p_c_eval.quadrature_point_indices())
+              p_c_eval.submit_value(p_c_scale * p_c_scale
+                                    * (one_over_viscosity(q)
+                                       + pressure_scaling_squared * cell_data->inverse_compaction_viscosity_table(cell,q))
+                                    * p_c_eval.get_value(q), q);
+
+            p_c_eval.integrate (EvaluationFlags::values);
+
+            diagonal_p_c[i] = p_c_eval.begin_dof_values()[i];
+          }
+
+        for (unsigned int i=0; i<p_f_eval.dofs_per_cell; ++i)
+          p_f_eval.begin_dof_values()[i] = diagonal_p_f[i];
+        p_f_eval.distribute_local_to_global (dst);
+
+        for (unsigned int i=0; i<p_c_eval.dofs_per_cell; ++i)
+          p_c_eval.begin_dof_values()[i] = diagonal_p_c[i];
+        p_c_eval.distribute_local_to_global (dst);
+      }
+  }
+
+
+
+  template <int dim, int degree_p, typename number>
+  void
+  MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>
+  ::compute_inverse_block_diagonal ()
+  {
+    const MatrixFree<dim,number> &data = *this->get_matrix_free();
+
+    FEEvaluation<dim,degree_p,degree_p+2,1,number> pressure (data, 1);
+    const unsigned int dofs_per_cell = pressure.dofs_per_cell;
+
+    inverse_cell_matrices.resize (data.n_cell_batches() * dofs_per_cell * dofs_per_cell);
+
+    AlignedVector<VectorizedArray<number>> cell_matrix (dofs_per_cell * dofs_per_cell);
+    FullMatrix<number> lane_matrix (dofs_per_cell, dofs_per_cell);
+
+    const bool use_viscosity_at_quadrature_points
+      = (cell_data->viscosity.size(1) == pressure.n_q_points);
+
+    for (unsigned int cell=0; cell<data.n_cell_batches(); ++cell)
+      {
+        const unsigned int n_components_filled = data.n_active_entries_per_cell_batch(cell);
+
+        // Compute the cell matrix column by column by applying the operator
+        // to unit vectors, see local_compute_diagonal().
+        pressure.reinit (cell);
+        for (unsigned int j=0; j<dofs_per_cell; ++j)
+          {
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              pressure.begin_dof_values()[i] = VectorizedArray<number>();
+            pressure.begin_dof_values()[j] = make_vectorized_array<number> (1.);
+
+            pressure.evaluate (EvaluationFlags::values);
+
+            for (const unsigned int q : pressure.quadrature_point_indices())
+              {
+                const VectorizedArray<number> viscosity
+                  = cell_data->viscosity(cell, use_viscosity_at_quadrature_points ? q : 0);
+
+                VectorizedArray<number> one_over_viscosity = VectorizedArray<number>();
+                for (unsigned int c=0; c<n_components_filled; ++c)
+                  one_over_viscosity[c] = cell_data->pressure_scaling*cell_data->pressure_scaling/viscosity[c];
+
+                pressure.submit_value(one_over_viscosity*
+                                      pressure.get_value(q),q);
+              }
+
+            pressure.integrate (EvaluationFlags::values);
+
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              cell_matrix[i*dofs_per_cell+j] = pressure.begin_dof_values()[i];
+          }
+
+        // Then invert the matrix of each cell in the batch.
+        for (unsigned int c=0; c<n_components_filled; ++c)
+          {
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              for (unsigned int j=0; j<dofs_per_cell; ++j)
+                lane_matrix(i,j) = cell_matrix[i*dofs_per_cell+j][c];
+
+            lane_matrix.gauss_jordan();
+
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              for (unsigned int j=0; j<dofs_per_cell; ++j)
+                inverse_cell_matrices[(cell*dofs_per_cell+i)*dofs_per_cell+j][c] = lane_matrix(i,j);
+          }
+      }
+  }
+
+
+
+  template <int dim, int degree_p, typename number>
+  void
+  MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>
+  ::apply_inverse_block_diagonal (dealii::LinearAlgebra::distributed::Vector<number>       &dst,
+                                  const dealii::LinearAlgebra::distributed::Vector<number> &src) const
+  {
+    Assert (inverse_cell_matrices.size() > 0,
+            ExcMessage ("You need to call compute_inverse_block_diagonal() first."));
+
+    this->data->cell_loop (&MassMatrixOperator::local_apply_inverse_block_diagonal,
+                           this, dst, src, /*zero_dst_vector=*/ true);
+  }
+
+
+
+  template <int dim, int degree_p, typename number>
+  void
+  MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>
+  ::compute_melt_matrix (const AffineConstraints<number>        &constraints,
+                         dealii::TrilinosWrappers::SparseMatrix &matrix) const
+  {
+    Assert (cell_data->include_melt_transport, ExcInternalError());
+
+    const number pressure_scaling_squared = cell_data->pressure_scaling*cell_data->pressure_scaling;
+
+    // This is the same cell operation as in local_apply_melt(), but with
+    // a single evaluator for the fluid pressure (first component) and the
+    // compaction pressure (second component), which is the interface that
+    // MatrixFreeTools::compute_matrix() expects.
+    const auto cell_operation = [&](FEEvaluation<dim,degree_p,degree_p+2,2,number> &pressure)
+    {
+      const unsigned int cell = pressure.get_current_cell_index();
+      const unsigned int n_components_filled = this->get_matrix_free()->n_active_entries_per_cell_batch(cell);
+      const VectorizedArray<number> p_c_scale = cell_data->compaction_pressure_scaling_table(cell,0);
+
+      const bool use_viscosity_at_quadrature_points
+        = (cell_data->viscosity.size(1) == pressure.n_q_points);
+
+      pressure.evaluate (EvaluationFlags::values | EvaluationFlags::gradients);
+
+      for (const unsigned int q : pressure.quadrature_point_indices())
+        {
+          const VectorizedArray<number> viscosity
+            = cell_data->viscosity(cell, use_viscosity_at_quadrature_points ? q : 0);
+
+          // Divide each entry manually, see local_apply().
+          VectorizedArray<number> one_over_viscosity = VectorizedArray<number>();
+          for (unsigned int c=0; c<n_components_filled; ++c)
+            one_over_viscosity[c] = pressure_scaling_squared/viscosity[c];
+
+          const Tensor<1,2,VectorizedArray<number>> value = pressure.get_value(q);
+          const Tensor<1,2,Tensor<1,dim,VectorizedArray<number>>> gradient = pressure.get_gradient(q);
+
+          Tensor<1,2,VectorizedArray<number>> value_term;
+          value_term[0] = one_over_viscosity * (value[0] + p_c_scale * value[1]);
+          value_term[1] = p_c_scale * one_over_viscosity * value[0]
+                          + p_c_scale * p_c_scale
+                          * (one_over_viscosity
+                             + pressure_scaling_squared * cell_data->inverse_compaction_viscosity_table(cell,q))
+                          * value[1];
+
+          Tensor<1,2,Tensor<1,dim,VectorizedArray<number>>> gradient_term;
+          gradient_term[0] = pressure_scaling_squared * cell_data->darcy_coefficient_table(cell,q) * gradient[0];
+
+          pressure.submit_value (value_term, q);
+          pressure.submit_gradient (gradient_term, q);
+        }
+
+      pressure.integrate (EvaluationFlags::values | EvaluationFlags::gradients);
+    };
+
+    MatrixFreeTools::compute_matrix<dim,degree_p,degree_p+2,2,number,VectorizedArray<number>>
+    (*this->get_matrix_free(), constraints, matrix, cell_operation, /*dofh*/1);
+
+    matrix.compress (VectorOperation::add);
+  }
+
+
+
+  template <int dim, int degree_p, typename number>
+  void
+  MatrixFreeStokesOperators::MassMatrixOperator<dim,degree_p,number>
+  ::local_apply_inverse_block_diagonal (const dealii::MatrixFree<dim, number>                    &data,
+                                        dealii::LinearAlgebra::distributed::Vector<number>       &dst,
+                                        const dealii::LinearAlgebra::distributed::Vector<number> &src,
+                                        const std::pair<unsigned int, unsigned int>              &cell_range) const
+  {
+    FEEvaluation<dim,degree_p,degree_p+2,1,number> pressure (data, 1);
+    const unsigned int dofs_per_cell = pressure.dofs_per_cell;
+
+    AlignedVector<VectorizedArray<number>> src_values (dofs_per_cell);
+
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        pressure.reinit (cell);
+        pressure.read_dof_values (src);
+
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          src_values[i] = pressure.begin_dof_values()[i];
+
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          {
+            VectorizedArray<number> sum = VectorizedArray<number>();
+            for (unsigned int j=0; j<dofs_per_cell; ++j)
+              sum += inverse_cell_matrices[(cell*dofs_per_cell+i)*dofs_per_cell+j] * src_values[j];
+            pressure.begin_dof_values()[i] = sum;
+          }
+
+        // Each degree of freedom of a discontinuous element belongs to
+        // exactly one cell, so we can simply set the values.
+        pressure.set_dof_values (dst);
+      }
+  }
+
+
+
   /**
    * Velocity block operator
    */
@@ -824,6 +1554,16 @@ namespace aspect
     const unsigned int cell = velocity.get_current_cell_index();
     VectorizedArray<number> viscosity_x_2 = 2.0*cell_data->viscosity(cell, 0);
 
+    // Compute the sums over all quadrature points that appear in the
+    // Newton derivative terms once per cell batch. The A block does not
+    // contain the derivatives with respect to the pressure.
+    const NewtonCellSums<dim,number> newton_sums =
+      (cell_data->enable_newton_derivatives
+       ?
+       compute_newton_cell_sums<dim,degree_v,number>(*cell_data, cell, velocity, nullptr)
+       :
+       NewtonCellSums<dim,number>());
+
     for (const unsigned int q : velocity.quadrature_point_indices())
       {
         // Only update the viscosity if a Q1 projection is used.
@@ -841,6 +1581,10 @@ namespace aspect
               sym_grad_u[d][d] -= 1.0/3.0*div;
           }
 
+        // Add the Newton derivatives if required.
+        if (cell_data->enable_newton_derivatives)
+          add_newton_velocity_terms(*cell_data, cell, q, newton_sums, sym_grad_u);
+
         velocity.submit_symmetric_gradient(sym_grad_u, q);
       }
   }
@@ -969,14 +1713,14 @@ namespace aspect
   template <int dim>
   void StokesMatrixFreeHandler<dim>::declare_parameters(ParameterHandler &prm)
   {
-    StokesMatrixFreeHandlerImplementation<dim,2>::declare_parameters(prm);
+    StokesMatrixFreeHandlerImplementation<dim,2,double>::declare_parameters(prm);
   }
 
 
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   void
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::declare_parameters(ParameterHandler &prm)
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::declare_parameters(ParameterHandler &prm)
   {
     prm.enter_subsection ("Solver parameters");
     prm.enter_subsection ("Matrix Free");
@@ -990,6 +1734,19 @@ namespace aspect
                          "This is for internal benchmarking purposes: It is useful if you want to see how the solver "
                          "performs. Otherwise, you don't want to enable this, since it adds additional computational cost "
                          "to get the timing information.");
+      prm.declare_entry ("Multigrid number type", "double",
+                         Patterns::Selection("double|float"),
+                         "The floating point type used for the operators, smoothers and "
+                         "transfer operators on the levels of the geometric multigrid "
+                         "preconditioner. The outer Krylov solver and the operators on the "
+                         "active mesh always use double precision. Since the multigrid "
+                         "V-cycle is only used as a preconditioner, it can be applied in "
+                         "single precision ('float'), which halves the amount of memory "
+                         "that needs to be loaded in the smoother sweeps and doubles the "
+                         "number of cells processed per vectorized instruction, typically "
+                         "without affecting the number of outer iterations. Use the "
+                         "``Execute solver timings'' parameter to compare both choices for "
+                         "a given model.");
     }
     prm.leave_subsection ();
     prm.leave_subsection ();
@@ -998,8 +1755,8 @@ namespace aspect
 
 
 
-  template <int dim, int velocity_degree>
-  void StokesMatrixFreeHandlerImplementation<dim,velocity_degree>::parse_parameters(ParameterHandler &prm)
+  template <int dim, int velocity_degree, typename MGNumberType>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::parse_parameters(ParameterHandler &prm)
   {
     prm.enter_subsection ("Solver parameters");
     prm.enter_subsection ("Matrix Free");
@@ -1013,8 +1770,8 @@ namespace aspect
 
 
 
-  template <int dim, int velocity_degree>
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::StokesMatrixFreeHandlerImplementation (Simulator<dim> &simulator,
+  template <int dim, int velocity_degree, typename MGNumberType>
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::StokesMatrixFreeHandlerImplementation (Simulator<dim> &simulator,
       ParameterHandler &prm)
     : sim(simulator),
 
@@ -1023,12 +1780,26 @@ namespace aspect
       dof_handler_projection(simulator.triangulation),
 
       fe_v (FE_Q<dim>(sim.parameters.stokes_velocity_degree), dim),
-      fe_p (FE_Q<dim>(sim.parameters.stokes_velocity_degree-1),1),
+      // Use the same pressure element as the Simulator, i.e., FE_Q for the
+      // default and FE_DGP for the locally conservative discretization. In
+      // models with melt transport, the pressure DoFHandler contains the
+      // fluid pressure and the compaction pressure, which share a block
+      // in the Simulator.
+      fe_p (sim.parameters.include_melt_transport
+            ?
+            std::vector<const FiniteElement<dim>*> {&sim.finite_element.base_element(sim.introspection.variable("fluid pressure").base_index),
+                                                    &sim.finite_element.base_element(sim.introspection.variable("compaction pressure").base_index)
+                                                   }
+            :
+            std::vector<const FiniteElement<dim>*> {&sim.finite_element.base_element(sim.introspection.variable("pressure").base_index)},
+            std::vector<unsigned int> (sim.parameters.include_melt_transport ? 2 : 1, 1)),
 
       // The finite element used to describe the viscosity on the active level
       // and to project the viscosity to GMG levels needs to be DGQ1 if we are
       // using a degree 1 representation of viscosity, and DGQ0 if we are using
-      // a cellwise constant average.
+      // a cellwise constant average. Without averaging, the active level uses
+      // the viscosity at the quadrature points and DGQ1 is only used for the
+      // transfer to the GMG levels.
       fe_projection(FE_DGQ<dim>(sim.parameters.material_averaging
                                 ==
                                 MaterialModel::MaterialAveraging::AveragingOperation::project_to_Q1
@@ -1036,31 +1807,37 @@ namespace aspect
                                 sim.parameters.material_averaging
                                 ==
                                 MaterialModel::MaterialAveraging::AveragingOperation::project_to_Q1_only_viscosity
+                                ||
+                                sim.parameters.material_averaging
+                                ==
+                                MaterialModel::MaterialAveraging::AveragingOperation::none
                                 ? 1 : 0), 1)
   {
     parse_parameters(prm);
     CitationInfo::add("mf");
 
-    // Sorry, not any time soon:
-    AssertThrow(!sim.parameters.include_melt_transport, ExcNotImplemented());
-    // Not very difficult to do, but will require a different mass matrix
-    // operator:
-    AssertThrow(!sim.parameters.use_locally_conservative_discretization, ExcNotImplemented());
-
     // sanity check:
     Assert(sim.introspection.variable("velocity").block_index==0, ExcNotImplemented());
-    Assert(sim.introspection.variable("pressure").block_index==1, ExcNotImplemented());
+    Assert(sim.parameters.include_melt_transport
+           || sim.introspection.variable("pressure").block_index==1, ExcNotImplemented());
+    Assert(!sim.parameters.include_melt_transport
+           || (sim.introspection.variable("fluid pressure").block_index==1
+               && sim.introspection.variable("compaction pressure").block_index==1), ExcNotImplemented());
 
-    // We currently only support averaging of the viscosity to a constant or Q1:
+    // We currently only support averaging of the viscosity to a constant or Q1,
+    // or no averaging at all, in which case the viscosity is used at the
+    // quadrature points of the active level:
     using avg = MaterialModel::MaterialAveraging::AveragingOperation;
-    AssertThrow((sim.parameters.material_averaging &
+    AssertThrow(sim.parameters.material_averaging == avg::none
+                ||
+                (sim.parameters.material_averaging &
                  (avg::arithmetic_average | avg::harmonic_average | avg::geometric_average
                   | avg::pick_largest | avg::project_to_Q1 | avg::log_average
                   | avg::harmonic_average_only_viscosity | avg::geometric_average_only_viscosity
                   | avg::project_to_Q1_only_viscosity)) != 0,
-                ExcMessage("The matrix-free Stokes solver currently only works if material model averaging "
-                           "is enabled. If no averaging is desired, consider using ``project to Q1 only "
-                           "viscosity''."));
+                ExcMessage("The matrix-free Stokes solver currently only works without material model "
+                           "averaging or with one of the averaging operations that average to a "
+                           "constant or project to Q1."));
 
     // Currently cannot solve compressible flow with implicit reference density
     if (sim.material_model->is_compressible() == true)
@@ -1071,8 +1848,8 @@ namespace aspect
 
 
 
-  template <int dim, int velocity_degree>
-  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::assemble ()
+  template <int dim, int velocity_degree, typename MGNumberType>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::assemble ()
   {
     if (sim.mesh_deformation)
       {
@@ -1082,6 +1859,8 @@ namespace aspect
         // different mappings per level.
         for (auto &obj : matrix_free_objects)
           obj->update_mapping(*obj->get_mapping_info().mapping);
+        for (auto &obj : level_matrix_free_objects)
+          obj->update_mapping(*obj->get_mapping_info().mapping);
       }
 
     evaluate_material_model();
@@ -1091,8 +1870,8 @@ namespace aspect
 
 
 
-  template <int dim, int velocity_degree>
-  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::evaluate_material_model ()
+  template <int dim, int velocity_degree, typename MGNumberType>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::evaluate_material_model ()
   {
     dealii::LinearAlgebra::distributed::Vector<double> active_viscosity_vector(dof_handler_projection.locally_owned_dofs(),
                                                                                sim.triangulation.get_communicator());
@@ -1102,173 +1881,315 @@ namespace aspect
     double minimum_viscosity_local = std::numeric_limits<double>::max();
     double maximum_viscosity_local = std::numeric_limits<double>::lowest();
 
-    // Fill the DGQ0 or DGQ1 vector of viscosity values on the active mesh
+    const unsigned int n_q_points = quadrature_formula.size();
+    const bool use_dgq0_projection = (dof_handler_projection.get_fe().degree == 0);
+    Assert(dof_handler_projection.get_fe().degree <= 1, ExcInternalError());
+
+    // Without averaging, the active level operators use the viscosity
+    // evaluated at each quadrature point and the DGQ1 projection is only
+    // used to transfer the viscosity to the multigrid levels.
+    const bool use_quadrature_point_viscosity
+      = (sim.parameters.material_averaging == MaterialModel::MaterialAveraging::none);
+    Assert(!use_quadrature_point_viscosity || !use_dgq0_projection, ExcInternalError());
+
+    // Evaluate the material model on all active cells and fill both the DGQ0
+    // or DGQ1 vector of viscosity values (needed for the transfer to the
+    // multigrid levels below) and the active mesh viscosity table. One value
+    // per cell is required for DGQ0 projection and n_q_points values per cell
+    // for DGQ1 and for the quadrature point viscosity.
+    //
+    // Since the material model evaluation is typically the most expensive
+    // part of this function, we do this in parallel using WorkStream. We loop
+    // over the cells in the order in which the MatrixFree object stores them,
+    // so that the worker can directly compute the entries of the
+    // Table<2,VectorizedArray> used by the active level operators.
     {
-      FEValues<dim> fe_values (*sim.mapping,
-                               sim.finite_element,
-                               quadrature_formula,
-                               update_values   |
-                               update_gradients |
-                               update_quadrature_points |
-                               update_JxW_values);
-
-      MaterialModel::MaterialModelInputs<dim> in(fe_values.n_quadrature_points, sim.introspection.n_compositional_fields);
-      in.requested_properties = MaterialModel::MaterialProperties::viscosity;
-      MaterialModel::MaterialModelOutputs<dim> out(fe_values.n_quadrature_points, sim.introspection.n_compositional_fields);
-
-      // This function call computes a cellwise projection of data defined at quadrature points to
-      // a vector defined by the projection DoFHandler. As an input, we must define a lambda which returns
-      // a viscosity value for each quadrature point of the given cell. The projection is then stored in
-      // the active level viscosity vector provided.
-      Utilities::project_cellwise<dim, dealii::LinearAlgebra::distributed::Vector<double>>(*(sim.mapping),
-          dof_handler_projection,
-          0,
-          quadrature_formula,
-          [&](const typename DoFHandler<dim>::active_cell_iterator & cell,
-              const std::vector<Point<dim>> & /*q_points*/,
-              std::vector<double> &values) -> void
+      const unsigned int n_cells = stokes_matrix.get_matrix_free()->n_cell_batches();
+
+      if (use_dgq0_projection)
+        active_cell_data.viscosity.reinit(TableIndices<2>(n_cells, 1));
+      else
+        active_cell_data.viscosity.reinit(TableIndices<2>(n_cells, n_q_points));
+
+      // Models with melt transport need the coefficients of the additional
+      // terms at each quadrature point. Unused lanes of the tables remain
+      // zero.
+      active_cell_data.include_melt_transport = sim.parameters.include_melt_transport;
+      if (sim.parameters.include_melt_transport)
+        {
+          active_cell_data.darcy_coefficient_table.reinit(TableIndices<2>(n_cells, n_q_points));
+          active_cell_data.inverse_compaction_viscosity_table.reinit(TableIndices<2>(n_cells, n_q_points));
+          active_cell_data.compaction_pressure_scaling_table.reinit(TableIndices<2>(n_cells, 1));
+          if (sim.material_model->is_compressible())
+            active_cell_data.fluid_density_gradient_table.reinit(TableIndices<2>(n_cells, n_q_points));
+          else
+            active_cell_data.fluid_density_gradient_table.reinit(TableIndices<2>(0, 0));
+        }
+
+      std::vector<std::pair<unsigned int, unsigned int>> cell_batches_and_lanes;
+      cell_batches_and_lanes.reserve(sim.triangulation.n_locally_owned_active_cells());
+      for (unsigned int cell=0; cell<n_cells; ++cell)
+        {
+          const unsigned int n_components_filled = stokes_matrix.get_matrix_free()->n_active_entries_per_cell_batch(cell);
+          for (unsigned int i=0; i<n_components_filled; ++i)
+            cell_batches_and_lanes.emplace_back(cell, i);
+        }
+
+      using CellBatchIterator = std::vector<std::pair<unsigned int, unsigned int>>::const_iterator;
+
+      auto worker = [&](const CellBatchIterator &cell_batch_and_lane,
+                        internal::MaterialModelEvaluation::Scratch<dim> &scratch,
+                        internal::MaterialModelEvaluation::CopyData<dim> &data)
       {
-        typename DoFHandler<dim>::active_cell_iterator FEQ_cell(&sim.triangulation,
-        cell->level(),
-        cell->index(),
-        &(sim.dof_handler));
+        data.cell_batch = cell_batch_and_lane->first;
+        data.lane = cell_batch_and_lane->second;
+
+        const typename DoFHandler<dim>::active_cell_iterator matrix_free_cell =
+          stokes_matrix.get_matrix_free()->get_cell_iterator(data.cell_batch, data.lane);
+        const typename DoFHandler<dim>::active_cell_iterator FEQ_cell(&sim.triangulation,
+                                                                      matrix_free_cell->level(),
+                                                                      matrix_free_cell->index(),
+                                                                      &(sim.dof_handler));
+        const typename DoFHandler<dim>::active_cell_iterator DG_cell(&sim.triangulation,
+                                                                     matrix_free_cell->level(),
+                                                                     matrix_free_cell->index(),
+                                                                     &dof_handler_projection);
+
+#ifdef DEBUG
+        {
+          // Verify that all MatrixFree objects iterate over cells in the same way:
+          typename DoFHandler<dim>::active_cell_iterator s_cell =
+            Schur_complement_block_matrix.get_matrix_free()->get_cell_iterator(data.cell_batch,data.lane,1);
+          double distance_s = s_cell->center().distance(matrix_free_cell->center());
+          Assert(distance_s < 1e-10, ExcInternalError());
+
+          typename DoFHandler<dim>::active_cell_iterator A_cell =
+            A_block_matrix.get_matrix_free()->get_cell_iterator(data.cell_batch,data.lane);
+          double distance_A = A_cell->center().distance(matrix_free_cell->center());
+          Assert(distance_A < 1e-10, ExcInternalError());
+        }
+#endif
+
+        MaterialModel::MaterialModelInputs<dim> &in = scratch.material_model_inputs;
+        MaterialModel::MaterialModelOutputs<dim> &out = scratch.material_model_outputs;
+
+        scratch.fe_values.reinit (FEQ_cell);
+        in.reinit(scratch.fe_values, FEQ_cell, sim.introspection, sim.current_linearization_point);
 
-        fe_values.reinit (FEQ_cell);
-        in.reinit(fe_values, FEQ_cell, sim.introspection, sim.current_linearization_point);
+        // The additional outputs can not be copied with the scratch object,
+        // so we create them here the first time they are needed.
+        if (sim.parameters.include_melt_transport)
+          MeltHandler<dim>::create_material_model_outputs(out);
 
         // Query the material model for the active level viscosities
-        sim.material_model->fill_additional_material_model_inputs(in, sim.current_linearization_point, fe_values, sim.introspection);
+        sim.material_model->fill_additional_material_model_inputs(in, sim.current_linearization_point, scratch.fe_values, sim.introspection);
         sim.material_model->evaluate(in, out);
 
         // If using a cellwise average for viscosity, average the values here.
         // When the projection is computed, this will set the viscosity exactly
         // to this averaged value.
-        if (dof_handler_projection.get_fe().degree == 0)
+        if (use_dgq0_projection)
           MaterialModel::MaterialAveraging::average (sim.parameters.material_averaging,
-          FEQ_cell,
-          quadrature_formula,
-          *sim.mapping,
-          in.requested_properties,
-          out);
-
-        for (unsigned int i=0; i<values.size(); ++i)
+                                                     FEQ_cell,
+                                                     quadrature_formula,
+                                                     *sim.mapping,
+                                                     in.requested_properties,
+                                                     out);
+
+        // Store the coefficients of the melt transport terms in the same
+        // way as the assemblers in melt.cc compute them.
+        if (sim.parameters.include_melt_transport)
           {
-            // Find the local max/min of the evaluated viscosities.
-            minimum_viscosity_local = std::min(minimum_viscosity_local, out.viscosities[i]);
-            maximum_viscosity_local = std::max(maximum_viscosity_local, out.viscosities[i]);
-
-            values[i] = out.viscosities[i];
-          }
-        return;
-      },
-      active_viscosity_vector);
-
-      active_viscosity_vector.compress(VectorOperation::insert);
-    }
+            const MaterialModel::MeltOutputs<dim> *melt_outputs
+              = out.template get_additional_output<MaterialModel::MeltOutputs<dim>>();
+            Assert(melt_outputs != nullptr, ExcInternalError());
 
-    minimum_viscosity = dealii::Utilities::MPI::min(minimum_viscosity_local, sim.triangulation.get_communicator());
-    maximum_viscosity = dealii::Utilities::MPI::max(maximum_viscosity_local, sim.triangulation.get_communicator());
+            data.p_c_scale = Plugins::get_plugin_as_type<const MaterialModel::MeltInterface<dim>>(*sim.material_model)
+                             .p_c_scale(in, out, *sim.melt_handler, true);
 
-    FEValues<dim> fe_values_projection (*(sim.mapping),
-                                        fe_projection,
-                                        quadrature_formula,
-                                        update_values);
+            for (unsigned int q=0; q<n_q_points; ++q)
+              {
+                data.darcy_coefficients[q]
+                  = sim.melt_handler->limited_darcy_coefficient(melt_outputs->permeabilities[q] / melt_outputs->fluid_viscosities[q],
+                                                                data.p_c_scale > 0);
+                data.compaction_viscosities[q] = melt_outputs->compaction_viscosities[q];
+                if (sim.material_model->is_compressible())
+                  data.fluid_density_gradients[q] = data.darcy_coefficients[q] / melt_outputs->fluid_densities[q]
+                                                    * melt_outputs->fluid_density_gradients[q];
+              }
+          }
 
-    // Create active mesh viscosity table.
-    {
+        // Find the local max/min of the evaluated viscosities.
+        data.minimum_viscosity = std::numeric_limits<double>::max();
+        data.maximum_viscosity = std::numeric_limits<double>::lowest();
+        for (unsigned int q=0; q<n_q_points; ++q)
+          {
+            data.minimum_viscosity = std::min(data.minimum_viscosity, out.viscosities[q]);
+            data.maximum_viscosity = std::max(data.maximum_viscosity, out.viscosities[q]);
+          }
 
-      const unsigned int n_cells = stokes_matrix.get_matrix_free()->n_cell_batches();
+        // Compute the cellwise L2 projection of the viscosity (in the same
+        // way as Utilities::project_cellwise() does) by creating a local
+        // mass matrix and right hand side and inverting the mass matrix.
+        FEValues<dim> &fe_values_projection = scratch.fe_values_projection;
+        fe_values_projection.reinit(DG_cell);
+        DG_cell->get_dof_indices(data.local_dof_indices);
+
+        const unsigned int dofs_per_cell = fe_values_projection.dofs_per_cell;
+        scratch.local_mass_matrix = 0;
+        scratch.local_rhs = 0;
+        for (unsigned int q=0; q<n_q_points; ++q)
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            {
+              scratch.local_rhs(i) += out.viscosities[q] *
+                                      fe_values_projection.shape_value(i,q) *
+                                      fe_values_projection.JxW(q);
+
+              for (unsigned int j=0; j<dofs_per_cell; ++j)
+                scratch.local_mass_matrix(j,i) += fe_values_projection.shape_value(i,q) *
+                                                  fe_values_projection.shape_value(j,q) *
+                                                  fe_values_projection.JxW(q);
+            }
 
-      const unsigned int n_q_points = quadrature_formula.size();
+        scratch.local_mass_matrix.gauss_jordan();
+        scratch.local_mass_matrix.vmult(data.local_projection, scratch.local_rhs);
+
+        // For DGQ0, we simply use the viscosity at the single
+        // support point of the element. For DGQ1, we evaluate the
+        // projection at the quadrature points. Without averaging, we keep
+        // the values computed by the material model.
+        if (use_dgq0_projection)
+          data.values_on_quad[0] = data.local_projection(0);
+        else if (use_quadrature_point_viscosity)
+          for (unsigned int q=0; q<n_q_points; ++q)
+            data.values_on_quad[q] = out.viscosities[q];
+        else
+          for (unsigned int q=0; q<n_q_points; ++q)
+            {
+              data.values_on_quad[q] = 0.;
+              for (unsigned int i=0; i<dofs_per_cell; ++i)
+                data.values_on_quad[q] += data.local_projection(i) * fe_values_projection.shape_value(i,q);
+            }
+      };
 
-      std::vector<double> values_on_quad;
+      auto copier = [&](const internal::MaterialModelEvaluation::CopyData<dim> &data)
+      {
+        for (unsigned int i=0; i<data.local_dof_indices.size(); ++i)
+          active_viscosity_vector(data.local_dof_indices[i]) = data.local_projection(i);
 
-      // One value per cell is required for DGQ0 projection and n_q_points
-      // values per cell for DGQ1.
-      if (dof_handler_projection.get_fe().degree == 0)
-        active_cell_data.viscosity.reinit(TableIndices<2>(n_cells, 1));
-      else if (dof_handler_projection.get_fe().degree == 1)
-        {
-          values_on_quad.resize(n_q_points);
-          active_cell_data.viscosity.reinit(TableIndices<2>(n_cells, n_q_points));
-        }
-      else
-        Assert(false, ExcInternalError());
+        if (use_dgq0_projection)
+          active_cell_data.viscosity(data.cell_batch, 0)[data.lane] = data.values_on_quad[0];
+        else
+          for (unsigned int q=0; q<n_q_points; ++q)
+            active_cell_data.viscosity(data.cell_batch, q)[data.lane] = data.values_on_quad[q];
 
-      std::vector<types::global_dof_index> local_dof_indices(fe_projection.dofs_per_cell);
-      for (unsigned int cell=0; cell<n_cells; ++cell)
-        {
-          const unsigned int n_components_filled = stokes_matrix.get_matrix_free()->n_active_entries_per_cell_batch(cell);
+        minimum_viscosity_local = std::min(minimum_viscosity_local, data.minimum_viscosity);
+        maximum_viscosity_local = std::max(maximum_viscosity_local, data.maximum_viscosity);
 
-          for (unsigned int i=0; i<n_components_filled; ++i)
-            {
-              typename DoFHandler<dim>::active_cell_iterator FEQ_cell =
-                stokes_matrix.get_matrix_free()->get_cell_iterator(cell,i);
-              typename DoFHandler<dim>::active_cell_iterator DG_cell(&(sim.triangulation),
-                                                                     FEQ_cell->level(),
-                                                                     FEQ_cell->index(),
-                                                                     &dof_handler_projection);
-              DG_cell->get_active_or_mg_dof_indices(local_dof_indices);
+        if (sim.parameters.include_melt_transport)
+          {
+            active_cell_data.compaction_pressure_scaling_table(data.cell_batch, 0)[data.lane] = data.p_c_scale;
 
-#ifdef DEBUG
+            for (unsigned int q=0; q<n_q_points; ++q)
               {
-                // Verify that all MatrixFree objects iterate over cells in the same way:
-                typename DoFHandler<dim>::active_cell_iterator s_cell =
-                  Schur_complement_block_matrix.get_matrix_free()->get_cell_iterator(cell,i,1);
-                double distance_s = s_cell->center().distance(FEQ_cell->center());
-                Assert(distance_s < 1e-10, ExcInternalError());
-
-                typename DoFHandler<dim>::active_cell_iterator A_cell =
-                  A_block_matrix.get_matrix_free()->get_cell_iterator(cell,i);
-                double distance_A = A_cell->center().distance(FEQ_cell->center());
-                Assert(distance_A < 1e-10, ExcInternalError());
+                active_cell_data.darcy_coefficient_table(data.cell_batch, q)[data.lane] = data.darcy_coefficients[q];
+                active_cell_data.inverse_compaction_viscosity_table(data.cell_batch, q)[data.lane]
+                  = 1. / data.compaction_viscosities[q];
+
+                if (active_cell_data.fluid_density_gradient_table.size(0) > 0)
+                  for (unsigned int d=0; d<dim; ++d)
+                    active_cell_data.fluid_density_gradient_table(data.cell_batch, q)[d][data.lane]
+                      = data.fluid_density_gradients[q][d];
               }
-#endif
+          }
+      };
+
+      WorkStream::
+      run (cell_batches_and_lanes.cbegin(),
+           cell_batches_and_lanes.cend(),
+           worker,
+           copier,
+           internal::MaterialModelEvaluation::Scratch<dim> (*sim.mapping,
+                                                            sim.finite_element,
+                                                            fe_projection,
+                                                            quadrature_formula,
+                                                            sim.introspection.n_compositional_fields,
+                                                            sim.parameters.include_melt_transport),
+           internal::MaterialModelEvaluation::CopyData<dim> (fe_projection.dofs_per_cell,
+                                                             n_q_points,
+                                                             sim.parameters.include_melt_transport));
 
-              // For DGQ0, we simply use the viscosity at the single
-              // support point of the element. For DGQ1, we must project
-              // back to quadrature point values.
-              if (dof_handler_projection.get_fe().degree == 0)
-                active_cell_data.viscosity(cell, 0)[i] = active_viscosity_vector(local_dof_indices[0]);
-              else
-                {
-                  fe_values_projection.reinit(DG_cell);
-                  fe_values_projection.get_function_values(active_viscosity_vector,
-                                                           local_dof_indices,
-                                                           values_on_quad);
+      active_viscosity_vector.compress(VectorOperation::insert);
 
-                  // Do not allow viscosity to be greater than or less than the limits
-                  // of the evaluated viscosity on the active level.
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    active_cell_data.viscosity(cell, q)[i]
-                      = std::min(std::max(values_on_quad[q], minimum_viscosity), maximum_viscosity);
-                }
+      minimum_viscosity = dealii::Utilities::MPI::min(minimum_viscosity_local, sim.triangulation.get_communicator());
+      maximum_viscosity = dealii::Utilities::MPI::max(maximum_viscosity_local, sim.triangulation.get_communicator());
+
+      // Do not allow viscosity to be greater than or less than the limits
+      // of the evaluated viscosity on the active level. This can only happen
+      // for the DGQ1 projection, and we can only do this after the global
+      // limits are known.
+      if (!use_dgq0_projection && !use_quadrature_point_viscosity)
+        for (const auto &cell_batch_and_lane : cell_batches_and_lanes)
+          for (unsigned int q=0; q<n_q_points; ++q)
+            {
+              double &viscosity = active_cell_data.viscosity(cell_batch_and_lane.first, q)[cell_batch_and_lane.second];
+              viscosity = std::min(std::max(viscosity, minimum_viscosity),
+                                   maximum_viscosity);
             }
-        }
     }
 
-    active_cell_data.is_compressible = sim.material_model->is_compressible();
+    FEValues<dim> fe_values_projection (*(sim.mapping),
+                                        fe_projection,
+                                        quadrature_formula,
+                                        update_values);
+
+    // The formulation with melt transport always contains the compressible
+    // term of the solid velocity in the A block.
+    active_cell_data.is_compressible = sim.material_model->is_compressible()
+                                       || sim.parameters.include_melt_transport;
     active_cell_data.pressure_scaling = sim.pressure_scaling;
 
+    // Find the compaction pressure DoFs that the Simulator constrains to
+    // zero because they do not belong to a melt cell. These constraints
+    // are not part of constraints_p, so that we do not need to rebuild the
+    // MatrixFree objects whenever the melt cells change.
+    active_cell_data.constrained_compaction_pressure_dofs.clear();
+    if (sim.parameters.include_melt_transport)
+      {
+        const Utilities::MPI::Partitioner &partitioner
+          = *stokes_matrix.get_matrix_free()->get_dof_info(1).vector_partitioner;
+        const types::global_dof_index n_velocity_dofs = dof_handler_v.n_dofs();
+
+        for (const types::global_dof_index index : dof_handler_p.locally_owned_dofs())
+          if (sim.current_constraints.is_constrained(n_velocity_dofs + index)
+              &&
+              !constraints_p.is_constrained(index))
+            active_cell_data.constrained_compaction_pressure_dofs.push_back(partitioner.global_to_local(index));
+      }
+
     // Store viscosity tables and other data into the active level matrix-free objects.
     stokes_matrix.set_cell_data(active_cell_data);
 
     if (sim.parameters.n_expensive_stokes_solver_steps > 0)
-      {
-        A_block_matrix.set_cell_data(active_cell_data);
-        Schur_complement_block_matrix.set_cell_data(active_cell_data);
-      }
+      A_block_matrix.set_cell_data(active_cell_data);
+
+    // The Schur complement operator on the active level is also needed if
+    // it is not preconditioned with GMG
+    if (sim.parameters.n_expensive_stokes_solver_steps > 0
+        ||
+        !schur_complement_uses_gmg())
+      Schur_complement_block_matrix.set_cell_data(active_cell_data);
 
     const unsigned int n_levels = sim.triangulation.n_global_levels();
     level_cell_data.resize(0,n_levels-1);
 
-    MGLevelObject<dealii::LinearAlgebra::distributed::Vector<GMGNumberType>> level_viscosity_vector;
+    MGLevelObject<dealii::LinearAlgebra::distributed::Vector<MGNumberType>> level_viscosity_vector;
     level_viscosity_vector.resize(0,n_levels-1);
 
     // Project the active level viscosity vector to multilevel vector representations
     // using MG transfer objects. This transfer is based on the same linear operator used to
     // transfer data inside a v-cycle.
-    MGTransferMF<dim,GMGNumberType> transfer;
+    MGTransferMF<dim,MGNumberType> transfer;
 
     transfer.build(dof_handler_projection);
 
@@ -1278,15 +2199,15 @@ namespace aspect
 
     for (unsigned int level=0; level<n_levels; ++level)
       {
-        level_cell_data[level].is_compressible = sim.material_model->is_compressible();
+        level_cell_data[level].is_compressible = sim.material_model->is_compressible()
+                                                 || sim.parameters.include_melt_transport;
         level_cell_data[level].pressure_scaling = sim.pressure_scaling;
+        level_cell_data[level].include_melt_transport = false;
 
         // Create viscosity tables on each level.
         const unsigned int n_cells = mg_matrices_A_block[level].get_matrix_free()->n_cell_batches();
 
-        const unsigned int n_q_points = quadrature_formula.size();
-
-        std::vector<GMGNumberType> values_on_quad;
+        std::vector<MGNumberType> values_on_quad;
 
         // One value per cell is required for DGQ0 projection and n_q_points
         // values per cell for DGQ1.
@@ -1329,8 +2250,8 @@ namespace aspect
                     // of the evaluated viscosity on the active level.
                     for (unsigned int q=0; q<n_q_points; ++q)
                       level_cell_data[level].viscosity(cell,q)[i]
-                        = std::min(std::max(values_on_quad[q], static_cast<GMGNumberType>(minimum_viscosity)),
-                                   static_cast<GMGNumberType>(maximum_viscosity));
+                        = std::min(std::max(values_on_quad[q], static_cast<MGNumberType>(minimum_viscosity)),
+                                   static_cast<MGNumberType>(maximum_viscosity));
                   }
               }
           }
@@ -1372,7 +2293,6 @@ namespace aspect
             out.additional_outputs.push_back(std::make_unique<MaterialModel::ElasticOutputs<dim>>(out.n_evaluation_points()));
 
           const unsigned int n_cells = stokes_matrix.get_matrix_free()->n_cell_batches();
-          const unsigned int n_q_points = quadrature_formula.size();
 
           active_cell_data.strain_rate_table.reinit(TableIndices<2>(n_cells, n_q_points));
           active_cell_data.newton_factor_wrt_pressure_table.reinit(TableIndices<2>(n_cells, n_q_points));
@@ -1581,13 +2501,13 @@ namespace aspect
 
 
 
-  template <int dim, int velocity_degree>
-  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::correct_stokes_rhs()
+  template <int dim, int velocity_degree, typename MGNumberType>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::correct_stokes_rhs()
   {
     // We never include Newton terms in step 0 and after that we solve with zero boundary conditions.
     // Therefore, we don't need to include Newton terms here.
 
-    const bool is_compressible = sim.material_model->is_compressible();
+    const bool is_compressible = active_cell_data.is_compressible;
 
     dealii::LinearAlgebra::distributed::BlockVector<double> rhs_correction(2);
     dealii::LinearAlgebra::distributed::BlockVector<double> u0(2);
@@ -1618,6 +2538,15 @@ namespace aspect
     FEEvaluation<dim,velocity_degree-1,velocity_degree+1,1,double>
     pressure (*stokes_matrix.get_matrix_free(), 1);
 
+    // In models with melt transport, the evaluator above describes the
+    // fluid pressure, and we also need to test with the compaction pressure.
+    // The constraints on both pressures are homogeneous, so only the terms
+    // that are applied to the velocity contribute to the correction.
+    std::unique_ptr<FEEvaluation<dim,velocity_degree-1,velocity_degree+1,1,double>> compaction_pressure;
+    if (active_cell_data.include_melt_transport)
+      compaction_pressure = std::make_unique<FEEvaluation<dim,velocity_degree-1,velocity_degree+1,1,double>>
+                            (*stokes_matrix.get_matrix_free(), 1, 0, 1);
+
     const bool use_viscosity_at_quadrature_points
       = (active_cell_data.viscosity.size(1) == velocity.n_q_points);
 
@@ -1640,6 +2569,9 @@ namespace aspect
         pressure.read_dof_values_plain (u0.block(1));
         pressure.evaluate (EvaluationFlags::values);
 
+        if (compaction_pressure)
+          compaction_pressure->reinit (cell);
+
         for (const unsigned int q : velocity.quadrature_point_indices())
           {
             // Only update the viscosity if a Q1 projection is used.
@@ -1652,6 +2584,11 @@ namespace aspect
             const VectorizedArray<double> div = trace(sym_grad_u);
             pressure.submit_value(sim.pressure_scaling*div, q);
 
+            if (compaction_pressure)
+              compaction_pressure->submit_value(sim.pressure_scaling
+                                                * active_cell_data.compaction_pressure_scaling_table(cell, 0)
+                                                * div, q);
+
             sym_grad_u *= viscosity_x_2;
 
             for (unsigned int d=0; d<dim; ++d)
@@ -1670,6 +2607,10 @@ namespace aspect
 
         pressure.integrate_scatter (EvaluationFlags::values,
                                     rhs_correction.block(1));
+
+        if (compaction_pressure)
+          compaction_pressure->integrate_scatter (EvaluationFlags::values,
+                                                  rhs_correction.block(1));
       }
 
     if (active_cell_data.apply_stabilization_free_surface_faces)
@@ -1717,14 +2658,14 @@ namespace aspect
 
 
 
-  template <int dim, int velocity_degree>
-  std::pair<double,double> StokesMatrixFreeHandlerImplementation<dim,velocity_degree>::solve()
+  template <int dim, int velocity_degree, typename MGNumberType>
+  std::pair<double,double> StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::solve()
   {
     double initial_nonlinear_residual = numbers::signaling_nan<double>();
     double final_linear_residual      = numbers::signaling_nan<double>();
 
     // Below we define all the objects needed to build the GMG preconditioner:
-    using VectorType = dealii::LinearAlgebra::distributed::Vector<GMGNumberType>;
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<MGNumberType>;
 
     // ABlock GMG Smoother: Chebyshev, degree 4. Parameter values were chosen
     // by trial and error. We use a more powerful version of the smoother on the
@@ -1779,7 +2720,8 @@ namespace aspect
             }
           smoother_data_Schur[level].preconditioner = mg_matrices_Schur_complement[level].get_matrix_diagonal_inverse();
         }
-      mg_smoother_Schur.initialize(mg_matrices_Schur_complement, smoother_data_Schur);
+      if (schur_complement_uses_gmg())
+        mg_smoother_Schur.initialize(mg_matrices_Schur_complement, smoother_data_Schur);
     }
 
     // Estimate the eigenvalues for the Chebyshev smoothers.
@@ -1792,17 +2734,22 @@ namespace aspect
     for (unsigned int level = 0; level<sim.triangulation.n_global_levels(); ++level)
       {
         VectorType temp_velocity;
-        VectorType temp_pressure;
         mg_matrices_A_block[level].initialize_dof_vector(temp_velocity);
-        mg_matrices_Schur_complement[level].initialize_dof_vector(temp_pressure);
-
         mg_smoother_A[level].estimate_eigenvalues(temp_velocity);
-        mg_smoother_Schur[level].estimate_eigenvalues(temp_pressure);
 
         if (level==0)
+          coarse_A_size = temp_velocity.size();
+
+        // The Schur complement of a discontinuous pressure or of a model
+        // with melt transport is not preconditioned with GMG, see below
+        if (schur_complement_uses_gmg())
           {
-            coarse_A_size = temp_velocity.size();
-            coarse_S_size = temp_pressure.size();
+            VectorType temp_pressure;
+            mg_matrices_Schur_complement[level].initialize_dof_vector(temp_pressure);
+            mg_smoother_Schur[level].estimate_eigenvalues(temp_pressure);
+
+            if (level==0)
+              coarse_S_size = temp_pressure.size();
           }
       }
 
@@ -1821,7 +2768,10 @@ namespace aspect
     if (print_details)
       {
         sim.pcout << std::endl
-                  << "    GMG coarse size A: " << coarse_A_size << ", coarse size S: " << coarse_S_size << std::endl
+                  << "    GMG coarse size A: " << coarse_A_size;
+        if (schur_complement_uses_gmg())
+          sim.pcout << ", coarse size S: " << coarse_S_size;
+        sim.pcout << std::endl
                   << "    GMG n_levels: " << sim.triangulation.n_global_levels() << std::endl
                   << "    Viscosity range: " << minimum_viscosity << " - " << maximum_viscosity << std::endl;
 
@@ -1867,10 +2817,28 @@ namespace aspect
     mg_Schur.set_edge_matrices(mg_interface_Schur, mg_interface_Schur);
 
     // GMG Preconditioner for ABlock and Schur complement
-    using GMGPreconditioner = PreconditionMG<dim, VectorType, MGTransferMF<dim,GMGNumberType>>;
+    using GMGPreconditioner = PreconditionMG<dim, VectorType, MGTransferMF<dim,MGNumberType>>;
     GMGPreconditioner prec_A(dof_handler_v, mg_A, mg_transfer_A_block);
     GMGPreconditioner prec_Schur(dof_handler_p, mg_Schur, mg_transfer_Schur_complement);
 
+    // For a discontinuous pressure, use the exact inverse of the block
+    // diagonal Schur complement approximation instead of GMG. In models with
+    // melt transport, the approximation contains a Darcy term, which is
+    // not part of the multigrid hierarchy, and we use the AMG preconditioner
+    // built in build_preconditioner() instead.
+    using SchurPreconditioner = internal::SchurComplementPreconditioner<GMGPreconditioner, SchurComplementMatrixType, LinearAlgebra::PreconditionAMG>;
+    const SchurPreconditioner schur_preconditioner ((schur_complement_uses_gmg()
+                                                     ?
+                                                     &prec_Schur
+                                                     :
+                                                     nullptr),
+                                                    (sim.parameters.include_melt_transport
+                                                     ?
+                                                     &melt_Schur_complement_preconditioner
+                                                     :
+                                                     nullptr),
+                                                    Schur_complement_block_matrix);
+
 
     // Many parts of the solver depend on the block layout (velocity = 0,
     // pressure = 1). For example the linearized_stokes_initial_guess vector or the StokesBlock matrix
@@ -2020,23 +2988,32 @@ namespace aspect
     solver_control_cheap.enable_history_data();
     solver_control_expensive.enable_history_data();
 
+    // The A block operator contains the Newton derivatives if they are
+    // enabled, in which case it is only symmetric if the Newton system is
+    // symmetrized.
+    const bool A_block_is_symmetric = sim.stokes_A_block_is_symmetric()
+                                      &&
+                                      (active_cell_data.enable_newton_derivatives == false
+                                       ||
+                                       active_cell_data.symmetrize_newton_system);
+
     // create a cheap preconditioner that consists of only a single V-cycle
-    const internal::BlockSchurGMGPreconditioner<StokesMatrixType, ABlockMatrixType, SchurComplementMatrixType, GMGPreconditioner, GMGPreconditioner>
+    const internal::BlockSchurGMGPreconditioner<StokesMatrixType, ABlockMatrixType, SchurComplementMatrixType, GMGPreconditioner, SchurPreconditioner>
     preconditioner_cheap (stokes_matrix, A_block_matrix, Schur_complement_block_matrix,
-                          prec_A, prec_Schur,
+                          prec_A, schur_preconditioner,
                           /*do_solve_A*/false,
                           /*do_solve_Schur*/false,
-                          sim.stokes_A_block_is_symmetric(),
+                          A_block_is_symmetric,
                           sim.parameters.linear_solver_A_block_tolerance,
                           sim.parameters.linear_solver_S_block_tolerance);
 
     // create an expensive preconditioner that solves for the A block with CG
-    const internal::BlockSchurGMGPreconditioner<StokesMatrixType, ABlockMatrixType, SchurComplementMatrixType, GMGPreconditioner, GMGPreconditioner>
+    const internal::BlockSchurGMGPreconditioner<StokesMatrixType, ABlockMatrixType, SchurComplementMatrixType, GMGPreconditioner, SchurPreconditioner>
     preconditioner_expensive (stokes_matrix, A_block_matrix, Schur_complement_block_matrix,
-                              prec_A, prec_Schur,
+                              prec_A, schur_preconditioner,
                               /*do_solve_A*/true,
                               /*do_solve_Schur*/true,
-                              sim.stokes_A_block_is_symmetric(),
+                              A_block_is_symmetric,
                               sim.parameters.linear_solver_A_block_tolerance,
                               sim.parameters.linear_solver_S_block_tolerance);
 
@@ -2050,6 +3027,10 @@ namespace aspect
         const int n_timings = 10;
         Timer timer(sim.mpi_communicator);
 
+        sim.pcout << "Timing the Stokes solver with multigrid levels in "
+                  << (std::is_same<MGNumberType,float>::value ? "single" : "double")
+                  << " precision:" << std::endl;
+
         auto time_this = [&](const char *name, int repeats, const std::function<void()> &body, const std::function<void()> &prepare)
         {
           sim.pcout << "Timing " << name << ' ' << n_timings << " time(s) and repeat "
@@ -2095,6 +3076,28 @@ namespace aspect
                    );
         }
 
+        // stokes vmult without the Newton derivatives, to compare the cost
+        // of applying the Newton operator to that of the Picard operator
+        if (active_cell_data.enable_newton_derivatives)
+          {
+            active_cell_data.enable_newton_derivatives = false;
+
+            dealii::LinearAlgebra::distributed::BlockVector<double> tmp_dst = solution_copy;
+            dealii::LinearAlgebra::distributed::BlockVector<double> tmp_src = rhs_copy;
+            time_this("stokes_vmult_without_newton_derivatives", 10,
+                      [&] ()
+            {
+              stokes_matrix.vmult(tmp_dst, tmp_src);
+            },
+            [&] ()
+            {
+              tmp_src = tmp_dst;
+            }
+                     );
+
+            active_cell_data.enable_newton_derivatives = true;
+          }
+
         // stokes preconditioner
         {
           dealii::LinearAlgebra::distributed::BlockVector<double> tmp_dst = solution_copy;
@@ -2125,6 +3128,40 @@ namespace aspect
           }
                    );
         }
+        // A and S operators on the finest multigrid level, which are
+        // applied in the multigrid number type
+        {
+          const unsigned int finest_level = sim.triangulation.n_global_levels()-1;
+
+          VectorType tmp_dst, tmp_src;
+          mg_matrices_A_block[finest_level].initialize_dof_vector(tmp_dst);
+          mg_matrices_A_block[finest_level].initialize_dof_vector(tmp_src);
+          tmp_src = 1.;
+          time_this("A_level_vmult", 10,
+                    [&] ()
+          {
+            mg_matrices_A_block[finest_level].vmult(tmp_dst, tmp_src);
+          },
+          [&] ()
+          {
+            tmp_src = 1.;
+          }
+                   );
+
+          mg_matrices_Schur_complement[finest_level].initialize_dof_vector(tmp_dst);
+          mg_matrices_Schur_complement[finest_level].initialize_dof_vector(tmp_src);
+          tmp_src = 1.;
+          time_this("S_level_vmult", 10,
+                    [&] ()
+          {
+            mg_matrices_Schur_complement[finest_level].vmult(tmp_dst, tmp_src);
+          },
+          [&] ()
+          {
+            tmp_src = 1.;
+          }
+                   );
+        }
         // S preconditioner
         {
           dealii::LinearAlgebra::distributed::BlockVector<double> tmp_dst = solution_copy;
@@ -2132,7 +3169,7 @@ namespace aspect
           time_this("S_preconditioner", 5,
                     [&] ()
           {
-            prec_Schur.vmult(tmp_dst.block(1), tmp_src.block(1));
+            schur_preconditioner.vmult(tmp_dst.block(1), tmp_src.block(1));
           },
           [&] ()
           {
@@ -2356,8 +3393,6 @@ namespace aspect
 
 
     // convert melt pressures
-    // TODO: We assert in the StokesMatrixFreeHandler constructor that we
-    //       are not including melt transport.
     if (sim.parameters.include_melt_transport)
       sim.melt_handler->compute_melt_variables(sim.system_matrix,sim.solution,sim.system_rhs);
 
@@ -2368,34 +3403,12 @@ namespace aspect
 
 
 
-  template <int dim, int velocity_degree>
-  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::setup_dofs()
+  template <int dim, int velocity_degree, typename MGNumberType>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::setup_dofs()
   {
-    // Periodic boundary conditions with hanging nodes on the boundary currently
-    // cause the GMG not to converge. We catch this case early to provide the
-    // user with a reasonable error message:
-    {
-      bool have_periodic_hanging_nodes = false;
-      for (const auto &cell : sim.triangulation.active_cell_iterators())
-        if (cell->is_locally_owned())
-          for (const auto f : cell->face_indices())
-            {
-              if (cell->has_periodic_neighbor(f))
-                {
-                  const auto &neighbor = cell->periodic_neighbor(f);
-                  // This way, we can only detect the case where the neighbor is coarser,
-                  // but this is fine as the other owner covers that situation:
-                  if (neighbor->level()<cell->level())
-                    have_periodic_hanging_nodes = true;
-                }
-            }
-
-      have_periodic_hanging_nodes = (dealii::Utilities::MPI::max(have_periodic_hanging_nodes ? 1 : 0, sim.triangulation.get_communicator())) == 1;
-      AssertThrow(have_periodic_hanging_nodes==false, ExcNotImplemented());
-    }
-
-    // This vector will be refilled with the new MatrixFree objects below:
+    // These vectors will be refilled with the new MatrixFree objects below:
     matrix_free_objects.clear();
+    level_matrix_free_objects.clear();
 
     // Velocity DoFHandler
     {
@@ -2535,6 +3548,46 @@ namespace aspect
       mg_constrained_dofs_Schur_complement.initialize(dof_handler_p);
 
       dof_handler_projection.distribute_mg_dofs();
+
+      // MGConstrainedDoFs only detects the refinement edges between
+      // neighboring cells, but not those across periodic faces where the
+      // periodic neighbor of a level cell is coarser. On the active mesh,
+      // the DoFs on the fine side of such a face are constrained by the
+      // periodicity constraints, so we treat them like homogeneous Dirichlet
+      // DoFs on the levels, the same way local smoothing treats the DoFs
+      // at other refinement edges.
+      const auto add_periodic_refinement_edge_indices
+        = [&](const DoFHandler<dim> &dof_handler,
+              MGConstrainedDoFs &mg_constrained_dofs)
+      {
+        const unsigned int dofs_per_face = dof_handler.get_fe().n_dofs_per_face();
+        if (dofs_per_face == 0 || sim.geometry_model->get_periodic_boundary_pairs().empty())
+          return;
+
+        std::vector<types::global_dof_index> face_dof_indices(dofs_per_face);
+        for (unsigned int level=0; level<sim.triangulation.n_global_levels(); ++level)
+          {
+            IndexSet periodic_refinement_edge_indices(dof_handler.n_dofs(level));
+
+            for (const auto &cell : dof_handler.mg_cell_iterators_on_level(level))
+              if (cell->level_subdomain_id() != numbers::artificial_subdomain_id)
+                for (const auto f : cell->face_indices())
+                  if (cell->has_periodic_neighbor(f)
+                      &&
+                      cell->periodic_neighbor(f)->level() < cell->level())
+                    {
+                      cell->face(f)->get_mg_dof_indices(level, face_dof_indices);
+                      for (const auto index : face_dof_indices)
+                        periodic_refinement_edge_indices.add_index(index);
+                    }
+
+            periodic_refinement_edge_indices.compress();
+            mg_constrained_dofs.add_boundary_indices(dof_handler, level, periodic_refinement_edge_indices);
+          }
+      };
+
+      add_periodic_refinement_edge_indices(dof_handler_v, mg_constrained_dofs_A_block);
+      add_periodic_refinement_edge_indices(dof_handler_p, mg_constrained_dofs_Schur_complement);
     }
 
     // Setup the matrix-free operators
@@ -2611,6 +3664,11 @@ namespace aspect
 #endif
             level_constraints_v.close();
 
+            // Add the periodicity constraints between cells on this level
+            level_constraints_v.merge(mg_constrained_dofs_A_block.get_level_constraints(level),
+                                      AffineConstraints<double>::left_object_wins);
+            level_constraints_v.close();
+
             std::set<types::boundary_id> no_flux_boundary
               = sim.boundary_velocity_manager.get_tangential_boundary_velocity_indicators();
             if (!no_flux_boundary.empty())
@@ -2646,19 +3704,28 @@ namespace aspect
 
 #if DEAL_II_VERSION_GTE(9,6,0)
             level_constraints_p.reinit(dof_handler_p.locally_owned_mg_dofs(level), relevant_dofs);
+            if (mg_constrained_dofs_Schur_complement.have_boundary_indices())
+              for (const auto index : mg_constrained_dofs_Schur_complement.get_boundary_indices(level))
+                level_constraints_p.constrain_dof_to_zero(index);
 #else
             level_constraints_p.reinit(relevant_dofs);
+            if (mg_constrained_dofs_Schur_complement.have_boundary_indices())
+              level_constraints_p.add_lines(mg_constrained_dofs_Schur_complement.get_boundary_indices(level));
 #endif
+            level_constraints_p.close();
 
+            // Add the periodicity constraints between cells on this level
+            level_constraints_p.merge(mg_constrained_dofs_Schur_complement.get_level_constraints(level),
+                                      AffineConstraints<double>::left_object_wins);
             level_constraints_p.close();
           }
 
-          std::shared_ptr<MatrixFree<dim,GMGNumberType>> matrix_free_level = std::make_shared<MatrixFree<dim,GMGNumberType>>();
-          matrix_free_objects.push_back(matrix_free_level);
+          std::shared_ptr<MatrixFree<dim,MGNumberType>> matrix_free_level = std::make_shared<MatrixFree<dim,MGNumberType>>();
+          level_matrix_free_objects.push_back(matrix_free_level);
 
           {
-            typename MatrixFree<dim,GMGNumberType>::AdditionalData additional_data;
-            additional_data.tasks_parallel_scheme = MatrixFree<dim,GMGNumberType>::AdditionalData::none;
+            typename MatrixFree<dim,MGNumberType>::AdditionalData additional_data;
+            additional_data.tasks_parallel_scheme = MatrixFree<dim,MGNumberType>::AdditionalData::none;
             additional_data.mapping_update_flags = (update_gradients | update_JxW_values);
             additional_data.mg_level = level;
 
@@ -2683,98 +3750,189 @@ namespace aspect
         }
     }
 
-    // Build MG transfer
+    // Build MG transfer. The transfer has to know about the constrained
+    // DoFs before it is built, both to skip the boundary and periodic
+    // refinement edge indices and to resolve the periodicity constraints
+    // between cells on the same level.
     mg_transfer_A_block.clear();
     mg_transfer_A_block.initialize_constraints(mg_constrained_dofs_A_block);
     mg_transfer_A_block.build(dof_handler_v);
 
     mg_transfer_Schur_complement.clear();
-    mg_transfer_Schur_complement.initialize_constraints(mg_constrained_dofs_Schur_complement);
-    mg_transfer_Schur_complement.build(dof_handler_p);
+    if (schur_complement_uses_gmg())
+      {
+        mg_transfer_Schur_complement.initialize_constraints(mg_constrained_dofs_Schur_complement);
+        mg_transfer_Schur_complement.build(dof_handler_p);
+      }
   }
 
 
 
-  template <int dim, int velocity_degree>
-  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::build_preconditioner()
+  template <int dim, int velocity_degree, typename MGNumberType>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::build_preconditioner()
   {
     TimerOutput::Scope timer (this->sim.computing_timer, "Build Stokes preconditioner");
 
     for (unsigned int level=0; level < sim.triangulation.n_global_levels(); ++level)
       {
-        mg_matrices_Schur_complement[level].compute_diagonal();
+        if (schur_complement_uses_gmg())
+          mg_matrices_Schur_complement[level].compute_diagonal();
         mg_matrices_A_block[level].compute_diagonal();
       }
+
+    if (sim.parameters.include_melt_transport)
+      {
+        // The Schur complement approximation in models with melt transport
+        // contains the Laplacian of the Darcy coefficient, which is not part
+        // of the multigrid hierarchy. Like the matrix-based solver, we
+        // precondition it with an AMG V-cycle, so we assemble it into a
+        // sparse matrix. The compaction pressure DoFs outside of melt cells
+        // are eliminated from this matrix in the same way as in the
+        // Simulator's preconditioner matrix.
+        IndexSet locally_relevant_dofs;
+        DoFTools::extract_locally_relevant_dofs (dof_handler_p,
+                                                 locally_relevant_dofs);
+
+        AffineConstraints<double> melt_constraints_p;
+        melt_constraints_p.reinit(
+#if DEAL_II_VERSION_GTE(9,6,0)
+          dof_handler_p.locally_owned_dofs(),
+#endif
+          locally_relevant_dofs);
+        melt_constraints_p.merge(constraints_p);
+
+        const types::global_dof_index n_velocity_dofs = dof_handler_v.n_dofs();
+        for (const types::global_dof_index index : locally_relevant_dofs)
+          if (sim.current_constraints.is_constrained(n_velocity_dofs + index)
+              &&
+              !constraints_p.is_constrained(index))
+#if DEAL_II_VERSION_GTE(9,6,0)
+            melt_constraints_p.constrain_dof_to_zero(index);
+#else
+            melt_constraints_p.add_line(index);
+#endif
+        melt_constraints_p.close();
+
+        TrilinosWrappers::SparsityPattern sp (dof_handler_p.locally_owned_dofs(),
+                                              dof_handler_p.locally_owned_dofs(),
+                                              locally_relevant_dofs,
+                                              sim.mpi_communicator);
+        DoFTools::make_sparsity_pattern (dof_handler_p, sp, melt_constraints_p, false,
+                                         Utilities::MPI::this_mpi_process(sim.mpi_communicator));
+        sp.compress();
+
+        melt_Schur_complement_matrix.clear();
+        melt_Schur_complement_matrix.reinit(sp);
+        Schur_complement_block_matrix.compute_melt_matrix(melt_constraints_p, melt_Schur_complement_matrix);
+
+        // Use the same AMG settings as Simulator::build_stokes_preconditioner()
+        // for this block.
+        std::vector<std::vector<bool>> constant_modes;
+        DoFTools::extract_constant_modes (dof_handler_p,
+                                          ComponentMask(fe_p.n_components(), true),
+                                          constant_modes);
+
+        LinearAlgebra::PreconditionAMG::AdditionalData Amg_data;
+        Amg_data.constant_modes = constant_modes;
+        Amg_data.elliptic = true;
+        Amg_data.higher_order_elements = false;
+        Amg_data.smoother_sweeps = 2;
+        Amg_data.coarse_type = "symmetric Gauss-Seidel";
+
+        melt_Schur_complement_preconditioner.initialize(melt_Schur_complement_matrix, Amg_data);
+      }
+    else if (sim.parameters.use_locally_conservative_discretization)
+      Schur_complement_block_matrix.compute_inverse_block_diagonal();
+  }
+
+
+
+  template <int dim, int velocity_degree, typename MGNumberType>
+  bool
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::schur_complement_uses_gmg () const
+  {
+    return !sim.parameters.use_locally_conservative_discretization
+           &&
+           !sim.parameters.include_melt_transport;
   }
 
 
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   const DoFHandler<dim> &
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_dof_handler_v () const
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_dof_handler_v () const
   {
     return dof_handler_v;
   }
 
 
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   const DoFHandler<dim> &
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_dof_handler_p () const
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_dof_handler_p () const
   {
     return dof_handler_p;
   }
 
 
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   const DoFHandler<dim> &
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_dof_handler_projection () const
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_dof_handler_projection () const
   {
     return dof_handler_projection;
   }
 
 
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   const AffineConstraints<double> &
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_constraints_v() const
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_constraints_v() const
   {
     return constraints_v;
   }
 
 
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
   const AffineConstraints<double> &
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_constraints_p() const
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_constraints_p() const
   {
     return constraints_p;
   }
 
 
 
-  template <int dim, int velocity_degree>
-  const MGTransferMF<dim,GMGNumberType> &
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_mg_transfer_A() const
+  template <int dim, int velocity_degree, typename MGNumberType>
+  const MGTransferMF<dim,MGNumberType> &
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_mg_transfer_A() const
   {
     return mg_transfer_A_block;
   }
 
 
 
-  template <int dim, int velocity_degree>
-  const MGTransferMF<dim,GMGNumberType> &
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_mg_transfer_S() const
+  template <int dim, int velocity_degree, typename MGNumberType>
+  const MGTransferMF<dim,MGNumberType> &
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_mg_transfer_S() const
   {
     return mg_transfer_Schur_complement;
   }
 
 
 
-  template <int dim, int velocity_degree>
+  template <int dim, int velocity_degree, typename MGNumberType>
+  std::size_t
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>::get_mg_transfer_memory_consumption() const
+  {
+    return mg_transfer_A_block.memory_consumption() + mg_transfer_Schur_complement.memory_consumption();
+  }
+
+
+
+  template <int dim, int velocity_degree, typename MGNumberType>
   std::size_t
-  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>:: get_cell_data_memory_consumption() const
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree, MGNumberType>:: get_cell_data_memory_consumption() const
   {
     std::size_t total = active_cell_data.memory_consumption();
 
@@ -2789,8 +3947,10 @@ namespace aspect
 // explicit instantiation of the functions we implement in this file
 #define INSTANTIATE(dim) \
   template class StokesMatrixFreeHandler<dim>; \
-  template class StokesMatrixFreeHandlerImplementation<dim,2>; \
-  template class StokesMatrixFreeHandlerImplementation<dim,3>;
+  template class StokesMatrixFreeHandlerImplementation<dim,2,double>; \
+  template class StokesMatrixFreeHandlerImplementation<dim,3,double>; \
+  template class StokesMatrixFreeHandlerImplementation<dim,2,float>; \
+  template class StokesMatrixFreeHandlerImplementation<dim,3,float>;
 
   ASPECT_INSTANTIATE(INSTANTIATE)
 
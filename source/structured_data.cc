@@ -33,8 +33,16 @@
 #include <deal.II/base/exceptions.h>
 
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <regex>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #ifdef ASPECT_WITH_NETCDF
 
 #include <netcdf.h>
@@ -278,56 +286,27 @@ namespace aspect
                ExcMessage("Error: One of the data tables has an incorrect size."));
 
 
-      // For each data component, set up a GridData,
-      // its type depending on the read-in grid.
-      data.resize(n_components);
-      for (unsigned int c = 0; c < n_components; ++c)
+      // Take over the data tables and, if the coordinates are equidistant,
+      // precompute the grid spacing so that we can find the grid cell
+      // of a given position without searching through the coordinates.
+      for (unsigned int d=0; d<dim; ++d)
         {
-          if (coordinate_values_are_equidistant)
-            {
-              std::array<unsigned int,dim> table_intervals;
-              for (unsigned int d=0; d<dim; ++d)
-                table_intervals[d] = table_points[d]-1;
-
-              // The min and max of the coordinates in the data file.
-              std::array<std::pair<double,double>,dim> grid_extent;
-              for (unsigned int d=0; d<dim; ++d)
-                {
-                  grid_extent[d].first = coordinate_values[d][0];
-                  grid_extent[d].second = coordinate_values[d][table_points[d]-1];
-
-                  Assert(table_intervals[d] >= 1,
-                         ExcMessage("There needs to be at least one subinterval in each "
-                                    "coordinate direction."));
-                  Assert(grid_extent[d].first <
-                         grid_extent[d].second,
-                         ExcMessage("The interval in each coordinate direction needs "
-                                    "to have positive size"));
-                }
-
-              data[c]
-                = std::make_unique<Functions::InterpolatedUniformGridData<dim>> (std::move(grid_extent),
-                                                                                  std::move(table_intervals),
-                                                                                  std::move(data_table[c]));
-            }
-          else
-            // Create the object and move the big objects. Due to an old design flaw,
-            // the current class stores a copy of the 'coordinate_values' and some
-            // plugins actually use it too, i.e., we can't move the data out of
-            // this object. In another design flaw, the deal.II classes
-            // do not make the coordinate values accessible, so we have to continue
-            // storing a copy. In other words, we can't just move stuff --
-            // we have to make a copy of 'coordinate_values' and then move
-            // that copy.
-            //
-            // (The call to std::move on the first argument is unnecessary: We
-            // create a temporary object, and that's an rvalue that the constructor
-            // we call would bind to. But never a bad idea to be explicit.)
-            data[c]
-              = std::make_unique<Functions::InterpolatedTensorProductGridData<dim>>
-                (std::move(std::array<std::vector<double>,dim>(this->coordinate_values)),
-                 std::move(data_table[c]));
+          Assert(table_points[d] >= 2,
+                 ExcMessage("There needs to be at least one subinterval in each "
+                            "coordinate direction."));
+          Assert(coordinate_values[d][0] < coordinate_values[d][table_points[d]-1],
+                 ExcMessage("The interval in each coordinate direction needs "
+                            "to have positive size"));
+
+          grid_spacing[d] = (coordinate_values_are_equidistant
+                             ?
+                             (coordinate_values[d][table_points[d]-1] - coordinate_values[d][0])
+                             / (table_points[d]-1)
+                             :
+                             numbers::signaling_nan<double>());
         }
+
+      data = std::move(data_table);
     }
 
 
@@ -590,6 +569,149 @@ namespace aspect
 
 
 
+    template <int dim>
+    void
+    StructuredDataLookup<dim>::load_binary(const std::string &filename,
+                                           const MPI_Comm comm)
+    {
+      const unsigned int root_process = 0;
+
+      std::vector<std::string> column_names;
+      std::vector<Table<dim,double>> data_tables;
+      std::vector<std::vector<double>> coordinate_values(dim);
+
+      // Only the root process reads the file. The data tables are then
+      // shared with all other processes on the same machine in reinit().
+      if (Utilities::MPI::this_mpi_process(comm) == root_process)
+        {
+          const int file_descriptor = open(filename.c_str(), O_RDONLY);
+          AssertThrow(file_descriptor != -1,
+                      ExcMessage("Could not open the binary data file <" + filename + ">."));
+
+          struct stat file_status;
+          AssertThrow(fstat(file_descriptor, &file_status) == 0,
+                      ExcMessage("Could not determine the size of the binary data file <" + filename + ">."));
+          const std::size_t file_size = file_status.st_size;
+
+          // Map the file into memory instead of reading it, so that only
+          // the pages we actually touch need to be loaded from disk, and
+          // the data can be copied straight into the data tables.
+          void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+          close(file_descriptor);
+          AssertThrow(mapping != MAP_FAILED,
+                      ExcMessage("Could not map the binary data file <" + filename + "> into memory."));
+
+          const char *file_content = static_cast<const char *>(mapping);
+          std::size_t offset = 0;
+          const auto read_bytes = [&](void *destination, const std::size_t n_bytes)
+          {
+            AssertThrow(offset + n_bytes <= file_size,
+                        ExcMessage("The binary data file <" + filename + "> ended unexpectedly."));
+            std::memcpy(destination, file_content + offset, n_bytes);
+            offset += n_bytes;
+          };
+
+          // Read and check the header
+          char magic[8];
+          read_bytes(magic, sizeof(magic));
+          AssertThrow(std::string(magic, sizeof(magic)) == "ASPECTSD",
+                      ExcMessage("The file <" + filename + "> is not a binary ASPECT data file."));
+
+          std::uint32_t header[3];
+          read_bytes(header, sizeof(header));
+          AssertThrow(header[0] == 1,
+                      ExcMessage("The binary data file <" + filename + "> has an unsupported format "
+                                 "version or was written with a different byte order."));
+          AssertThrow(header[1] == dim,
+                      ExcMessage("The binary data file <" + filename + "> contains data with "
+                                 + Utilities::int_to_string(header[1]) + " coordinate dimensions, but "
+                                 + Utilities::int_to_string(dim) + " were expected."));
+
+          if (n_components == numbers::invalid_unsigned_int)
+            n_components = header[2];
+          else
+            AssertThrow(n_components == header[2],
+                        ExcMessage("The number of expected data columns and the number of "
+                                   "data columns in the binary data file " + filename + " do not match."));
+
+          TableIndices<dim> new_table_points;
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              std::uint32_t n_points;
+              read_bytes(&n_points, sizeof(n_points));
+              AssertThrow(this->table_points[d] == 0 || this->table_points[d] == n_points,
+                          ExcMessage("The file grid must not change over model runtime. "
+                                     "Check the number of points in the data file " + filename + "."));
+              new_table_points[d] = n_points;
+            }
+
+          for (unsigned int c=0; c<n_components; ++c)
+            {
+              std::uint32_t name_length;
+              read_bytes(&name_length, sizeof(name_length));
+              std::string name(name_length, ' ');
+              read_bytes(&name[0], name_length);
+              column_names.push_back(name);
+            }
+
+          // The header is padded to a multiple of 8 bytes, so the
+          // coordinates and data that follow are properly aligned.
+          offset = (offset + 7) / 8 * 8;
+
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              coordinate_values[d].resize(new_table_points[d]);
+              read_bytes(coordinate_values[d].data(), new_table_points[d] * sizeof(double));
+            }
+
+          // The data of each component is stored in the same order as in
+          // ascii data files, i.e., with the first coordinate ascending
+          // first. This corresponds to Fortran-style indexing of the tables.
+          Table<dim,double> data_table;
+          data_table.TableBase<dim,double>::reinit(new_table_points);
+          const std::size_t n_points = data_table.n_elements();
+
+          AssertThrow(file_size - offset == n_components * n_points * sizeof(double),
+                      ExcMessage("The size of the binary data file <" + filename + "> does not "
+                                 "match the number of points and data columns given in its header."));
+
+          const double *values = reinterpret_cast<const double *>(file_content + offset);
+          data_tables.resize(n_components, data_table);
+          for (unsigned int c=0; c<n_components; ++c)
+            {
+              data_tables[c].fill(values + c * n_points, false);
+
+              if (scale_factor != 1.)
+                for (std::size_t i=0; i<n_points; ++i)
+                  data_tables[c](compute_table_indices(new_table_points, i)) *= scale_factor;
+            }
+
+          munmap(mapping, file_size);
+        }
+
+      // Broadcast the small objects to all processes, as in load_ascii().
+      n_components = Utilities::MPI::broadcast (comm,
+                                                n_components,
+                                                root_process);
+      coordinate_values = Utilities::MPI::broadcast (comm,
+                                                     coordinate_values,
+                                                     root_process);
+      column_names = Utilities::MPI::broadcast (comm,
+                                                column_names,
+                                                root_process);
+
+      if (Utilities::MPI::this_mpi_process(comm) != root_process)
+        data_tables.resize (n_components);
+
+      this->reinit(column_names,
+                   std::move(coordinate_values),
+                   std::move(data_tables),
+                   comm,
+                   root_process);
+    }
+
+
+
     template <int dim>
     void
     StructuredDataLookup<dim>::load_netcdf(const std::string &filename, const std::vector<std::string> &data_column_names_)
@@ -846,27 +968,184 @@ namespace aspect
                                          const MPI_Comm communicator)
     {
       const bool is_netcdf_filename = std::regex_search(filename, std::regex("\\.(nc|NC)$"));
+      const bool is_binary_filename = std::regex_search(filename, std::regex("\\.(bin|BIN)$"));
       if (is_netcdf_filename)
         load_netcdf(filename);
+      else if (is_binary_filename)
+        load_binary(filename, communicator);
       else
         load_ascii(filename, communicator);
     }
 
+    template <int dim>
+    void
+    StructuredDataLookup<dim>::compute_interpolation_position(const Point<dim> &position,
+                                                              TableIndices<dim> &ix,
+                                                              Point<dim> &unit_position) const
+    {
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          const std::vector<double> &coordinates = coordinate_values[d];
+          const unsigned int n_subintervals = table_points[d] - 1;
+
+          if (position[d] <= coordinates[0])
+            ix[d] = 0;
+          else if (coordinate_values_are_equidistant)
+            {
+              if (position[d] >= coordinates[n_subintervals] - grid_spacing[d])
+                ix[d] = n_subintervals - 1;
+              else
+                ix[d] = static_cast<unsigned int>((position[d] - coordinates[0]) / grid_spacing[d]);
+            }
+          else
+            {
+              if (position[d] >= coordinates[n_subintervals])
+                ix[d] = n_subintervals - 1;
+              else
+                ix[d] = std::upper_bound(coordinates.begin(), coordinates.end(), position[d])
+                        - coordinates.begin() - 1;
+            }
+
+          const double dx = (coordinate_values_are_equidistant
+                             ?
+                             grid_spacing[d]
+                             :
+                             coordinates[ix[d]+1] - coordinates[ix[d]]);
+          const double x0 = (coordinate_values_are_equidistant
+                             ?
+                             coordinates[0] + ix[d] * grid_spacing[d]
+                             :
+                             coordinates[ix[d]]);
+
+          unit_position[d] = std::max(std::min((position[d] - x0) / dx, 1.), 0.);
+        }
+    }
+
+
+
+    template <int dim>
+    double
+    StructuredDataLookup<dim>::interpolate(const Table<dim,double> &table,
+                                           const TableIndices<dim> &ix,
+                                           const Point<dim> &unit_position) const
+    {
+      // Multilinear interpolation: sum over the 2^dim corners of the
+      // grid cell, each weighted by the product of the 1d linear
+      // shape functions.
+      double value = 0.;
+      for (unsigned int corner=0; corner<(1u<<dim); ++corner)
+        {
+          TableIndices<dim> corner_index = ix;
+          double weight = 1.;
+          for (unsigned int d=0; d<dim; ++d)
+            if (corner & (1u<<d))
+              {
+                ++corner_index[d];
+                weight *= unit_position[d];
+              }
+            else
+              weight *= 1. - unit_position[d];
+
+          value += weight * table(corner_index);
+        }
+
+      return value;
+    }
+
+
+
     template <int dim>
     double
     StructuredDataLookup<dim>::get_data(const Point<dim> &position,
                                         const unsigned int component) const
     {
       Assert(component<n_components, ExcMessage("Invalid component index"));
-      return data[component]->value(position);
+
+      TableIndices<dim> ix;
+      Point<dim> unit_position;
+      compute_interpolation_position(position, ix, unit_position);
+
+      return interpolate(data[component], ix, unit_position);
     }
 
+
+
+    template <int dim>
+    void
+    StructuredDataLookup<dim>::get_data(const Point<dim>                   &position,
+                                        const std::vector<unsigned int>    &components,
+                                        std::vector<double>                &data_values) const
+    {
+      TableIndices<dim> ix;
+      Point<dim> unit_position;
+      compute_interpolation_position(position, ix, unit_position);
+
+      data_values.resize(components.size());
+      for (unsigned int c=0; c<components.size(); ++c)
+        {
+          Assert(components[c]<n_components, ExcMessage("Invalid component index"));
+          data_values[c] = interpolate(data[components[c]], ix, unit_position);
+        }
+    }
+
+
+
+    template <int dim>
+    void
+    StructuredDataLookup<dim>::get_data(const std::vector<Point<dim>>      &positions,
+                                        const std::vector<unsigned int>    &components,
+                                        std::vector<std::vector<double>>   &data_values) const
+    {
+      data_values.resize(positions.size());
+      for (unsigned int q=0; q<positions.size(); ++q)
+        get_data(positions[q], components, data_values[q]);
+    }
+
+
+
     template <int dim>
     Tensor<1,dim>
     StructuredDataLookup<dim>::get_gradients(const Point<dim> &position,
                                              const unsigned int component)
     {
-      return data[component]->gradient(position,0);
+      Assert(component<n_components, ExcMessage("Invalid component index"));
+
+      TableIndices<dim> ix;
+      Point<dim> unit_position;
+      compute_interpolation_position(position, ix, unit_position);
+
+      // Differentiate the multilinear interpolant with respect to each
+      // coordinate direction, and transform from the unit cell to the
+      // actual grid cell.
+      Tensor<1,dim> gradient;
+      for (unsigned int corner=0; corner<(1u<<dim); ++corner)
+        {
+          TableIndices<dim> corner_index = ix;
+          for (unsigned int d=0; d<dim; ++d)
+            if (corner & (1u<<d))
+              ++corner_index[d];
+
+          const double corner_value = data[component](corner_index);
+
+          for (unsigned int k=0; k<dim; ++k)
+            {
+              double weight = (corner & (1u<<k)) ? 1. : -1.;
+              for (unsigned int d=0; d<dim; ++d)
+                if (d != k)
+                  weight *= (corner & (1u<<d)) ? unit_position[d] : 1. - unit_position[d];
+
+              gradient[k] += weight * corner_value;
+            }
+        }
+
+      for (unsigned int d=0; d<dim; ++d)
+        gradient[d] /= (coordinate_values_are_equidistant
+                        ?
+                        grid_spacing[d]
+                        :
+                        coordinate_values[d][ix[d]+1] - coordinate_values[d][ix[d]]);
+
+      return gradient;
     }
 
 
@@ -1390,6 +1669,33 @@ namespace aspect
     }
 
 
+
+    template <int dim>
+    void
+    AsciiDataBoundary<dim>::
+    get_data_components (const types::boundary_id             boundary_indicator,
+                         const Point<dim>                    &position,
+                         const std::vector<unsigned int>     &components,
+                         std::vector<double>                 &data_values) const
+    {
+      const Point<dim> data_coordinates = data_coordinates_from_position(position, this->get_geometry_model());
+      const Point<dim-1> boundary_coordinates = boundary_coordinates_from_data_coordinates(data_coordinates, boundary_indicator);
+
+      Assert (lookups.find(boundary_indicator) != lookups.end(),
+              ExcInternalError());
+      lookups.find(boundary_indicator)->second->get_data(boundary_coordinates, components, data_values);
+
+      if (!time_dependent)
+        return;
+
+      std::vector<double> old_data_values;
+      old_lookups.find(boundary_indicator)->second->get_data(boundary_coordinates, components, old_data_values);
+
+      for (unsigned int c=0; c<components.size(); ++c)
+        data_values[c] = time_weight * data_values[c] + (1 - time_weight) * old_data_values[c];
+    }
+
+
     template <int dim>
     Tensor<1,dim-1>
     AsciiDataBoundary<dim>::vector_gradient (const types::boundary_id             boundary_indicator,
@@ -1755,6 +2061,33 @@ namespace aspect
 
 
 
+    template <int dim>
+    void
+    AsciiDataInitial<dim>::
+    get_data_components (const Point<dim> &position,
+                         const std::vector<unsigned int> &components,
+                         std::vector<double> &data_values) const
+    {
+      if (slice_data == true)
+        {
+          const Tensor<1,3> position_tensor({position[0], position[1], 0.0});
+          const Point<3> rotated_position (rotation_matrix * position_tensor);
+
+          const std::array<double,3> spherical_position =
+            Utilities::Coordinates::cartesian_to_spherical_coordinates(rotated_position);
+
+          slice_lookup->get_data(Point<3>(Tensor<1,3>(ArrayView<const double>(spherical_position))),
+                                 components, data_values);
+          return;
+        }
+
+      const Point<dim> data_coordinates = data_coordinates_from_position(position, this->get_geometry_model());
+
+      lookup->get_data(data_coordinates, components, data_values);
+    }
+
+
+
     template <int dim>
     void
     AsciiDataInitial<dim>::declare_parameters (ParameterHandler  &prm,
@@ -39,7 +39,9 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/signaling_nan.h>
 #include <deal.II/base/patterns.h>
+#include <deal.II/fe/fe.h>
 #include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
 
 #include <cerrno>
 #include <dirent.h>
@@ -47,6 +49,7 @@
 #include <string>
 #include <sys/stat.h>
 #include <iostream>
+#include <map>
 #include <regex>
 
 #include <boost/math/special_functions/spherical_harmonic.hpp>
@@ -754,6 +757,197 @@ namespace aspect
 
 
 
+
+    template <int dim>
+    PointValueEvaluator<dim>::PointValueEvaluator ()
+      :
+      n_points (0),
+      mpi_communicator (MPI_COMM_SELF),
+      initialized (false)
+    {}
+
+
+
+    template <int dim>
+    void
+    PointValueEvaluator<dim>::reinit (const std::vector<Point<dim>> &points,
+                                      const Mapping<dim> &mapping,
+                                      const DoFHandler<dim> &dof_handler,
+                                      const MPI_Comm mpi_communicator)
+    {
+      clear();
+
+      n_points = points.size();
+      this->mpi_communicator = mpi_communicator;
+
+      const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+      const Triangulation<dim> &triangulation = dof_handler.get_triangulation();
+
+      // the cache builds a tree of the vertices and cells of the mesh
+      // once, which makes the search for every single point cheap
+      const GridTools::Cache<dim> cache (triangulation, mapping);
+
+      // find out which process owns a cell around every point. a point
+      // on a cell boundary may be claimed by several processes, in which
+      // case the one with the smallest rank is responsible for it
+      std::vector<unsigned int> claiming_process (n_points, numbers::invalid_unsigned_int);
+      std::vector<std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim>>>
+      cells_and_reference_points (n_points);
+
+      typename Triangulation<dim>::active_cell_iterator hint = triangulation.begin_active();
+      for (unsigned int p=0; p<n_points; ++p)
+        {
+          cells_and_reference_points[p] = GridTools::find_active_cell_around_point (cache, points[p], hint);
+
+          const typename Triangulation<dim>::active_cell_iterator &cell = cells_and_reference_points[p].first;
+          if (cell.state() != IteratorState::valid)
+            continue;
+
+          // a point on the boundary of the locally owned part of the mesh
+          // may have been found in a ghost cell, even though it also lies
+          // in one of our own cells. look through all cells around the
+          // point in that case, because otherwise none of the processes
+          // that share the point might claim it
+          if (!cell->is_locally_owned())
+            {
+              const auto all_cells_and_reference_points
+                = GridTools::find_all_active_cells_around_point (mapping,
+                                                                 triangulation,
+                                                                 points[p],
+                                                                 1e-10,
+                                                                 cells_and_reference_points[p]);
+              for (const auto &cell_and_reference_point : all_cells_and_reference_points)
+                if (cell_and_reference_point.first->is_locally_owned())
+                  {
+                    cells_and_reference_points[p] = cell_and_reference_point;
+                    break;
+                  }
+            }
+
+          if (cells_and_reference_points[p].first->is_locally_owned())
+            {
+              claiming_process[p] = my_rank;
+
+              // neighboring points are often located in the same cell
+              hint = cells_and_reference_points[p].first;
+            }
+        }
+
+      std::vector<unsigned int> owning_process (n_points);
+      Utilities::MPI::min (claiming_process, mpi_communicator, owning_process);
+
+      std::map<typename Triangulation<dim>::active_cell_iterator, unsigned int> cell_point_index;
+      for (unsigned int p=0; p<n_points; ++p)
+        {
+          AssertThrow (owning_process[p] != numbers::invalid_unsigned_int,
+                       ExcMessage ("While trying to evaluate the solution at point " +
+                                   Utilities::to_string(points[p][0]) + ", " +
+                                   Utilities::to_string(points[p][1]) +
+                                   (dim == 3
+                                    ?
+                                    ", " + Utilities::to_string(points[p][2])
+                                    :
+                                    "") + "), " +
+                                   "no processors reported that the point lies inside the " +
+                                   "set of cells they own. Are you trying to evaluate the " +
+                                   "solution at a point that lies outside of the domain?"));
+
+          if (owning_process[p] != my_rank)
+            continue;
+
+          const typename Triangulation<dim>::active_cell_iterator &cell = cells_and_reference_points[p].first;
+          const auto inserted = cell_point_index.emplace (cell, cell_points.size());
+          if (inserted.second)
+            {
+              CellPoints new_cell_points;
+              new_cell_points.cell = typename DoFHandler<dim>::active_cell_iterator (&triangulation,
+                                                                                      cell->level(),
+                                                                                      cell->index(),
+                                                                                      &dof_handler);
+              cell_points.push_back (new_cell_points);
+            }
+
+          CellPoints &points_in_cell = cell_points[inserted.first->second];
+          points_in_cell.reference_points.push_back (cells_and_reference_points[p].second);
+          points_in_cell.point_indices.push_back (p);
+        }
+
+      initialized = true;
+    }
+
+
+
+    template <int dim>
+    void
+    PointValueEvaluator<dim>::clear ()
+    {
+      cell_points.clear();
+      n_points = 0;
+      initialized = false;
+    }
+
+
+
+    template <int dim>
+    bool
+    PointValueEvaluator<dim>::is_initialized () const
+    {
+      return initialized;
+    }
+
+
+
+    template <int dim>
+    void
+    PointValueEvaluator<dim>::evaluate (const LinearAlgebra::BlockVector &solution,
+                                        std::vector<Vector<double>> &values) const
+    {
+      Assert (initialized,
+              ExcMessage ("The points need to be located with reinit() before "
+                          "the solution can be evaluated at them."));
+
+      unsigned int n_components = 0;
+      if (cell_points.size() > 0)
+        n_components = cell_points.front().cell->get_fe().n_components();
+      n_components = Utilities::MPI::max (n_components, mpi_communicator);
+
+      // collect the values of the points this process is responsible for
+      // in one vector, with zeros for all other points, and then add up
+      // the contributions of all processes
+      std::vector<double> local_values (n_points * n_components, 0.);
+      Vector<double> cell_dof_values;
+
+      for (const CellPoints &points_in_cell : cell_points)
+        {
+          const FiniteElement<dim> &fe = points_in_cell.cell->get_fe();
+          Assert (fe.is_primitive(), ExcNotImplemented());
+
+          cell_dof_values.reinit (fe.dofs_per_cell);
+          points_in_cell.cell->get_dof_values (solution, cell_dof_values);
+
+          for (unsigned int q=0; q<points_in_cell.point_indices.size(); ++q)
+            {
+              double *point_values = &local_values[points_in_cell.point_indices[q] * n_components];
+              for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                point_values[fe.system_to_component_index(i).first]
+                += cell_dof_values[i] * fe.shape_value (i, points_in_cell.reference_points[q]);
+            }
+        }
+
+      std::vector<double> global_values (local_values.size());
+      Utilities::MPI::sum (local_values, mpi_communicator, global_values);
+
+      values.resize (n_points);
+      for (unsigned int p=0; p<n_points; ++p)
+        {
+          values[p].reinit (n_components);
+          for (unsigned int c=0; c<n_components; ++c)
+            values[p][c] = global_values[p * n_components + c];
+        }
+    }
+
+
+
     namespace Coordinates
     {
 
@@ -1352,6 +1546,75 @@ namespace aspect
 
 
 
+    void real_spherical_harmonics (const unsigned int max_degree,
+                                   const double theta,
+                                   const double phi,
+                                   std::vector<double> &cos_components,
+                                   std::vector<double> &sin_components)
+    {
+      const unsigned int n_coefficients = (max_degree+1)*(max_degree+2)/2;
+      cos_components.resize(n_coefficients);
+      sin_components.resize(n_coefficients);
+
+      const double x = std::cos(theta);
+      const double s = std::sin(theta);
+
+      // First compute the fully normalized associated Legendre functions
+      //   P_lm(x) = sqrt((2l+1)/(4 pi) (l-m)!/(l+m)!) P_l^m(x)
+      // including the Condon-Shortley phase (as boost does) and store
+      // them in cos_components. The sectoral terms P_mm are obtained from
+      // P_(m-1)(m-1), the other terms by the upward recurrence in l.
+      double p_mm = 1./std::sqrt(4.*numbers::PI);
+      for (unsigned int m=0; m<=max_degree; ++m)
+        {
+          if (m > 0)
+            p_mm *= -std::sqrt((2.*m+1.)/(2.*m)) * s;
+
+          cos_components[m*(m+1)/2+m] = p_mm;
+
+          if (m+1 <= max_degree)
+            cos_components[(m+1)*(m+2)/2+m] = std::sqrt(2.*m+3.) * x * p_mm;
+
+          for (unsigned int l=m+2; l<=max_degree; ++l)
+            {
+              const double a_lm = std::sqrt((4.*l*l-1.)/(1.*l*l-1.*m*m));
+              const double b_lm = std::sqrt((1.*(l-1)*(l-1)-1.*m*m)/(4.*(l-1)*(l-1)-1.));
+              cos_components[l*(l+1)/2+m] = a_lm * (x * cos_components[(l-1)*l/2+m]
+                                                    - b_lm * cos_components[(l-2)*(l-1)/2+m]);
+            }
+        }
+
+      // Then multiply by cos(m phi) and sin(m phi), which we compute by the
+      // Chebyshev recurrence, and by the factor sqrt(2) for m>0 that is part
+      // of the definition of the real spherical harmonics.
+      const double cos_phi = std::cos(phi);
+      double cos_m_phi = 1., cos_m_minus_one_phi = cos_phi;
+      double sin_m_phi = 0., sin_m_minus_one_phi = -std::sin(phi);
+      for (unsigned int m=0; m<=max_degree; ++m)
+        {
+          if (m > 0)
+            {
+              const double next_cos = 2. * cos_phi * cos_m_phi - cos_m_minus_one_phi;
+              const double next_sin = 2. * cos_phi * sin_m_phi - sin_m_minus_one_phi;
+              cos_m_minus_one_phi = cos_m_phi;
+              sin_m_minus_one_phi = sin_m_phi;
+              cos_m_phi = next_cos;
+              sin_m_phi = next_sin;
+            }
+
+          const double factor = (m == 0 ? 1. : numbers::SQRT2);
+          for (unsigned int l=m; l<=max_degree; ++l)
+            {
+              const unsigned int index = l*(l+1)/2+m;
+              const double legendre = cos_components[index];
+              cos_components[index] = factor * legendre * cos_m_phi;
+              sin_components[index] = factor * legendre * sin_m_phi;
+            }
+        }
+    }
+
+
+
     bool
     fexists(const std::string &filename)
     {
@@ -3521,6 +3784,9 @@ namespace aspect
                                       const MPI_Comm mpi_communicator); \
   \
   template \
+  class PointValueEvaluator<dim>; \
+  \
+  template \
   double signed_distance_to_polygon<dim>(const std::vector<Point<2>> &pointList, \
                                          const dealii::Point<2> &point); \
   \
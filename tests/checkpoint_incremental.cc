@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/simulator.h>
+#include <iostream>
+
+/*
+ * Print and execute the given command, and terminate if it fails.
+ */
+void execute (const std::string &command)
+{
+  std::cout << "Executing the following command:\n"
+            << command
+            << std::endl;
+  const int ret = system (command.c_str());
+  if (ret!=0)
+    {
+      std::cout << "system() returned error " << ret << std::endl;
+      exit(1);
+    }
+}
+
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * once writing complete and once writing incremental checkpoints, resume
+ * both runs from their last checkpoint, compare the statistics of all four
+ * runs, and then terminate the outer ASPECT run.
+ */
+int f()
+{
+  const std::string incremental = (" echo 'subsection Checkpointing' "
+                                   " ; "
+                                   " echo '  set Incremental checkpoints = true' "
+                                   " ; "
+                                   " echo 'end' ");
+
+  std::cout << "* running with complete checkpoints:" << std::endl;
+  execute ("cd output-checkpoint_incremental ; "
+           "(cat " ASPECT_SOURCE_DIR "/tests/checkpoint_incremental.prm "
+           " ; "
+           " echo 'set Output directory = output1.tmp' "
+           " ; "
+           " rm -rf output1.tmp ; mkdir output1.tmp "
+           ") "
+           "| ../../aspect -- > /dev/null");
+
+  std::cout << "* running with incremental checkpoints:" << std::endl;
+  execute ("cd output-checkpoint_incremental ; "
+           "(cat " ASPECT_SOURCE_DIR "/tests/checkpoint_incremental.prm "
+           " ; "
+           + incremental +
+           " ; "
+           " echo 'set Output directory = output2.tmp' "
+           " ; "
+           " rm -rf output2.tmp ; mkdir output2.tmp "
+           ") "
+           "| ../../aspect -- > /dev/null");
+
+  execute ("cd output-checkpoint_incremental ; "
+           " rm -rf output3.tmp output4.tmp ; mkdir output3.tmp output4.tmp ; "
+           " cp -r output1.tmp/restart* output3.tmp/ ; "
+           " cp -r output2.tmp/restart* output4.tmp/");
+
+  std::cout << "* now resuming from the complete checkpoint:" << std::endl;
+  execute ("cd output-checkpoint_incremental ; "
+           "(cat " ASPECT_SOURCE_DIR "/tests/checkpoint_incremental.prm "
+           " ; "
+           " echo 'set Output directory = output3.tmp' "
+           " ; "
+           " echo 'set Resume computation = true' "
+           ") "
+           "| ../../aspect -- > /dev/null");
+
+  std::cout << "* now resuming from the incremental checkpoint:" << std::endl;
+  execute ("cd output-checkpoint_incremental ; "
+           "(cat " ASPECT_SOURCE_DIR "/tests/checkpoint_incremental.prm "
+           " ; "
+           + incremental +
+           " ; "
+           " echo 'set Output directory = output4.tmp' "
+           " ; "
+           " echo 'set Resume computation = true' "
+           ") "
+           "| ../../aspect -- > /dev/null");
+
+  std::cout << "* now comparing:" << std::endl;
+  execute ("cd output-checkpoint_incremental ; "
+           "test -d output2.tmp/restart.vectors && "
+           "diff output1.tmp/statistics output2.tmp/statistics && "
+           "diff output1.tmp/statistics output3.tmp/statistics && "
+           "diff output1.tmp/statistics output4.tmp/statistics");
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/simulator.h>
+#include <iostream>
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * twice, once assembling the compositional fields one after the other and
+ * once assembling them together, compare the statistics of both runs, and
+ * then terminate the outer ASPECT run.
+ */
+int f()
+{
+  int ret;
+  std::string command;
+
+  std::cout << "* running with separate assembly:" << std::endl;
+  command = ("cd output-composition_assembled_together ; "
+             "(cat " ASPECT_SOURCE_DIR "/tests/composition_assembled_together.prm "
+             " ; "
+             " echo 'set Output directory = output1.tmp' "
+             " ; "
+             " rm -rf output1.tmp ; mkdir output1.tmp "
+             ") "
+             "| ../../aspect -- > /dev/null");
+  std::cout << "Executing the following command:\n"
+            << command
+            << std::endl;
+  ret = system (command.c_str());
+  if (ret!=0)
+    {
+      std::cout << "system() returned error " << ret << std::endl;
+      exit(1);
+    }
+
+  std::cout << "* running with assembly of all fields together:" << std::endl;
+  command = ("cd output-composition_assembled_together ; "
+             "(cat " ASPECT_SOURCE_DIR "/tests/composition_assembled_together.prm "
+             " ; "
+             " echo 'set Output directory = output2.tmp' "
+             " ; "
+             " echo 'subsection Solver parameters' "
+             " ; "
+             " echo '  subsection Advection solver parameters' "
+             " ; "
+             " echo '    set Assemble compositional fields together = true' "
+             " ; "
+             " echo '  end' "
+             " ; "
+             " echo 'end' "
+             " ; "
+             " rm -rf output2.tmp ; mkdir output2.tmp "
+             ") "
+             "| ../../aspect -- > /dev/null");
+  std::cout << "Executing the following command:\n"
+            << command
+            << std::endl;
+  ret = system (command.c_str());
+  if (ret!=0)
+    {
+      std::cout << "system() returned error " << ret << std::endl;
+      exit(1);
+    }
+
+  std::cout << "* now comparing:" << std::endl;
+  command = ("cd output-composition_assembled_together ; "
+             "diff output1.tmp/statistics output2.tmp/statistics");
+  std::cout << "Executing the following command:\n"
+            << command
+            << std::endl;
+  ret = system (command.c_str());
+  if (ret!=0)
+    {
+      std::cout << "The statistics of the two runs differ." << std::endl;
+      exit(1);
+    }
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
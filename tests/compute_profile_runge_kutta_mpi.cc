@@ -0,0 +1,287 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/postprocess/interface.h>
+#include <aspect/adiabatic_conditions/compute_profile.h>
+#include <aspect/geometry_model/interface.h>
+#include <aspect/simulator_access.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+
+namespace aspect
+{
+  using namespace dealii;
+
+  /**
+   * A postprocessor that computes adiabatic profiles with the 'compute
+   * profile' plugin for the simple material model, for which the profile
+   * is known analytically:
+   *   T(z) = T_0 exp(a z),
+   *   p(z) = p_0 + rho_0 g ((1 + alpha T_ref) z - alpha T_0 (exp(a z) - 1) / a),
+   * with a = alpha g / c_p. It checks that the Runge-Kutta integration is
+   * much more accurate than the explicit Euler integration, that computing
+   * the profile on the root process only gives the same profile on all
+   * processes, and that update() follows a time dependent surface condition
+   * function.
+   */
+  template <int dim>
+  class ComputeProfileCheck : public Postprocess::Interface<dim>, public ::aspect::SimulatorAccess<dim>
+  {
+    public:
+      std::pair<std::string,std::string>
+      execute (TableHandler &statistics) override;
+
+    private:
+      /**
+       * Create a profile plugin with the given parameters that is not yet
+       * initialized.
+       */
+      std::unique_ptr<AdiabaticConditions::ComputeProfile<dim>>
+      create_profile (const unsigned int n_points,
+                      const std::string &integration_method,
+                      const bool compute_on_root_process_only,
+                      const bool use_surface_condition_function) const;
+
+      /**
+       * Return the maximal error of the temperature and pressure of the
+       * given profile relative to the maximal value of the analytical
+       * solution, evaluated at 11 depths that coincide with points of the
+       * profile.
+       */
+      std::pair<double,double>
+      compute_errors (const AdiabaticConditions::ComputeProfile<dim> &profile,
+                      const unsigned int n_points,
+                      const double surface_pressure,
+                      const double surface_temperature) const;
+
+      /**
+       * The profile with a time dependent surface condition function,
+       * which is kept around between time steps to test update().
+       */
+      std::unique_ptr<AdiabaticConditions::ComputeProfile<dim>> time_dependent_profile;
+  };
+
+
+
+  template <int dim>
+  std::unique_ptr<AdiabaticConditions::ComputeProfile<dim>>
+  ComputeProfileCheck<dim>::create_profile (const unsigned int n_points,
+                                            const std::string &integration_method,
+                                            const bool compute_on_root_process_only,
+                                            const bool use_surface_condition_function) const
+  {
+    ParameterHandler prm;
+    AdiabaticConditions::ComputeProfile<dim>::declare_parameters (prm);
+
+    prm.enter_subsection ("Adiabatic conditions model");
+    {
+      prm.enter_subsection ("Compute profile");
+      {
+        prm.set ("Number of points", std::to_string(n_points));
+        prm.set ("Integration method", integration_method);
+        prm.set ("Compute profile on root process only", compute_on_root_process_only ? "true" : "false");
+        prm.set ("Use surface condition function", use_surface_condition_function ? "true" : "false");
+
+        prm.enter_subsection ("Surface condition function");
+        {
+          prm.set ("Function expression", "1e5*t; 1600+100*t");
+        }
+        prm.leave_subsection ();
+      }
+      prm.leave_subsection ();
+    }
+    prm.leave_subsection ();
+
+    auto profile = std::make_unique<AdiabaticConditions::ComputeProfile<dim>>();
+    profile->initialize_simulator (this->get_simulator());
+    profile->parse_parameters (prm);
+    return profile;
+  }
+
+
+
+  template <int dim>
+  std::pair<double,double>
+  ComputeProfileCheck<dim>::compute_errors (const AdiabaticConditions::ComputeProfile<dim> &profile,
+                                            const unsigned int n_points,
+                                            const double surface_pressure,
+                                            const double surface_temperature) const
+  {
+    // These values have to match the input file.
+    const double rho_0 = 3300;
+    const double alpha = 3e-5;
+    const double c_p = 1250;
+    const double reference_temperature = 293;
+    const double g = 10;
+    const double a = alpha * g / c_p;
+
+    const double maximal_depth = this->get_geometry_model().maximal_depth();
+    const double delta_z = maximal_depth / (n_points-1);
+    Assert ((n_points-1) % 10 == 0, ExcInternalError());
+
+    std::vector<double> temperature_errors;
+    std::vector<double> pressure_errors;
+    double max_temperature = 0;
+    double max_pressure = 0;
+    for (unsigned int j=0; j<=10; ++j)
+      {
+        const unsigned int index = j * (n_points-1) / 10;
+        const double z = index * delta_z;
+
+        // Query the profile slightly below the profile point so that
+        // the depth computed from the representative point is not rounded
+        // to the point above, and the profile value is returned without
+        // interpolation.
+        const Point<dim> p = this->get_geometry_model().representative_point (std::min((index + 1e-8) * delta_z,
+                                                                              maximal_depth));
+
+        const double exact_temperature = surface_temperature * std::exp(a * z);
+        const double exact_pressure = surface_pressure
+                                      + rho_0 * g * ((1. + alpha * reference_temperature) * z
+                                                     - alpha * surface_temperature * (std::exp(a * z) - 1.) / a);
+
+        temperature_errors.push_back (std::abs(profile.temperature(p) - exact_temperature));
+        pressure_errors.push_back (std::abs(profile.pressure(p) - exact_pressure));
+        max_temperature = std::max (max_temperature, std::abs(exact_temperature));
+        max_pressure = std::max (max_pressure, std::abs(exact_pressure));
+      }
+
+    return std::make_pair (*std::max_element(temperature_errors.begin(), temperature_errors.end()) / max_temperature,
+                           *std::max_element(pressure_errors.begin(), pressure_errors.end()) / max_pressure);
+  }
+
+
+
+  template <int dim>
+  std::pair<std::string,std::string>
+  ComputeProfileCheck<dim>::execute (TableHandler &)
+  {
+    bool success = true;
+
+    if (this->get_timestep_number() == 0)
+      {
+        // Explicit Euler is first order accurate, so with 1001 points its
+        // error is small, but clearly visible.
+        auto euler = create_profile (1001, "explicit Euler", false, false);
+        euler->initialize ();
+        const std::pair<double,double> euler_errors = compute_errors (*euler, 1001, 0., 1600.);
+
+        // The fourth order Runge-Kutta method is exact up to round-off
+        // with ten times fewer points.
+        auto runge_kutta = create_profile (101, "Runge-Kutta", false, false);
+        runge_kutta->initialize ();
+        const std::pair<double,double> runge_kutta_errors = compute_errors (*runge_kutta, 101, 0., 1600.);
+
+        if (std::max(euler_errors.first, euler_errors.second) > 1e-3
+            ||
+            std::max(euler_errors.first, euler_errors.second) < 1e-6)
+          {
+            this->get_pcout() << "   Error: unexpected relative errors of the explicit Euler profile: "
+                              << euler_errors.first << " (temperature), "
+                              << euler_errors.second << " (pressure)" << std::endl;
+            success = false;
+          }
+        else
+          this->get_pcout() << "   Explicit Euler profile: OK" << std::endl;
+
+        if (std::max(runge_kutta_errors.first, runge_kutta_errors.second) > 1e-8)
+          {
+            this->get_pcout() << "   Error: unexpected relative errors of the Runge-Kutta profile: "
+                              << runge_kutta_errors.first << " (temperature), "
+                              << runge_kutta_errors.second << " (pressure)" << std::endl;
+            success = false;
+          }
+        else
+          this->get_pcout() << "   Runge-Kutta profile: OK" << std::endl;
+
+        // Computing the profile on the root process only and broadcasting
+        // it has to give every process exactly the profile it computes
+        // itself.
+        auto root_only = create_profile (101, "Runge-Kutta", true, false);
+        root_only->initialize ();
+
+        double max_difference = 0;
+        for (unsigned int j=0; j<=100; ++j)
+          {
+            const Point<dim> p = this->get_geometry_model().representative_point
+                                 (j/100. * this->get_geometry_model().maximal_depth());
+            max_difference = std::max ({max_difference,
+                                        std::abs(root_only->temperature(p) - runge_kutta->temperature(p)),
+                                        std::abs(root_only->pressure(p) - runge_kutta->pressure(p)),
+                                        std::abs(root_only->density(p) - runge_kutta->density(p))
+                                       });
+          }
+        max_difference = Utilities::MPI::max (max_difference, this->get_mpi_communicator());
+
+        if (max_difference != 0)
+          {
+            this->get_pcout() << "   Error: the profile computed on the root process differs by "
+                              << max_difference << std::endl;
+            success = false;
+          }
+        else
+          this->get_pcout() << "   Profile computed on root process only: OK" << std::endl;
+
+        time_dependent_profile = create_profile (101, "Runge-Kutta", true, true);
+        time_dependent_profile->initialize ();
+      }
+
+    // The surface conditions change with time, so update() has to
+    // recompute the profile for the new surface conditions. Calling it
+    // a second time must not change the profile.
+    time_dependent_profile->update ();
+    time_dependent_profile->update ();
+
+    const double time = this->get_time();
+    const std::pair<double,double> errors = compute_errors (*time_dependent_profile, 101,
+                                                            1e5*time, 1600.+100.*time);
+    if (!time_dependent_profile->is_initialized()
+        ||
+        std::max(errors.first, errors.second) > 1e-8)
+      {
+        this->get_pcout() << "   Error: the updated profile has relative errors "
+                          << errors.first << " (temperature), "
+                          << errors.second << " (pressure)" << std::endl;
+        success = false;
+      }
+    else
+      this->get_pcout() << "   Time dependent surface conditions: OK" << std::endl;
+
+    AssertThrow (success,
+                 ExcMessage ("The computed adiabatic profile is not accurate enough."));
+
+    return std::make_pair ("Checking adiabatic profiles:", "OK");
+  }
+}
+
+
+
+// explicit instantiations
+namespace aspect
+{
+  ASPECT_REGISTER_POSTPROCESSOR(ComputeProfileCheck,
+                                "compute profile check",
+                                "A postprocessor that compares the adiabatic profiles "
+                                "computed with different integration methods with the "
+                                "analytical solution.")
+}
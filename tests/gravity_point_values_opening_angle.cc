@@ -0,0 +1,184 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/postprocess/interface.h>
+#include <aspect/postprocess/gravity_point_values.h>
+#include <aspect/simulator_access.h>
+
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+namespace aspect
+{
+  using namespace dealii;
+
+  /**
+   * A postprocessor that computes the gravity at a few satellites with the
+   * gravity point values postprocessor, once with the exact sum over all
+   * quadrature points and then with several multipole opening angles, and
+   * checks that the relative error of the approximation is at most of the
+   * order of the opening angle.
+   */
+  template <int dim>
+  class GravityOpeningAngle : public Postprocess::Interface<dim>, public ::aspect::SimulatorAccess<dim>
+  {
+    public:
+      std::pair<std::string,std::string>
+      execute (TableHandler &statistics) override;
+
+    private:
+      /**
+       * Run the gravity point values postprocessor with the given opening
+       * angle and return the gravity norm, potential and anomaly norm
+       * at each satellite.
+       */
+      std::vector<std::array<double,3>>
+      compute_gravity (const double opening_angle) const;
+  };
+
+
+
+  template <int dim>
+  std::vector<std::array<double,3>>
+  GravityOpeningAngle<dim>::compute_gravity (const double opening_angle) const
+  {
+    ParameterHandler prm;
+    prm.declare_entry ("End time", "0.", Patterns::Double ());
+    Postprocess::GravityPointValues<dim>::declare_parameters (prm);
+
+    prm.enter_subsection ("Postprocess");
+    {
+      prm.enter_subsection ("Gravity calculation");
+      {
+        prm.set ("Sampling scheme", "list of points");
+        prm.set ("List of radius", "4, 10, 20, 20");
+        prm.set ("List of longitude", "0, 45, 100, -120");
+        prm.set ("List of latitude", "0, 30, -35, 60");
+        prm.set ("Reference density", "5e5");
+        prm.set ("Multipole opening angle", std::to_string(opening_angle));
+      }
+      prm.leave_subsection ();
+    }
+    prm.leave_subsection ();
+
+    Postprocess::GravityPointValues<dim> gravity;
+    gravity.initialize_simulator (this->get_simulator());
+    gravity.parse_parameters (prm);
+    gravity.initialize ();
+
+    TableHandler statistics;
+    gravity.execute (statistics);
+
+    // Read the gravity norm (column 10), potential (column 12) and
+    // anomaly norm (column 17) back from the output file.
+    std::vector<std::array<double,3>> values;
+    std::ifstream input (this->get_output_directory() + "output_gravity/gravity-00000");
+    std::string line;
+    while (std::getline (input, line))
+      {
+        if (line.empty() || line[0] == '#')
+          continue;
+
+        std::istringstream columns (line);
+        std::vector<double> column_values;
+        double value;
+        while (columns >> value)
+          column_values.push_back (value);
+
+        AssertThrow (column_values.size() == 29,
+                     ExcMessage ("Unexpected format of the gravity output."));
+        values.push_back ({{column_values[9], column_values[11], column_values[16]}});
+      }
+
+    return values;
+  }
+
+
+
+  template <int dim>
+  std::pair<std::string,std::string>
+  GravityOpeningAngle<dim>::execute (TableHandler &)
+  {
+    const std::vector<std::array<double,3>> exact = compute_gravity (0.);
+    AssertThrow (exact.size() == 4,
+                 ExcMessage ("Expected the gravity at four satellites."));
+
+    const std::vector<double> opening_angles = {0.1, 0.2, 0.4};
+    const std::vector<std::string> names = {"gravity", "potential", "anomaly"};
+
+    bool success = true;
+    for (const double opening_angle : opening_angles)
+      {
+        const std::vector<std::array<double,3>> approximate = compute_gravity (opening_angle);
+        AssertThrow (approximate.size() == exact.size(),
+                     ExcMessage ("Expected the gravity at four satellites."));
+
+        std::cout << "Opening angle " << opening_angle << ':' << std::endl;
+
+        // The satellites at radius 20 are far enough from all cells that the
+        // approximation is used for each opening angle, so the error there
+        // has to be nonzero.
+        double max_far_field_error = 0;
+        for (unsigned int p=0; p<exact.size(); ++p)
+          for (unsigned int c=0; c<3; ++c)
+            {
+              const double relative_error = std::abs(approximate[p][c] - exact[p][c]) / std::abs(exact[p][c]);
+              if (p >= 2)
+                max_far_field_error = std::max (max_far_field_error, relative_error);
+
+              if (relative_error > opening_angle)
+                {
+                  std::cout << "   Error: relative error " << relative_error
+                            << " of the " << names[c] << " at satellite " << p
+                            << " is larger than the opening angle." << std::endl;
+                  success = false;
+                }
+            }
+
+        if (max_far_field_error == 0)
+          {
+            std::cout << "   Error: the far field approximation was not used." << std::endl;
+            success = false;
+          }
+        else
+          std::cout << "   OK" << std::endl;
+      }
+
+    AssertThrow (success,
+                 ExcMessage ("The multipole approximation of the gravity is not accurate enough."));
+
+    return std::make_pair ("Checking multipole opening angles:", "OK");
+  }
+}
+
+
+
+// explicit instantiations
+namespace aspect
+{
+  ASPECT_REGISTER_POSTPROCESSOR(GravityOpeningAngle,
+                                "gravity opening angle",
+                                "A postprocessor that compares the gravity computed "
+                                "with a multipole opening angle with the exact result.")
+}
@@ -0,0 +1,109 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/mesh_refinement/interface.h>
+#include <aspect/simulator_access.h>
+
+#include <deal.II/numerics/error_estimator.h>
+
+
+namespace aspect
+{
+  using namespace dealii;
+
+  /**
+   * A Kelly-type mesh refinement criterion for the temperature that
+   * compares the indicators computed by MeshRefinement::compute_kelly_indicators()
+   * with the ones computed by deal.II's KellyErrorEstimator, and throws an
+   * exception if they differ.
+   */
+  template <int dim>
+  class KellyComparison : public MeshRefinement::KellyInterface<dim>
+  {
+    public:
+      std::vector<ComponentMask>
+      get_component_masks () const override
+      {
+        return {this->introspection().component_masks.temperature};
+      }
+
+      const Quadrature<dim-1> &
+      get_face_quadrature () const override
+      {
+        return this->introspection().face_quadratures.temperature;
+      }
+
+      void
+      combine_indicators (const std::vector<Vector<float>> &indicators_per_mask,
+                          Vector<float> &error_indicators) const override
+      {
+        Vector<float> reference_indicators (error_indicators.size());
+        KellyErrorEstimator<dim>::estimate (this->get_mapping(),
+                                            this->get_dof_handler(),
+                                            this->introspection().face_quadratures.temperature,
+                                            std::map<types::boundary_id,const Function<dim>*>(),
+                                            this->get_solution(),
+                                            reference_indicators,
+                                            this->introspection().component_masks.temperature,
+                                            nullptr,
+                                            0,
+                                            this->get_triangulation().locally_owned_subdomain());
+
+        double max_difference = 0;
+        double max_indicator = 0;
+        for (const auto &cell : this->get_dof_handler().active_cell_iterators())
+          if (cell->is_locally_owned())
+            {
+              const unsigned int index = cell->active_cell_index();
+              max_difference = std::max (max_difference,
+                                         static_cast<double>(std::abs(indicators_per_mask[0](index) - reference_indicators(index))));
+              max_indicator = std::max (max_indicator,
+                                        static_cast<double>(reference_indicators(index)));
+            }
+        max_difference = Utilities::MPI::max (max_difference, this->get_mpi_communicator());
+        max_indicator = Utilities::MPI::max (max_indicator, this->get_mpi_communicator());
+
+        this->get_pcout() << "   Kelly indicators: maximal relative difference to KellyErrorEstimator is "
+                          << (max_difference <= 1e-5 * max_indicator ? "below 1e-5" : "too large")
+                          << std::endl;
+
+        AssertThrow (max_indicator > 0,
+                     ExcMessage ("The test needs a temperature field with nonzero indicators."));
+        AssertThrow (max_difference <= 1e-5 * max_indicator,
+                     ExcMessage ("The Kelly indicators differ from the ones computed by "
+                                 "deal.II's KellyErrorEstimator by " +
+                                 Utilities::to_string(max_difference / max_indicator) +
+                                 " relative to the largest indicator."));
+
+        error_indicators = indicators_per_mask[0];
+      }
+  };
+}
+
+
+
+// explicit instantiations
+namespace aspect
+{
+  ASPECT_REGISTER_MESH_REFINEMENT_CRITERION(KellyComparison,
+                                            "kelly comparison",
+                                            "A temperature based Kelly criterion that checks "
+                                            "its indicators against deal.II's KellyErrorEstimator.")
+}
@@ -0,0 +1,12 @@
+#!/usr/bin/env perl
+
+$filename=$ARGV[0];
+while(<STDIN>)
+{
+    if ($filename eq "screen-output")
+    {
+	s/Number of active cells: .*/Number of active cells: XYZ/;
+	s/Number of degrees of freedom: .*/Number of degrees of freedom: XYZ/;
+    }
+    print $_;
+}
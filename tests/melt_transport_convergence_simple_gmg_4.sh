@@ -0,0 +1,42 @@
+#!/usr/bin/env perl
+
+# The number of Stokes iterations has to stay below a bound that is the
+# same for melt_transport_convergence_simple_gmg_4 and
+# melt_transport_convergence_simple_gmg_5, i.e., that does not depend on
+# the mesh size. Nonlinear residuals below 1e-8 only depend on the linear
+# solver tolerance, so they are not compared. The errors have to be below
+# 16 times the errors of melt_transport_convergence_simple, which uses one
+# more global refinement, because no error converges with an order larger than
+# four.
+
+$filename=$ARGV[0];
+@error_bounds = (1.643e-03, 2.719e-01, 2.736e-01, 5.852e-05, 1.391e-03, 3.844e-02, 6.956e-02);
+while(<STDIN>)
+{
+    if ($filename eq "screen-output")
+    {
+	if (/   Solving Stokes system... 0\+(\d+) iterations./ && $1 <= 60)
+	{
+	    s/   Solving Stokes system... 0\+(\d+) iterations./   Solving Stokes system... 0+at most 60 iterations./;
+	}
+	if (/   Solving fluid velocity system... (\d+) iterations./ && $1 <= 20)
+	{
+	    s/   Solving fluid velocity system... (\d+) iterations./   Solving fluid velocity system... at most 20 iterations./;
+	}
+	if (/Relative nonlinear residual/)
+	{
+	    s/\d\.?\d*e-(\d+)/($1 >= 8 ? "below 1e-8" : $&)/ge;
+	}
+	if (/Errors u_L2, [^:]*:\s+(.*)$/)
+	{
+	    @errors = split(/, /, $1);
+	    $below_bounds = (scalar(@errors) == scalar(@error_bounds));
+	    for $i (0 .. $#errors)
+	    {
+		$below_bounds = 0 if ($errors[$i] > $error_bounds[$i]);
+	    }
+	    s/(:\s+).*$/$1below bounds/ if ($below_bounds);
+	}
+    }
+    print $_;
+}
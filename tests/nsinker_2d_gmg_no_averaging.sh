@@ -0,0 +1,17 @@
+#!/usr/bin/env perl
+
+# Only check that the number of iterations stays below a bound, so that
+# small changes of the preconditioner do not require new reference output.
+
+$filename=$ARGV[0];
+while(<STDIN>)
+{
+    if ($filename eq "screen-output")
+    {
+	if (/   Solving Stokes system... (\d+)\+0 iterations./ && $1 <= 200)
+	{
+	    s/   Solving Stokes system... (\d+)\+0 iterations./   Solving Stokes system... at most 200+0 iterations./;
+	}
+    }
+    print $_;
+}
@@ -0,0 +1,92 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/simulator.h>
+#include <iostream>
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * twice, once with one thread and once with multiple threads, compare the
+ * statistics of both runs, and then terminate the outer ASPECT run.
+ */
+int f()
+{
+  int ret;
+  std::string command;
+
+  std::cout << "* running with one thread:" << std::endl;
+  command = ("cd output-operator_splitting_threads ; "
+             "(cat " ASPECT_SOURCE_DIR "/tests/operator_splitting_threads.prm "
+             " ; "
+             " echo 'set Output directory = output1.tmp' "
+             " ; "
+             " rm -rf output1.tmp ; mkdir output1.tmp "
+             ") "
+             "| ../../aspect -- > /dev/null");
+  std::cout << "Executing the following command:\n"
+            << command
+            << std::endl;
+  ret = system (command.c_str());
+  if (ret!=0)
+    {
+      std::cout << "system() returned error " << ret << std::endl;
+      exit(1);
+    }
+
+  std::cout << "* running with multiple threads:" << std::endl;
+  command = ("cd output-operator_splitting_threads ; "
+             "(cat " ASPECT_SOURCE_DIR "/tests/operator_splitting_threads.prm "
+             " ; "
+             " echo 'set Output directory = output2.tmp' "
+             " ; "
+             " rm -rf output2.tmp ; mkdir output2.tmp "
+             ") "
+             "| DEAL_II_NUM_THREADS=4 ../../aspect -j -- > /dev/null");
+  std::cout << "Executing the following command:\n"
+            << command
+            << std::endl;
+  ret = system (command.c_str());
+  if (ret!=0)
+    {
+      std::cout << "system() returned error " << ret << std::endl;
+      exit(1);
+    }
+
+  std::cout << "* now comparing:" << std::endl;
+  command = ("cd output-operator_splitting_threads ; "
+             "diff output1.tmp/statistics output2.tmp/statistics");
+  std::cout << "Executing the following command:\n"
+            << command
+            << std::endl;
+  ret = system (command.c_str());
+  if (ret!=0)
+    {
+      std::cout << "The statistics of the two runs differ." << std::endl;
+      exit(1);
+    }
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
@@ -0,0 +1,23 @@
+#!/usr/bin/env perl
+
+# The GMG and AMG preconditioners need different numbers of iterations,
+# and the solutions only agree up to the solver tolerance. Remove the
+# iteration counts and nonlinear residuals, and round the errors to four
+# digits, so that the output can be compared with the one of
+# sol_cx_2_conservative.
+
+$filename=$ARGV[0];
+while(<STDIN>)
+{
+    if ($filename eq "screen-output")
+    {
+	s/   Solving Stokes system... (\d+)\+(\d+) iterations./   Solving Stokes system... XYZ iterations./;
+	s/(Relative nonlinear residual \(Stokes system\) after nonlinear iteration \d+): .*/$1: XYZ/;
+	if (/Errors u_L1, p_L1, u_L2, p_L2: (.*)/)
+	{
+	    my @errors = map { sprintf("%.3e", $_) } split(/, /, $1);
+	    s/(Errors u_L1, p_L1, u_L2, p_L2: ).*/$1 . join(", ", @errors)/e;
+	}
+    }
+    print $_;
+}
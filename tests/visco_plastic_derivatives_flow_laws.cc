@@ -0,0 +1,266 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/simulator.h>
+#include <aspect/simulator_access.h>
+
+#include <aspect/material_model/interface.h>
+#include <aspect/material_model/visco_plastic.h>
+#include <aspect/newton.h>
+#include <aspect/parameters.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+
+/*
+ * Compare the analytic derivatives of the visco plastic viscosity with
+ * respect to the pressure and the strain rate with finite differences for
+ * one choice of rheology parameters. Returns whether all derivatives agree.
+ * Only the derivatives that disagree are printed, so that the output does
+ * not depend on round-off in the finite difference approximation.
+ */
+template <int dim>
+bool test_derivatives(const aspect::SimulatorAccess<dim> &simulator_access,
+                      const std::string &description,
+                      const std::map<std::string, std::string> &parameters)
+{
+  using namespace aspect::MaterialModel;
+
+  std::cout << std::endl << "Testing ViscoPlastic derivatives for " << description << std::endl;
+
+  const unsigned int n_points = 5;
+  MaterialModelInputs<dim> in_base(n_points,3);
+  in_base.composition[0] = {0, 0, 0};
+  in_base.composition[1] = {0.75, 0.15, 0.10};
+  in_base.composition[2] = {0, 0.2, 0.4};
+  in_base.composition[3] = {0, 0.2, 0.4};
+  in_base.composition[4] = {1, 0, 0};
+
+  in_base.temperature[0] = 293;
+  in_base.temperature[1] = 1600;
+  in_base.temperature[2] = 2000;
+  in_base.temperature[3] = 1200;
+  in_base.temperature[4] = 900;
+
+  in_base.pressure[0] = 1e9;
+  in_base.pressure[1] = 5e9;
+  in_base.pressure[2] = 2e10;
+  in_base.pressure[3] = 2e9;
+  in_base.pressure[4] = 5e8;
+
+  for (unsigned int i=0; i<n_points; ++i)
+    in_base.position[i] = Point<dim>();
+
+  // The strain rates can not be too small, because then the difference in
+  // the viscosity would be too small for the accuracy of the finite
+  // difference approximation.
+  in_base.strain_rate[0] = SymmetricTensor<2,dim>();
+  in_base.strain_rate[0][0][0] = 1e-12;
+  in_base.strain_rate[0][0][1] = 1e-12;
+  in_base.strain_rate[0][1][1] = 1e-11;
+
+  in_base.strain_rate[1] = SymmetricTensor<2,dim>(in_base.strain_rate[0]);
+  in_base.strain_rate[1][0][0] = -1.71266e-13;
+  in_base.strain_rate[1][0][1] = -5.82647e-12;
+  in_base.strain_rate[1][1][1] = 4.21668e-14;
+
+  in_base.strain_rate[2] = SymmetricTensor<2,dim>(in_base.strain_rate[0]);
+  in_base.strain_rate[2][1][1] = 1e-13;
+  in_base.strain_rate[2][0][1] = 1e-11;
+  in_base.strain_rate[2][0][0] = -1e-12;
+
+  in_base.strain_rate[3] = SymmetricTensor<2,dim>(in_base.strain_rate[0]);
+  in_base.strain_rate[3][1][1] = 2e-14;
+  in_base.strain_rate[3][0][1] = 3e-14;
+  in_base.strain_rate[3][0][0] = -1e-14;
+
+  in_base.strain_rate[4] = SymmetricTensor<2,dim>(in_base.strain_rate[0]);
+  in_base.strain_rate[4][1][1] = 1e-11;
+  in_base.strain_rate[4][0][1] = 1e-11;
+  in_base.strain_rate[4][0][0] = -1e-11;
+
+  const double finite_difference_accuracy = 1e-7;
+  const double finite_difference_factor = 1+finite_difference_accuracy;
+
+  // Re-initialize the material model with the parameters of this case.
+  const ViscoPlastic<dim> &const_material_model = dynamic_cast<const ViscoPlastic<dim> &>(simulator_access.get_material_model());
+  ViscoPlastic<dim> &material_model = const_cast<ViscoPlastic<dim> &>(const_material_model);
+
+  aspect::ParameterHandler prm;
+  material_model.declare_parameters(prm);
+
+  prm.enter_subsection("Material model");
+  {
+    prm.enter_subsection ("Visco Plastic");
+    {
+      // Make sure that the viscosities are not limited, which would make
+      // the derivatives zero.
+      prm.set ("Minimum viscosity", "1e10");
+      prm.set ("Maximum viscosity", "1e40");
+      for (const auto &parameter : parameters)
+        prm.set (parameter.first, parameter.second);
+    }
+    prm.leave_subsection();
+  }
+  prm.leave_subsection();
+
+  material_model.parse_parameters(prm);
+
+  MaterialModelOutputs<dim> out_base(n_points,3);
+  out_base.additional_outputs.push_back(std::make_unique<MaterialModelDerivatives<dim>> (n_points));
+  material_model.evaluate(in_base, out_base);
+
+  const MaterialModelDerivatives<dim> *derivatives
+    = out_base.template get_additional_output<MaterialModelDerivatives<dim>>();
+
+  bool error = false;
+
+  // test the pressure derivative.
+  MaterialModelInputs<dim> in_dviscositydpressure(in_base);
+  for (unsigned int i=0; i<n_points; ++i)
+    in_dviscositydpressure.pressure[i] *= finite_difference_factor;
+
+  MaterialModelOutputs<dim> out_dviscositydpressure(n_points,3);
+  material_model.evaluate(in_dviscositydpressure, out_dviscositydpressure);
+
+  for (unsigned int i=0; i<n_points; ++i)
+    {
+      const double finite_difference = (out_dviscositydpressure.viscosities[i] - out_base.viscosities[i])
+                                       / (in_base.pressure[i] * finite_difference_accuracy);
+      const double analytic = derivatives->viscosity_derivative_wrt_pressure[i];
+
+      if (std::fabs(finite_difference - analytic) > 1e-3 * (std::fabs(finite_difference) + std::fabs(analytic)))
+        {
+          std::cout << "pressure: point = " << i << ", Finite difference = " << finite_difference
+                    << ", Analytical derivative = " << analytic << std::endl;
+          std::cout << "   Error: The derivative of the viscosity to the pressure is too different from the analytical value." << std::endl;
+          error = true;
+        }
+    }
+
+  // test the strain-rate derivative.
+  MaterialModelInputs<dim> in_dviscositydstrainrate(in_base);
+  MaterialModelOutputs<dim> out_dviscositydstrainrate(n_points,3);
+  for (unsigned int component = 0; component < SymmetricTensor<2,dim>::n_independent_components; ++component)
+    {
+      const TableIndices<2> strain_rate_indices = SymmetricTensor<2,dim>::unrolled_to_component_indices (component);
+
+      // Components that are not on the diagonal are multiplied by 0.5, because the symmetric tensor
+      // is modified by 0.5 in both symmetric directions (xy/yx) simultaneously and we compute the combined
+      // derivative.
+      for (unsigned int i=0; i<n_points; ++i)
+        in_dviscositydstrainrate.strain_rate[i] = in_base.strain_rate[i]
+                                                  + std::fabs(in_base.strain_rate[i][strain_rate_indices])
+                                                  * (component > dim-1 ? 0.5 : 1 )
+                                                  * finite_difference_accuracy
+                                                  * aspect::Utilities::nth_basis_for_symmetric_tensors<dim>(component);
+
+      material_model.evaluate(in_dviscositydstrainrate, out_dviscositydstrainrate);
+
+      for (unsigned int i=0; i<n_points; ++i)
+        {
+          double finite_difference = out_dviscositydstrainrate.viscosities[i] - out_base.viscosities[i];
+          if (finite_difference != 0)
+            finite_difference /= std::fabs(in_dviscositydstrainrate.strain_rate[i][strain_rate_indices]) * finite_difference_accuracy;
+          const double analytic = derivatives->viscosity_derivative_wrt_strain_rate[i][strain_rate_indices];
+
+          if (std::fabs(finite_difference - analytic) > 1e-3 * (std::fabs(finite_difference) + std::fabs(analytic)))
+            {
+              std::cout << "strain-rate: point = " << i << ", component = " << component
+                        << ", Finite difference = " << finite_difference
+                        << ", Analytical derivative = " << analytic << std::endl;
+              std::cout << "   Error: The derivative of the viscosity to the strain rate is too different from the analytical value." << std::endl;
+              error = true;
+            }
+        }
+    }
+
+  if (error)
+    std::cout << "Some parts of the test were not successful." << std::endl;
+  else
+    std::cout << "OK" << std::endl;
+
+  return !error;
+}
+
+
+
+template <int dim>
+void f(const aspect::SimulatorAccess<dim> &simulator_access,
+       aspect::Assemblers::Manager<dim> &)
+{
+  const std::map<std::string, std::string> drucker_prager = {{"Angles of internal friction", "30"},
+    {"Cohesions", "1e6"}
+  };
+
+  std::vector<std::pair<std::string, std::map<std::string, std::string>>> cases =
+  {
+    {"diffusion creep", {{"Viscous flow law", "diffusion"}}},
+    {"dislocation creep", {{"Viscous flow law", "dislocation"}}},
+    {"composite creep", {{"Viscous flow law", "composite"}}},
+    {
+      "composite and exact Peierls creep", {{"Viscous flow law", "composite"},
+        {"Include Peierls creep", "true"},
+        {"Peierls creep flow law", "exact"}
+      }
+    },
+    {
+      "composite and exact Peierls creep with a strict stress cutoff", {{"Viscous flow law", "composite"},
+        {"Include Peierls creep", "true"},
+        {"Peierls creep flow law", "exact"},
+        {"Apply strict stress cutoff for Peierls creep", "true"},
+        {"Cutoff stresses for Peierls creep", "1e9"}
+      }
+    },
+    {
+      "composite and approximate Peierls creep", {{"Viscous flow law", "composite"},
+        {"Include Peierls creep", "true"},
+        {"Peierls creep flow law", "viscosity approximation"}
+      }
+    },
+    {"composite creep and Drucker-Prager plasticity", drucker_prager},
+    {"composite creep and damped Drucker-Prager plasticity", drucker_prager}
+  };
+  cases.back().second["Use plastic damper"] = "true";
+  cases.back().second["Plastic damper viscosity"] = "1e20";
+
+  bool success = true;
+  for (const auto &test_case : cases)
+    success = test_derivatives(simulator_access, test_case.first, test_case.second) && success;
+
+  AssertThrow (success,
+               dealii::ExcMessage("The analytic viscosity derivatives differ from the finite difference approximation."));
+}
+
+
+
+template <int dim>
+void signal_connector (aspect::SimulatorSignals<dim> &signals)
+{
+  std::cout << "* Connecting signals" << std::endl;
+  signals.set_assemblers.connect (&f<dim>);
+}
+
+ASPECT_REGISTER_SIGNALS_CONNECTOR(signal_connector<2>,
+                                  signal_connector<3>)
@@ -20,6 +20,21 @@
 
 #include "common.h"
 #include <aspect/utilities.h>
+#include <aspect/structured_data.h>
+#include <aspect/material_model/utilities.h>
+
+#include <deal.II/base/function_parser.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 
 TEST_CASE("Utilities::weighted_p_norm_average")
 {
@@ -152,6 +167,158 @@ TEST_CASE("Utilities::AsciiDataLookup manual dim=2 equid")
   REQUIRE(lookup.get_data(Point<2>(1.5,6.0),0) == Approx(5.5));
 }
 
+TEST_CASE("Utilities::AsciiDataLookup manual dim=2 batched")
+{
+  using namespace dealii;
+
+  aspect::Utilities::StructuredDataLookup<2> lookup(2 /*n_components*/, 1.0 /*scaling*/);
+
+  std::vector<std::string> column_names = {"a", "b"};
+  std::vector<Table<2,double>> raw_data(2, Table<2,double>(3,2));
+  std::vector<std::vector<double>> coordinate_values(2);
+
+  // x:
+  coordinate_values[0] = {0., 1., 3.};
+  // y:
+  coordinate_values[1] = {5., 6.};
+  for (unsigned int i=0; i<3; ++i)
+    for (unsigned int j=0; j<2; ++j)
+      {
+        raw_data[0](i,j) = i + 3.*j;
+        raw_data[1](i,j) = 10. - i*j;
+      }
+
+  lookup.reinit(column_names, std::move(coordinate_values), std::move(raw_data),
+                MPI_COMM_SELF, numbers::invalid_unsigned_int);
+
+  // Include points outside of the data grid, where the data is
+  // extended constantly.
+  const std::vector<Point<2>> positions = {Point<2>(0.5,5.5), Point<2>(2.0,6.0),
+                                           Point<2>(-1.0,4.0), Point<2>(4.0,7.0)
+                                          };
+  const std::vector<unsigned int> components = {1, 0};
+  std::vector<std::vector<double>> values;
+  lookup.get_data(positions, components, values);
+
+  REQUIRE(values.size() == positions.size());
+  for (unsigned int q=0; q<positions.size(); ++q)
+    {
+      REQUIRE(values[q].size() == components.size());
+      for (unsigned int c=0; c<components.size(); ++c)
+        REQUIRE(values[q][c] == Approx(lookup.get_data(positions[q],components[c])));
+    }
+
+  REQUIRE(values[0][1] == Approx(2.0));
+  REQUIRE(values[1][1] == Approx(4.5));
+  REQUIRE(values[2][0] == Approx(10.0));
+  REQUIRE(values[3][0] == Approx(8.0));
+}
+
+TEST_CASE("Utilities::AsciiDataLookup binary file")
+{
+  using namespace dealii;
+
+  // Write a binary data file with two components on a 3x2 grid.
+  const std::string filename = "structured_data_test.bin";
+  {
+    std::ofstream out(filename, std::ios::binary);
+    const std::uint32_t header[] = {1, 2, 2, 3, 2};
+    out.write("ASPECTSD", 8);
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    for (const std::string name : {"a", "bb"})
+      {
+        const std::uint32_t length = name.size();
+        out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        out.write(name.data(), length);
+      }
+    // pad the 39 byte header to 40 bytes
+    out.put('\0');
+
+    const double coordinates[] = {0., 1., 3., 5., 6.};
+    out.write(reinterpret_cast<const char *>(coordinates), sizeof(coordinates));
+
+    // first coordinate ascending first, one component after the other
+    const double values[] = {0., 1., 2., 3., 4., 5.,
+                             10., 10., 10., 10., 9., 8.
+                            };
+    out.write(reinterpret_cast<const char *>(values), sizeof(values));
+  }
+
+  aspect::Utilities::StructuredDataLookup<2> lookup(2.0 /*scaling*/);
+  lookup.load_file(filename, MPI_COMM_WORLD);
+
+  REQUIRE(lookup.get_column_names() == std::vector<std::string>({"a", "bb"}));
+  REQUIRE(lookup.get_interpolation_point_coordinates(0) == std::vector<double>({0., 1., 3.}));
+  REQUIRE(lookup.get_interpolation_point_coordinates(1) == std::vector<double>({5., 6.}));
+
+  REQUIRE(lookup.get_data(Point<2>(1.0,5.0),0) == Approx(2.0));
+  REQUIRE(lookup.get_data(Point<2>(3.0,6.0),0) == Approx(10.0));
+  REQUIRE(lookup.get_data(Point<2>(2.0,6.0),1) == Approx(17.0));
+  REQUIRE(lookup.get_data(Point<2>(0.5,5.5),0) == Approx(4.0));
+
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("MaterialLookup::evaluate")
+{
+  using namespace aspect::MaterialModel::MaterialUtilities::Lookup;
+
+  const std::string data_filename = aspect::Utilities::expand_ASPECT_SOURCE_DIR("$ASPECT_SOURCE_DIR/data/material-model/steinberger/pyr_MS95_with_volume_fractions_lo_res.dat");
+
+  // Points inside the table, including one that lies exactly on a data point.
+  const std::vector<double> temperatures = {500., 1234.5, 1600., 2950.7, 3500.};
+  const std::vector<double> pressures = {2e9, 1.37e10, 3e9, 5.55e10, 1.1e11};
+
+  for (const bool interpolation : {false, true})
+    {
+      INFO("interpolation=" << interpolation);
+      const PerplexReader lookup(data_filename, interpolation, MPI_COMM_WORLD);
+
+      const LookupProperties::Property all_properties = LookupProperties::density
+                                                        | LookupProperties::thermal_expansivity
+                                                        | LookupProperties::specific_heat
+                                                        | LookupProperties::seismic_Vp
+                                                        | LookupProperties::seismic_Vs
+                                                        | LookupProperties::enthalpy
+                                                        | LookupProperties::dRhodp
+                                                        | LookupProperties::dHdT
+                                                        | LookupProperties::dHdp;
+
+      LookupOutputs outputs(temperatures.size());
+      lookup.evaluate(temperatures, pressures, all_properties, outputs);
+
+      // The fused lookup has to give exactly the same results as the
+      // separate lookups of every property.
+      for (unsigned int i=0; i<temperatures.size(); ++i)
+        {
+          INFO("check i=" << i << ": ");
+          const double T = temperatures[i];
+          const double p = pressures[i];
+          REQUIRE(outputs.densities[i] == lookup.density(T,p));
+          REQUIRE(outputs.thermal_expansivities[i] == lookup.thermal_expansivity(T,p));
+          REQUIRE(outputs.specific_heats[i] == lookup.specific_heat(T,p));
+          REQUIRE(outputs.seismic_Vp[i] == lookup.seismic_Vp(T,p));
+          REQUIRE(outputs.seismic_Vs[i] == lookup.seismic_Vs(T,p));
+          REQUIRE(outputs.enthalpies[i] == lookup.enthalpy(T,p));
+          REQUIRE(outputs.dRhodp[i] == lookup.dRhodp(T,p));
+          REQUIRE(outputs.dHdT[i] == lookup.dHdT(T,p));
+          REQUIRE(outputs.dHdp[i] == lookup.dHdp(T,p));
+        }
+
+      // Requesting only some of the properties gives the same values
+      // for these, and leaves the other outputs untouched.
+      LookupOutputs partial_outputs;
+      lookup.evaluate(temperatures, pressures,
+                      LookupProperties::dRhodp | LookupProperties::seismic_Vs,
+                      partial_outputs);
+
+      REQUIRE(partial_outputs.dRhodp == outputs.dRhodp);
+      REQUIRE(partial_outputs.seismic_Vs == outputs.seismic_Vs);
+      REQUIRE(partial_outputs.densities.empty());
+      REQUIRE(partial_outputs.dHdT.empty());
+    }
+}
+
 TEST_CASE("Random draw volume weighted average rotation matrix")
 {
   std::vector<double> unsorted_volume_fractions = {2.,5.,1.,3.,6.,4.};
@@ -626,3 +793,88 @@ TEST_CASE("Utilities::string_to_unsigned_int")
   CHECK(aspect::Utilities::string_to_unsigned_int(std::vector<std::string>({}))
         == std::vector<unsigned int>());
 }
+
+TEST_CASE("Utilities::real_spherical_harmonics")
+{
+  // Compare the recursive evaluation of all spherical harmonics
+  // to the evaluation of each degree and order separately.
+  const unsigned int max_degree = 40;
+  const std::vector<std::pair<double,double>> points = {{0.3, 0.1}, {1.2, 2.5}, {dealii::numbers::PI/2., 4.0}, {2.9, 6.0}};
+
+  std::vector<double> cos_components;
+  std::vector<double> sin_components;
+  for (const auto &point : points)
+    {
+      aspect::Utilities::real_spherical_harmonics(max_degree, point.first, point.second,
+                                                  cos_components, sin_components);
+      REQUIRE(cos_components.size() == (max_degree+1)*(max_degree+2)/2);
+
+      for (unsigned int l=0; l<=max_degree; ++l)
+        for (unsigned int m=0; m<=l; ++m)
+          {
+            INFO("l=" << l << " m=" << m);
+            const std::pair<double,double> expected = aspect::Utilities::real_spherical_harmonic(l, m, point.first, point.second);
+            REQUIRE(cos_components[l*(l+1)/2+m] == Approx(expected.first).margin(1e-12));
+            REQUIRE(sin_components[l*(l+1)/2+m] == Approx(expected.second).margin(1e-12));
+          }
+    }
+}
+
+TEST_CASE("Utilities::PointValueEvaluator")
+{
+  using namespace dealii;
+
+  Triangulation<2> triangulation;
+  GridGenerator::hyper_cube(triangulation, 0., 1.);
+  triangulation.refine_global(2);
+  triangulation.begin_active()->set_refine_flag();
+  triangulation.execute_coarsening_and_refinement();
+
+  const FESystem<2> fe(FE_Q<2>(2), 2);
+  DoFHandler<2> dof_handler(triangulation);
+  dof_handler.distribute_dofs(fe);
+
+  // Both functions can be represented exactly by the finite element.
+  FunctionParser<2> function(2);
+  function.initialize("x,y", "1+x+2*y; x*y", std::map<std::string,double>());
+
+  aspect::LinearAlgebra::BlockVector solution(std::vector<IndexSet>(1, dof_handler.locally_owned_dofs()), MPI_COMM_WORLD);
+  VectorTools::interpolate(MappingQ1<2>(), dof_handler, function, solution);
+
+  // Points in the interior of cells, on a cell face, on a vertex shared by
+  // four cells, on a hanging node, and on the boundary.
+  const std::vector<Point<2>> points = {Point<2>(0.1, 0.7), Point<2>(0.5, 0.3),
+                                        Point<2>(0.5, 0.5), Point<2>(0.125, 0.25),
+                                        Point<2>(1.0, 0.8)
+                                       };
+
+  aspect::Utilities::PointValueEvaluator<2> evaluator;
+  REQUIRE(evaluator.is_initialized() == false);
+
+  evaluator.reinit(points, MappingQ1<2>(), dof_handler, MPI_COMM_WORLD);
+  REQUIRE(evaluator.is_initialized() == true);
+
+  std::vector<Vector<double>> values;
+  evaluator.evaluate(solution, values);
+
+  REQUIRE(values.size() == points.size());
+  for (unsigned int p=0; p<points.size(); ++p)
+    {
+      INFO("check p=" << p << ": ");
+      REQUIRE(values[p].size() == 2);
+      REQUIRE(values[p][0] == Approx(function.value(points[p], 0)));
+      REQUIRE(values[p][1] == Approx(function.value(points[p], 1)).margin(1e-12));
+    }
+
+  evaluator.clear();
+  REQUIRE(evaluator.is_initialized() == false);
+
+  // The points can be located again, and points outside of the domain
+  // are reported.
+  evaluator.reinit(std::vector<Point<2>>(1, Point<2>(0.9, 0.9)), MappingQ1<2>(), dof_handler, MPI_COMM_WORLD);
+  evaluator.evaluate(solution, values);
+  REQUIRE(values.size() == 1);
+  REQUIRE(values[0][1] == Approx(0.81));
+
+  REQUIRE_THROWS(evaluator.reinit(std::vector<Point<2>>(1, Point<2>(1.5, 0.5)), MappingQ1<2>(), dof_handler, MPI_COMM_WORLD));
+}